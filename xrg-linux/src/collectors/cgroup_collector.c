@@ -0,0 +1,436 @@
+#include "cgroup_collector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#define MAX_CGROUPS         1024    /* Cgroups tracked at most */
+#define MAX_CGROUP_DEPTH    6       /* Enough for kubepods/<qos>/<pod>/<container> */
+#define MAX_CACHED_FDS      512     /* Beyond this, files are opened per read */
+#define RESCAN_INTERVAL     10      /* Updates between walks of the hierarchy */
+#define CGROUP_READ_SIZE    8192
+
+static const gchar *cgroup_file_names[XRG_CGROUP_NUM_FILES] = {
+    "cpu.stat",
+    "memory.current",
+    "io.stat",
+    "cpu.pressure",
+    "memory.pressure",
+    "io.pressure",
+};
+
+struct _XRGCgroupCollector {
+    gint root_fd;                   /* CGROUP_ROOT, -1 if not cgroup v2 */
+    gint dataset_capacity;
+
+    GPtrArray *cgroups;             /* XRGCgroupInfo, in walk order */
+    GHashTable *by_path;            /* path -> XRGCgroupInfo */
+    GPtrArray *top;                 /* Leaf cgroups, sorted */
+    XRGCgroupSortBy sort_by;
+
+    guint generation;               /* Incremented every walk */
+    gint updates_since_walk;
+    gboolean rescan_needed;         /* A cgroup disappeared since the last walk */
+    gint cached_fds;                /* File fds currently held */
+    gint num_cpus;
+
+    gint64 last_update_time;
+    gchar buf[CGROUP_READ_SIZE];    /* Read buffer shared by all files */
+};
+
+static void cgroup_info_free(gpointer data) {
+    XRGCgroupInfo *cg = data;
+
+    g_free(cg->path);
+    xrg_dataset_free(cg->cpu_history);
+    xrg_dataset_free(cg->io_history);
+    g_free(cg);
+}
+
+static void close_cgroup_files(XRGCgroupCollector *collector, XRGCgroupInfo *cg) {
+    for (gint i = 0; i < XRG_CGROUP_NUM_FILES; i++) {
+        if (cg->fds[i] >= 0) {
+            close(cg->fds[i]);
+            collector->cached_fds--;
+        }
+        cg->fds[i] = -1;
+    }
+}
+
+/*
+ * Read one cgroup file into collector->buf. The fd is kept for the next
+ * read while the budget allows; files a controller does not provide are
+ * remembered as absent so they are not retried every update.
+ */
+static gssize read_cgroup_file(XRGCgroupCollector *collector, XRGCgroupInfo *cg, XRGCgroupFile file) {
+    if (cg->fds[file] == -2)
+        return -1;
+
+    gint fd = cg->fds[file];
+    if (fd < 0) {
+        gchar path[PATH_MAX];
+        g_snprintf(path, sizeof(path), "%s/%s", cg->path, cgroup_file_names[file]);
+
+        fd = openat(collector->root_fd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                /* Controller not enabled here, or the cgroup is gone */
+                struct stat st;
+                if (fstatat(collector->root_fd, cg->path, &st, 0) == 0)
+                    cg->fds[file] = -2;
+                else
+                    collector->rescan_needed = TRUE;
+            }
+            return -1;
+        }
+        if (collector->cached_fds < MAX_CACHED_FDS) {
+            cg->fds[file] = fd;
+            collector->cached_fds++;
+        }
+    }
+
+    ssize_t n = pread(fd, collector->buf, sizeof(collector->buf) - 1, 0);
+    if (fd != cg->fds[file])
+        close(fd);
+
+    if (n < 0) {
+        /* ENODEV: the cgroup was removed under the held fd */
+        close_cgroup_files(collector, cg);
+        collector->rescan_needed = TRUE;
+        return -1;
+    }
+    collector->buf[n] = '\0';
+    return n;
+}
+
+/* Helper: Value of "key N" in a flat keyed file such as cpu.stat */
+static gboolean parse_keyed_u64(const gchar *text, const gchar *key, guint64 *value) {
+    gsize key_len = strlen(key);
+
+    for (const gchar *line = text; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+        if (strncmp(line, key, key_len) == 0 && line[key_len] == ' ') {
+            *value = strtoull(line + key_len + 1, NULL, 10);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Helper: "some avg10=1.23 avg60=... total=..." -> 1.23 */
+static gdouble parse_pressure_some(const gchar *text) {
+    if (!g_str_has_prefix(text, "some "))
+        return 0.0;
+
+    const gchar *avg10 = strstr(text, "avg10=");
+    return avg10 ? g_ascii_strtod(avg10 + 6, NULL) : 0.0;
+}
+
+/* Helper: Sum rbytes= and wbytes= over the device lines of io.stat */
+static void parse_io_stat(const gchar *text, guint64 *read_bytes, guint64 *written_bytes) {
+    *read_bytes = 0;
+    *written_bytes = 0;
+
+    for (const gchar *p = text; (p = strstr(p, "bytes=")) != NULL; p += 6) {
+        if (p > text && p[-1] == 'r')
+            *read_bytes += strtoull(p + 6, NULL, 10);
+        else if (p > text && p[-1] == 'w')
+            *written_bytes += strtoull(p + 6, NULL, 10);
+    }
+}
+
+/* Walk one directory level below dir_fd; returns TRUE if it has child cgroups */
+static gboolean walk_cgroup_dir(XRGCgroupCollector *collector, gint dir_fd, const gchar *path, gint depth) {
+    DIR *dir = fdopendir(dir_fd);
+    if (dir == NULL) {
+        close(dir_fd);
+        return FALSE;
+    }
+
+    gboolean has_children = FALSE;
+    struct dirent *entry;
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_type != DT_DIR || entry->d_name[0] == '.')
+            continue;
+
+        has_children = TRUE;
+        if (collector->cgroups->len >= MAX_CGROUPS)
+            continue;
+
+        gint child_fd = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (child_fd < 0)
+            continue;
+
+        struct stat st;
+        if (fstat(child_fd, &st) != 0) {
+            close(child_fd);
+            continue;
+        }
+
+        gchar *child_path = path[0] ? g_strdup_printf("%s/%s", path, entry->d_name)
+                                    : g_strdup(entry->d_name);
+
+        XRGCgroupInfo *cg = g_hash_table_lookup(collector->by_path, child_path);
+        if (cg && cg->inode != (guint64)st.st_ino) {
+            /* Same name, new cgroup: start over */
+            close_cgroup_files(collector, cg);
+            cg->inode = st.st_ino;
+            cg->have_sample = FALSE;
+            xrg_dataset_clear(cg->cpu_history);
+            xrg_dataset_clear(cg->io_history);
+        }
+        if (!cg) {
+            cg = g_new0(XRGCgroupInfo, 1);
+            cg->path = child_path;
+            cg->name = strrchr(cg->path, '/') ? strrchr(cg->path, '/') + 1 : cg->path;
+            cg->inode = st.st_ino;
+            for (gint i = 0; i < XRG_CGROUP_NUM_FILES; i++)
+                cg->fds[i] = -1;
+            cg->cpu_history = xrg_dataset_new(collector->dataset_capacity);
+            cg->io_history = xrg_dataset_new(collector->dataset_capacity);
+            g_hash_table_insert(collector->by_path, cg->path, cg);
+            child_path = NULL;
+        }
+        g_free(child_path);
+
+        cg->generation = collector->generation;
+        g_ptr_array_add(collector->cgroups, cg);
+
+        if (depth + 1 < MAX_CGROUP_DEPTH) {
+            cg->is_leaf = !walk_cgroup_dir(collector, child_fd, cg->path, depth + 1);
+        } else {
+            close(child_fd);
+            cg->is_leaf = TRUE;
+        }
+    }
+
+    closedir(dir);
+    return has_children;
+}
+
+/* Rebuild the cgroup list, keeping fds and counters of cgroups that still exist */
+static void walk_cgroups(XRGCgroupCollector *collector) {
+    collector->generation++;
+    g_ptr_array_set_size(collector->cgroups, 0);
+
+    gint fd = openat(collector->root_fd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+        walk_cgroup_dir(collector, fd, "", 0);
+
+    /* Forget cgroups the walk did not find */
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, collector->by_path);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        XRGCgroupInfo *cg = value;
+        if (cg->generation != collector->generation) {
+            close_cgroup_files(collector, cg);
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+
+    collector->updates_since_walk = 0;
+    collector->rescan_needed = FALSE;
+}
+
+/* Poll one cgroup's files and derive rates over time_delta seconds */
+static void sample_cgroup(XRGCgroupCollector *collector, XRGCgroupInfo *cg, gdouble time_delta) {
+    guint64 usage_usec = cg->usage_usec;
+    guint64 read_bytes = cg->read_bytes;
+    guint64 written_bytes = cg->written_bytes;
+
+    if (read_cgroup_file(collector, cg, XRG_CGROUP_FILE_CPU_STAT) > 0)
+        parse_keyed_u64(collector->buf, "usage_usec", &usage_usec);
+
+    if (read_cgroup_file(collector, cg, XRG_CGROUP_FILE_MEMORY_CURRENT) > 0)
+        cg->memory_bytes = strtoull(collector->buf, NULL, 10);
+
+    if (read_cgroup_file(collector, cg, XRG_CGROUP_FILE_IO_STAT) >= 0)
+        parse_io_stat(collector->buf, &read_bytes, &written_bytes);
+
+    cg->cpu_pressure = read_cgroup_file(collector, cg, XRG_CGROUP_FILE_CPU_PRESSURE) > 0
+                       ? parse_pressure_some(collector->buf) : 0.0;
+    cg->memory_pressure = read_cgroup_file(collector, cg, XRG_CGROUP_FILE_MEMORY_PRESSURE) > 0
+                          ? parse_pressure_some(collector->buf) : 0.0;
+    cg->io_pressure = read_cgroup_file(collector, cg, XRG_CGROUP_FILE_IO_PRESSURE) > 0
+                      ? parse_pressure_some(collector->buf) : 0.0;
+
+    /* Counters only grow; a drop means the cgroup was re-created between walks */
+    if (cg->have_sample && time_delta > 0 && usage_usec >= cg->usage_usec &&
+        read_bytes >= cg->read_bytes && written_bytes >= cg->written_bytes) {
+        cg->cpu_percent = (gdouble)(usage_usec - cg->usage_usec) /
+                          (time_delta * 1e6 * collector->num_cpus) * 100.0;
+        cg->read_rate = (read_bytes - cg->read_bytes) / time_delta;
+        cg->write_rate = (written_bytes - cg->written_bytes) / time_delta;
+    } else {
+        cg->cpu_percent = 0.0;
+        cg->read_rate = 0.0;
+        cg->write_rate = 0.0;
+    }
+
+    cg->usage_usec = usage_usec;
+    cg->read_bytes = read_bytes;
+    cg->written_bytes = written_bytes;
+    cg->have_sample = TRUE;
+
+    xrg_dataset_add_value(cg->cpu_history, cg->cpu_percent);
+    xrg_dataset_add_value(cg->io_history, (cg->read_rate + cg->write_rate) / (1024.0 * 1024.0));
+}
+
+static gint compare_cgroups(gconstpointer a, gconstpointer b, gpointer user_data) {
+    const XRGCgroupInfo *ca = *(const XRGCgroupInfo **)a;
+    const XRGCgroupInfo *cb = *(const XRGCgroupInfo **)b;
+    XRGCgroupCollector *collector = user_data;
+    gdouble ka, kb;
+
+    switch (collector->sort_by) {
+        case XRG_CGROUP_SORT_MEMORY:
+            ka = ca->memory_bytes;
+            kb = cb->memory_bytes;
+            break;
+        case XRG_CGROUP_SORT_IO:
+            ka = ca->read_rate + ca->write_rate;
+            kb = cb->read_rate + cb->write_rate;
+            break;
+        case XRG_CGROUP_SORT_CPU:
+        default:
+            ka = ca->cpu_percent;
+            kb = cb->cpu_percent;
+            break;
+    }
+
+    if (ka > kb) return -1;
+    if (ka < kb) return 1;
+    return strcmp(ca->path, cb->path);
+}
+
+static void rank_cgroups(XRGCgroupCollector *collector) {
+    g_ptr_array_set_size(collector->top, 0);
+    for (guint i = 0; i < collector->cgroups->len; i++) {
+        XRGCgroupInfo *cg = g_ptr_array_index(collector->cgroups, i);
+        if (cg->is_leaf)
+            g_ptr_array_add(collector->top, cg);
+    }
+    g_ptr_array_sort_with_data(collector->top, compare_cgroups, collector);
+}
+
+/**
+ * Create new cgroup collector
+ */
+XRGCgroupCollector* xrg_cgroup_collector_new(gint dataset_capacity) {
+    XRGCgroupCollector *collector = g_new0(XRGCgroupCollector, 1);
+
+    collector->dataset_capacity = dataset_capacity;
+    collector->cgroups = g_ptr_array_new();
+    collector->by_path = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, cgroup_info_free);
+    collector->top = g_ptr_array_new();
+    collector->sort_by = XRG_CGROUP_SORT_CPU;
+    collector->num_cpus = MAX((gint)g_get_num_processors(), 1);
+    collector->root_fd = -1;
+
+    /* cgroup.controllers only exists at the root of a unified (v2) hierarchy */
+    gint fd = open(CGROUP_ROOT, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (faccessat(fd, "cgroup.controllers", F_OK, 0) == 0)
+            collector->root_fd = fd;
+        else
+            close(fd);
+    }
+
+    if (collector->root_fd >= 0) {
+        walk_cgroups(collector);
+    }
+    collector->last_update_time = g_get_monotonic_time();
+
+    xrg_cgroup_collector_update(collector);
+
+    return collector;
+}
+
+/**
+ * Free cgroup collector
+ */
+void xrg_cgroup_collector_free(XRGCgroupCollector *collector) {
+    if (collector == NULL)
+        return;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, collector->by_path);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        close_cgroup_files(collector, value);
+    }
+
+    g_ptr_array_free(collector->top, TRUE);
+    g_ptr_array_free(collector->cgroups, TRUE);
+    g_hash_table_destroy(collector->by_path);
+    if (collector->root_fd >= 0)
+        close(collector->root_fd);
+
+    g_free(collector);
+}
+
+/**
+ * Update cgroup statistics: pread() on held fds, walk only periodically
+ */
+void xrg_cgroup_collector_update(XRGCgroupCollector *collector) {
+    g_return_if_fail(collector != NULL);
+
+    if (collector->root_fd < 0)
+        return;
+
+    if (collector->rescan_needed || ++collector->updates_since_walk >= RESCAN_INTERVAL)
+        walk_cgroups(collector);
+
+    gint64 current_time = g_get_monotonic_time();
+    gdouble time_delta = (current_time - collector->last_update_time) / 1000000.0;  /* seconds */
+
+    for (guint i = 0; i < collector->cgroups->len; i++) {
+        sample_cgroup(collector, g_ptr_array_index(collector->cgroups, i), time_delta);
+    }
+
+    rank_cgroups(collector);
+    collector->last_update_time = current_time;
+}
+
+/* Getters */
+
+gboolean xrg_cgroup_collector_is_available(XRGCgroupCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    return collector->root_fd >= 0;
+}
+
+gint xrg_cgroup_collector_get_num_cgroups(XRGCgroupCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->cgroups->len;
+}
+
+gint xrg_cgroup_collector_get_top_count(XRGCgroupCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->top->len;
+}
+
+const XRGCgroupInfo* xrg_cgroup_collector_get_top(XRGCgroupCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->top->len)
+        return NULL;
+    return g_ptr_array_index(collector->top, index);
+}
+
+/* Sorting */
+
+void xrg_cgroup_collector_set_sort_by(XRGCgroupCollector *collector, XRGCgroupSortBy sort_by) {
+    g_return_if_fail(collector != NULL);
+    collector->sort_by = sort_by;
+    rank_cgroups(collector);
+}
+
+XRGCgroupSortBy xrg_cgroup_collector_get_sort_by(XRGCgroupCollector *collector) {
+    g_return_val_if_fail(collector != NULL, XRG_CGROUP_SORT_CPU);
+    return collector->sort_by;
+}
@@ -0,0 +1,89 @@
+#ifndef XRG_CGROUP_COLLECTOR_H
+#define XRG_CGROUP_COLLECTOR_H
+
+#include <glib.h>
+#include "../core/dataset.h"
+
+/**
+ * XRGCgroupCollector - Per-cgroup resource usage (cgroup v2)
+ *
+ * Walks /sys/fs/cgroup once (and again every few updates to pick up new
+ * services and containers), then polls each known cgroup's cpu.stat,
+ * memory.current, io.stat and *.pressure through held fds with pread():
+ * - CPU % of the whole machine from usage_usec
+ * - Memory in bytes, read and write bytes per second summed over devices
+ * - PSI "some" avg10 for CPU, memory and I/O
+ *
+ * Only leaf cgroups (services, scopes, containers) are ranked, since a
+ * slice's numbers already include its children. Hosts without the
+ * unified hierarchy report the collector unavailable.
+ */
+
+#define CGROUP_ROOT "/sys/fs/cgroup"
+
+typedef enum {
+    XRG_CGROUP_SORT_CPU,
+    XRG_CGROUP_SORT_MEMORY,
+    XRG_CGROUP_SORT_IO
+} XRGCgroupSortBy;
+
+/* cgroup files polled every update */
+typedef enum {
+    XRG_CGROUP_FILE_CPU_STAT,
+    XRG_CGROUP_FILE_MEMORY_CURRENT,
+    XRG_CGROUP_FILE_IO_STAT,
+    XRG_CGROUP_FILE_CPU_PRESSURE,
+    XRG_CGROUP_FILE_MEMORY_PRESSURE,
+    XRG_CGROUP_FILE_IO_PRESSURE,
+    XRG_CGROUP_NUM_FILES
+} XRGCgroupFile;
+
+typedef struct {
+    gchar *path;                /* Relative to CGROUP_ROOT, e.g. "system.slice/sshd.service" */
+    const gchar *name;          /* Last path component (points into path) */
+    guint64 inode;              /* Tells a re-created cgroup from the old one */
+    gboolean is_leaf;           /* No child cgroups */
+    guint generation;           /* Last walk that found this cgroup */
+
+    gint fds[XRG_CGROUP_NUM_FILES];  /* Held open; -1 not yet opened, -2 not present */
+
+    /* Latest values */
+    gdouble cpu_percent;        /* Of all CPUs */
+    guint64 memory_bytes;
+    gdouble read_rate;          /* Bytes per second */
+    gdouble write_rate;         /* Bytes per second */
+    gdouble cpu_pressure;       /* PSI some avg10, % */
+    gdouble memory_pressure;
+    gdouble io_pressure;
+
+    /* Counters for rates */
+    guint64 usage_usec;
+    guint64 read_bytes;
+    guint64 written_bytes;
+    gboolean have_sample;       /* Counters above hold a previous sample */
+
+    /* History */
+    XRGDataset *cpu_history;    /* CPU % */
+    XRGDataset *io_history;     /* Read + write in MB/s */
+} XRGCgroupInfo;
+
+typedef struct _XRGCgroupCollector XRGCgroupCollector;
+
+/* Lifecycle */
+XRGCgroupCollector* xrg_cgroup_collector_new(gint dataset_capacity);
+void xrg_cgroup_collector_free(XRGCgroupCollector *collector);
+void xrg_cgroup_collector_update(XRGCgroupCollector *collector);
+
+/* Getters */
+gboolean xrg_cgroup_collector_is_available(XRGCgroupCollector *collector);
+gint xrg_cgroup_collector_get_num_cgroups(XRGCgroupCollector *collector);
+
+/* Top leaf cgroups by the sort key, best first; valid until the next update */
+gint xrg_cgroup_collector_get_top_count(XRGCgroupCollector *collector);
+const XRGCgroupInfo* xrg_cgroup_collector_get_top(XRGCgroupCollector *collector, gint index);
+
+/* Sorting */
+void xrg_cgroup_collector_set_sort_by(XRGCgroupCollector *collector, XRGCgroupSortBy sort_by);
+XRGCgroupSortBy xrg_cgroup_collector_get_sort_by(XRGCgroupCollector *collector);
+
+#endif /* XRG_CGROUP_COLLECTOR_H */
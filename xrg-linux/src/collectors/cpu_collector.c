@@ -1,10 +1,12 @@
 #include "cpu_collector.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 #define PROC_STAT "/proc/stat"
 #define PROC_LOADAVG "/proc/loadavg"
+#define SYS_CPU_TOPOLOGY "/sys/devices/system/cpu/cpu%d/topology/%s"
 
 /* Helper: Get CPU count */
 static gint get_cpu_count(void) {
@@ -30,8 +32,9 @@ static gboolean parse_cpu_stat_line(const gchar *line, CPUStats *stats) {
     return (parsed >= 4);  /* At least user, nice, system, idle */
 }
 
-/* Helper: Calculate CPU usage percentage */
-static gdouble calculate_cpu_usage(CPUStats *current, CPUStats *previous) {
+/* Helper: Busy and total jiffies elapsed between two samples */
+static void calculate_cpu_deltas(CPUStats *current, CPUStats *previous,
+                                 guint64 *busy_diff, guint64 *total_diff) {
     guint64 prev_idle = previous->idle + previous->iowait;
     guint64 curr_idle = current->idle + current->iowait;
 
@@ -43,13 +46,171 @@ static gdouble calculate_cpu_usage(CPUStats *current, CPUStats *previous) {
     guint64 prev_total = prev_idle + prev_non_idle;
     guint64 curr_total = curr_idle + curr_non_idle;
 
-    guint64 total_diff = curr_total - prev_total;
+    /* Counters can step backwards across CPU hotplug; treat as no data */
+    if (curr_total < prev_total || curr_idle < prev_idle) {
+        *busy_diff = 0;
+        *total_diff = 0;
+        return;
+    }
+
+    *total_diff = curr_total - prev_total;
     guint64 idle_diff = curr_idle - prev_idle;
+    *busy_diff = (*total_diff > idle_diff) ? *total_diff - idle_diff : 0;
+}
+
+/* Helper: Calculate CPU usage percentage */
+static gdouble calculate_cpu_usage(CPUStats *current, CPUStats *previous) {
+    guint64 busy_diff, total_diff;
+    calculate_cpu_deltas(current, previous, &busy_diff, &total_diff);
 
     if (total_diff == 0)
         return 0.0;
 
-    return (gdouble)(total_diff - idle_diff) / (gdouble)total_diff * 100.0;
+    return (gdouble)busy_diff / (gdouble)total_diff * 100.0;
+}
+
+/* Helper: Read one integer topology attribute, -1 if unavailable */
+static gint read_topology_value(gint cpu_id, const gchar *attribute) {
+    gchar path[128];
+    g_snprintf(path, sizeof(path), SYS_CPU_TOPOLOGY, cpu_id, attribute);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+
+    gint value = -1;
+    if (fscanf(fp, "%d", &value) != 1)
+        value = -1;
+    fclose(fp);
+    return value;
+}
+
+/*
+ * Helper: Build the CPU -> physical core and CPU -> package maps.
+ *
+ * Per-CPU lines in /proc/stat are stored by position, so the kernel CPU id
+ * for each slot is taken from the same file. Physical cores are the distinct
+ * (physical_package_id, core_id) pairs; core_id alone repeats across sockets.
+ * Without sysfs topology every CPU is its own core on a single package.
+ */
+static void read_cpu_topology(XRGCPUCollector *collector) {
+    gint n = collector->num_cpus;
+    gint *cpu_ids = g_new(gint, n);
+    gint *core_pkg = g_new(gint, n);   /* Package id of each distinct core */
+    gint *core_ids = g_new(gint, n);   /* core_id of each distinct core */
+    gint *pkg_ids = g_new(gint, n);    /* Distinct package ids */
+
+    for (gint i = 0; i < n; i++)
+        cpu_ids[i] = i;
+
+    FILE *fp = fopen(PROC_STAT, "r");
+    if (fp != NULL) {
+        gchar line[256];
+        gint slot = 0;
+        while (slot < n && fgets(line, sizeof(line), fp)) {
+            gint id;
+            if (g_str_has_prefix(line, "cpu ") || !g_str_has_prefix(line, "cpu"))
+                continue;
+            if (sscanf(line + 3, "%d", &id) == 1)
+                cpu_ids[slot++] = id;
+        }
+        fclose(fp);
+    }
+
+    collector->num_cores = 0;
+    collector->num_packages = 0;
+
+    for (gint i = 0; i < n; i++) {
+        gint package_id = read_topology_value(cpu_ids[i], "physical_package_id");
+        gint core_id = read_topology_value(cpu_ids[i], "core_id");
+        if (package_id < 0)
+            package_id = 0;
+        if (core_id < 0)
+            core_id = cpu_ids[i];
+
+        gint p;
+        for (p = 0; p < collector->num_packages; p++) {
+            if (pkg_ids[p] == package_id)
+                break;
+        }
+        if (p == collector->num_packages)
+            pkg_ids[collector->num_packages++] = package_id;
+        collector->package_of_cpu[i] = p;
+
+        gint c;
+        for (c = 0; c < collector->num_cores; c++) {
+            if (core_pkg[c] == package_id && core_ids[c] == core_id)
+                break;
+        }
+        if (c == collector->num_cores) {
+            core_pkg[c] = package_id;
+            core_ids[c] = core_id;
+            collector->num_cores++;
+        }
+        collector->core_of_cpu[i] = c;
+    }
+
+    g_free(cpu_ids);
+    g_free(core_pkg);
+    g_free(core_ids);
+    g_free(pkg_ids);
+}
+
+/* Helper: qsort comparator for gdouble */
+static int compare_doubles(const void *a, const void *b) {
+    gdouble da = *(const gdouble *)a;
+    gdouble db = *(const gdouble *)b;
+    return (da > db) - (da < db);
+}
+
+/* Helper: Record min/p50/p90/max of the latest per-CPU usage values */
+static void update_usage_bands(XRGCPUCollector *collector) {
+    gint n = collector->num_cpus;
+    gdouble *values = collector->band_scratch;
+
+    for (gint i = 0; i < n; i++)
+        values[i] = xrg_dataset_get_latest(collector->per_core_usage[i]);
+    qsort(values, n, sizeof(gdouble), compare_doubles);
+
+    /* Nearest-rank percentiles */
+    gint p50 = (n * 50 + 99) / 100 - 1;
+    gint p90 = (n * 90 + 99) / 100 - 1;
+
+    xrg_dataset_add_value(collector->band_usage[XRG_CPU_BAND_MIN], values[0]);
+    xrg_dataset_add_value(collector->band_usage[XRG_CPU_BAND_P50], values[MAX(p50, 0)]);
+    xrg_dataset_add_value(collector->band_usage[XRG_CPU_BAND_P90], values[MAX(p90, 0)]);
+    xrg_dataset_add_value(collector->band_usage[XRG_CPU_BAND_MAX], values[n - 1]);
+}
+
+/* Helper: Sum per-CPU deltas into core/package groups and record percentages */
+static void update_group_usage(XRGCPUCollector *collector) {
+    gint groups = collector->num_cores + collector->num_packages;
+    guint64 *busy = collector->group_busy;
+    guint64 *total = collector->group_total;
+
+    memset(busy, 0, sizeof(guint64) * groups);
+    memset(total, 0, sizeof(guint64) * groups);
+
+    for (gint i = 0; i < collector->num_cpus; i++) {
+        guint64 busy_diff, total_diff;
+        calculate_cpu_deltas(&collector->current_stats[i], &collector->previous_stats[i],
+                             &busy_diff, &total_diff);
+
+        gint c = collector->core_of_cpu[i];
+        gint p = collector->num_cores + collector->package_of_cpu[i];
+        busy[c] += busy_diff;
+        total[c] += total_diff;
+        busy[p] += busy_diff;
+        total[p] += total_diff;
+    }
+
+    for (gint g = 0; g < groups; g++) {
+        gdouble usage = total[g] ? (gdouble)busy[g] / (gdouble)total[g] * 100.0 : 0.0;
+        if (g < collector->num_cores)
+            xrg_dataset_add_value(collector->per_physical_core_usage[g], usage);
+        else
+            xrg_dataset_add_value(collector->per_package_usage[g - collector->num_cores], usage);
+    }
 }
 
 /**
@@ -60,9 +221,13 @@ XRGCPUCollector* xrg_cpu_collector_new(gint dataset_capacity) {
 
     /* Detect CPU count */
     collector->num_cpus = get_cpu_count();
-    collector->num_cores = collector->num_cpus;  /* Simplified for now */
     collector->num_threads = collector->num_cpus;
 
+    /* Detect physical cores and packages */
+    collector->core_of_cpu = g_new0(gint, collector->num_cpus);
+    collector->package_of_cpu = g_new0(gint, collector->num_cpus);
+    read_cpu_topology(collector);
+
     /* Allocate stats arrays */
     collector->current_stats = g_new0(CPUStats, collector->num_cpus);
     collector->previous_stats = g_new0(CPUStats, collector->num_cpus);
@@ -78,6 +243,24 @@ XRGCPUCollector* xrg_cpu_collector_new(gint dataset_capacity) {
         collector->per_core_usage[i] = xrg_dataset_new(dataset_capacity);
     }
 
+    /* Create per-physical-core and per-package datasets */
+    collector->per_physical_core_usage = g_new0(XRGDataset*, collector->num_cores);
+    for (gint i = 0; i < collector->num_cores; i++) {
+        collector->per_physical_core_usage[i] = xrg_dataset_new(dataset_capacity);
+    }
+    collector->per_package_usage = g_new0(XRGDataset*, collector->num_packages);
+    for (gint i = 0; i < collector->num_packages; i++) {
+        collector->per_package_usage[i] = xrg_dataset_new(dataset_capacity);
+    }
+    collector->group_busy = g_new0(guint64, collector->num_cores + collector->num_packages);
+    collector->group_total = g_new0(guint64, collector->num_cores + collector->num_packages);
+
+    /* Create distribution band datasets */
+    for (gint b = 0; b < XRG_CPU_BAND_COUNT; b++) {
+        collector->band_usage[b] = xrg_dataset_new(dataset_capacity);
+    }
+    collector->band_scratch = g_new0(gdouble, collector->num_cpus);
+
     /* Initialize */
     collector->last_update_time = g_get_monotonic_time();
 
@@ -106,6 +289,26 @@ void xrg_cpu_collector_free(XRGCPUCollector *collector) {
     }
     g_free(collector->per_core_usage);
 
+    for (gint i = 0; i < collector->num_cores; i++) {
+        xrg_dataset_free(collector->per_physical_core_usage[i]);
+    }
+    g_free(collector->per_physical_core_usage);
+
+    for (gint i = 0; i < collector->num_packages; i++) {
+        xrg_dataset_free(collector->per_package_usage[i]);
+    }
+    g_free(collector->per_package_usage);
+
+    g_free(collector->group_busy);
+    g_free(collector->group_total);
+
+    for (gint b = 0; b < XRG_CPU_BAND_COUNT; b++) {
+        xrg_dataset_free(collector->band_usage[b]);
+    }
+    g_free(collector->band_scratch);
+    g_free(collector->core_of_cpu);
+    g_free(collector->package_of_cpu);
+
     g_free(collector);
 }
 
@@ -166,6 +369,15 @@ void xrg_cpu_collector_update(XRGCPUCollector *collector) {
         xrg_dataset_add_value(collector->per_core_usage[i], core_usage);
     }
 
+    /* Physical core and package usage */
+    update_group_usage(collector);
+
+    /* Spread across CPUs */
+    if (collector->num_cpus > 0)
+        update_usage_bands(collector);
+
+    collector->sample_count++;
+
     /* Read load averages */
     fp = fopen(PROC_LOADAVG, "r");
     if (fp != NULL) {
@@ -197,6 +409,16 @@ gint xrg_cpu_collector_get_num_cpus(XRGCPUCollector *collector) {
     return collector->num_cpus;
 }
 
+gint xrg_cpu_collector_get_num_cores(XRGCPUCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->num_cores;
+}
+
+gint xrg_cpu_collector_get_num_packages(XRGCPUCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->num_packages;
+}
+
 gdouble xrg_cpu_collector_get_total_usage(XRGCPUCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0.0);
 
@@ -244,3 +466,53 @@ XRGDataset* xrg_cpu_collector_get_core_dataset(XRGCPUCollector *collector, gint
     g_return_val_if_fail(core >= 0 && core < collector->num_cpus, NULL);
     return collector->per_core_usage[core];
 }
+
+gint xrg_cpu_collector_get_group_count(XRGCPUCollector *collector, XRGCPUGranularity granularity) {
+    g_return_val_if_fail(collector != NULL, 0);
+
+    switch (granularity) {
+        case XRG_CPU_GRANULARITY_CORE:
+            return collector->num_cores;
+        case XRG_CPU_GRANULARITY_PACKAGE:
+            return collector->num_packages;
+        case XRG_CPU_GRANULARITY_THREAD:
+        default:
+            return collector->num_cpus;
+    }
+}
+
+XRGDataset* xrg_cpu_collector_get_group_dataset(XRGCPUCollector *collector,
+                                                XRGCPUGranularity granularity, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    g_return_val_if_fail(index >= 0 && index < xrg_cpu_collector_get_group_count(collector, granularity), NULL);
+
+    switch (granularity) {
+        case XRG_CPU_GRANULARITY_CORE:
+            return collector->per_physical_core_usage[index];
+        case XRG_CPU_GRANULARITY_PACKAGE:
+            return collector->per_package_usage[index];
+        case XRG_CPU_GRANULARITY_THREAD:
+        default:
+            return collector->per_core_usage[index];
+    }
+}
+
+const gchar* xrg_cpu_granularity_name(XRGCPUGranularity granularity) {
+    switch (granularity) {
+        case XRG_CPU_GRANULARITY_CORE:    return "Cores";
+        case XRG_CPU_GRANULARITY_PACKAGE: return "Packages";
+        case XRG_CPU_GRANULARITY_THREAD:
+        default:                          return "Threads";
+    }
+}
+
+XRGDataset* xrg_cpu_collector_get_band_dataset(XRGCPUCollector *collector, XRGCPUBand band) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    g_return_val_if_fail(band >= 0 && band < XRG_CPU_BAND_COUNT, NULL);
+    return collector->band_usage[band];
+}
+
+guint64 xrg_cpu_collector_get_sample_count(XRGCPUCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->sample_count;
+}
@@ -9,6 +9,7 @@
  *
  * Collects CPU usage statistics from /proc/stat for:
  * - Per-core utilization
+ * - Per-physical-core and per-package aggregates (from sysfs topology)
  * - Overall system load
  * - Load averages (from /proc/loadavg)
  * - Process counts
@@ -16,6 +17,26 @@
 
 typedef struct _XRGCPUCollector XRGCPUCollector;
 
+/**
+ * Aggregation level for per-CPU series
+ */
+typedef enum {
+    XRG_CPU_GRANULARITY_THREAD  = 0,  /* One series per logical CPU */
+    XRG_CPU_GRANULARITY_CORE    = 1,  /* SMT siblings combined */
+    XRG_CPU_GRANULARITY_PACKAGE = 2   /* All CPUs of a socket combined */
+} XRGCPUGranularity;
+
+/**
+ * Distribution bands across logical CPUs, one value per sample
+ */
+typedef enum {
+    XRG_CPU_BAND_MIN = 0,
+    XRG_CPU_BAND_P50 = 1,
+    XRG_CPU_BAND_P90 = 2,
+    XRG_CPU_BAND_MAX = 3,
+    XRG_CPU_BAND_COUNT
+} XRGCPUBand;
+
 typedef struct {
     guint64 user;
     guint64 nice;
@@ -32,8 +53,13 @@ typedef struct {
 struct _XRGCPUCollector {
     /* CPU count */
     gint num_cpus;
-    gint num_cores;
+    gint num_cores;     /* Physical cores (distinct package/core_id pairs) */
     gint num_threads;
+    gint num_packages;  /* Sockets (distinct physical_package_id values) */
+
+    /* Topology, read once from /sys/devices/system/cpu/cpuN/topology */
+    gint *core_of_cpu;     /* CPU index -> physical core index */
+    gint *package_of_cpu;  /* CPU index -> package index */
 
     /* Current and previous CPU statistics */
     CPUStats *current_stats;  /* Array of per-core stats */
@@ -46,6 +72,19 @@ struct _XRGCPUCollector {
     XRGDataset *user_usage;     /* User CPU % */
     XRGDataset *nice_usage;     /* Nice CPU % */
     XRGDataset **per_core_usage; /* Per-core CPU % array */
+    XRGDataset **per_physical_core_usage; /* Per-physical-core CPU % array */
+    XRGDataset **per_package_usage;       /* Per-package CPU % array */
+
+    /* Scratch for aggregating per-CPU deltas (num_cores + num_packages) */
+    guint64 *group_busy;
+    guint64 *group_total;
+
+    /* Min/p50/p90/max of per-CPU usage at each sample */
+    XRGDataset *band_usage[XRG_CPU_BAND_COUNT];
+    gdouble *band_scratch;  /* num_cpus values, sorted each update */
+
+    /* Number of updates so far (lets renderers scroll incrementally) */
+    guint64 sample_count;
 
     /* Load averages */
     gdouble load_average_1min;
@@ -70,6 +109,8 @@ gboolean xrg_cpu_collector_fast_update(XRGCPUCollector *collector);
 
 /* Getters */
 gint xrg_cpu_collector_get_num_cpus(XRGCPUCollector *collector);
+gint xrg_cpu_collector_get_num_cores(XRGCPUCollector *collector);
+gint xrg_cpu_collector_get_num_packages(XRGCPUCollector *collector);
 gdouble xrg_cpu_collector_get_total_usage(XRGCPUCollector *collector);
 gdouble xrg_cpu_collector_get_core_usage(XRGCPUCollector *collector, gint core);
 gdouble xrg_cpu_collector_get_load_average_1min(XRGCPUCollector *collector);
@@ -81,4 +122,12 @@ XRGDataset* xrg_cpu_collector_get_system_dataset(XRGCPUCollector *collector);
 XRGDataset* xrg_cpu_collector_get_user_dataset(XRGCPUCollector *collector);
 XRGDataset* xrg_cpu_collector_get_core_dataset(XRGCPUCollector *collector, gint core);
 
+/* Aggregated series (thread = per_core_usage, core = SMT siblings, package = socket) */
+gint xrg_cpu_collector_get_group_count(XRGCPUCollector *collector, XRGCPUGranularity granularity);
+XRGDataset* xrg_cpu_collector_get_group_dataset(XRGCPUCollector *collector,
+                                                XRGCPUGranularity granularity, gint index);
+const gchar* xrg_cpu_granularity_name(XRGCPUGranularity granularity);
+XRGDataset* xrg_cpu_collector_get_band_dataset(XRGCPUCollector *collector, XRGCPUBand band);
+guint64 xrg_cpu_collector_get_sample_count(XRGCPUCollector *collector);
+
 #endif /* XRG_CPU_COLLECTOR_H */
@@ -0,0 +1,260 @@
+#include "cpufreq_collector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+
+#define SYS_CPUFREQ "/sys/devices/system/cpu/cpufreq"
+
+/* Helper: Read a single unsigned value from a sysfs file, 0 on failure */
+static guint64 read_sysfs_u64(const gchar *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+
+    unsigned long long value = 0;
+    if (fscanf(fp, "%llu", &value) != 1)
+        value = 0;
+    fclose(fp);
+    return value;
+}
+
+/* Helper: Parse a policy's affected_cpus list ("0 1 2 3") into policy_of_cpu */
+static gint read_affected_cpus(XRGCPUFreqCollector *collector, const gchar *policy_dir, gint policy) {
+    gchar path[256];
+    g_snprintf(path, sizeof(path), "%s/affected_cpus", policy_dir);
+
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+
+    gint count = 0;
+    gint cpu;
+    while (fscanf(fp, "%d", &cpu) == 1) {
+        if (cpu >= 0 && cpu < collector->num_cpus) {
+            collector->policy_of_cpu[cpu] = policy;
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+/* Helper: Discover cpufreq policies and open their scaling_cur_freq files */
+static void open_policies(XRGCPUFreqCollector *collector, gint dataset_capacity) {
+    DIR *dir = opendir(SYS_CPUFREQ);
+    if (dir == NULL)
+        return;
+
+    GArray *policies = g_array_new(FALSE, TRUE, sizeof(XRGCPUFreqPolicy));
+    struct dirent *entry;
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (!g_str_has_prefix(entry->d_name, "policy"))
+            continue;
+
+        gchar policy_dir[256];
+        gchar path[512];
+        g_snprintf(policy_dir, sizeof(policy_dir), "%s/%s", SYS_CPUFREQ, entry->d_name);
+
+        g_snprintf(path, sizeof(path), "%s/scaling_cur_freq", policy_dir);
+        gint fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+
+        /* Policies with no online CPUs have nothing to report */
+        gint num_cpus = read_affected_cpus(collector, policy_dir, policies->len);
+        if (num_cpus == 0) {
+            close(fd);
+            continue;
+        }
+
+        XRGCPUFreqPolicy policy = { 0 };
+        policy.dir = g_strdup(policy_dir);
+        policy.fd = fd;
+        policy.num_cpus = num_cpus;
+
+        g_snprintf(path, sizeof(path), "%s/cpuinfo_max_freq", policy_dir);
+        policy.max_khz = read_sysfs_u64(path);
+        if (policy.max_khz > collector->max_khz)
+            collector->max_khz = policy.max_khz;
+
+        policy.freq_mhz = xrg_dataset_new(dataset_capacity);
+        g_array_append_val(policies, policy);
+    }
+
+    closedir(dir);
+
+    collector->num_policies = policies->len;
+    collector->policies = (XRGCPUFreqPolicy *)g_array_free(policies, FALSE);
+}
+
+/* Helper: Reopen a policy that failed; its CPUs may have come back online */
+static void reopen_policy(XRGCPUFreqCollector *collector, gint index, gint64 now) {
+    XRGCPUFreqPolicy *policy = &collector->policies[index];
+    policy->retry_at = now + CPUFREQ_RETRY_INTERVAL * G_USEC_PER_SEC;
+
+    gchar path[512];
+    g_snprintf(path, sizeof(path), "%s/scaling_cur_freq", policy->dir);
+    gint fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    gint num_cpus = read_affected_cpus(collector, policy->dir, index);
+    if (num_cpus == 0) {
+        close(fd);
+        return;
+    }
+    policy->fd = fd;
+    policy->num_cpus = num_cpus;
+}
+
+/**
+ * Create new CPU frequency collector
+ */
+XRGCPUFreqCollector* xrg_cpufreq_collector_new(gint dataset_capacity) {
+    XRGCPUFreqCollector *collector = g_new0(XRGCPUFreqCollector, 1);
+
+    collector->num_cpus = (gint)sysconf(_SC_NPROCESSORS_CONF);
+    if (collector->num_cpus < 1)
+        collector->num_cpus = 1;
+
+    collector->policy_of_cpu = g_new(gint, collector->num_cpus);
+    for (gint i = 0; i < collector->num_cpus; i++)
+        collector->policy_of_cpu[i] = -1;
+
+    collector->average_mhz = xrg_dataset_new(dataset_capacity);
+    collector->average_percent = xrg_dataset_new(dataset_capacity);
+
+    open_policies(collector, dataset_capacity);
+
+    xrg_cpufreq_collector_update(collector);
+
+    return collector;
+}
+
+/**
+ * Free CPU frequency collector
+ */
+void xrg_cpufreq_collector_free(XRGCPUFreqCollector *collector) {
+    if (collector == NULL)
+        return;
+
+    for (gint i = 0; i < collector->num_policies; i++) {
+        if (collector->policies[i].fd >= 0)
+            close(collector->policies[i].fd);
+        g_free(collector->policies[i].dir);
+        xrg_dataset_free(collector->policies[i].freq_mhz);
+    }
+    g_free(collector->policies);
+    g_free(collector->policy_of_cpu);
+
+    xrg_dataset_free(collector->average_mhz);
+    xrg_dataset_free(collector->average_percent);
+
+    g_free(collector);
+}
+
+/**
+ * Update frequencies: one pread() per policy, no open/close per tick
+ */
+void xrg_cpufreq_collector_update(XRGCPUFreqCollector *collector) {
+    g_return_if_fail(collector != NULL);
+
+    if (collector->num_policies == 0)
+        return;
+
+    gint64 now = g_get_monotonic_time();
+    guint64 weighted_khz = 0;
+    gint counted_cpus = 0;
+
+    for (gint i = 0; i < collector->num_policies; i++) {
+        XRGCPUFreqPolicy *policy = &collector->policies[i];
+
+        if (policy->fd < 0 && now >= policy->retry_at)
+            reopen_policy(collector, i, now);
+
+        if (policy->fd >= 0) {
+            gchar buf[32];
+            ssize_t n = pread(policy->fd, buf, sizeof(buf) - 1, 0);
+            if (n > 0) {
+                buf[n] = '\0';
+                policy->cur_khz = strtoull(buf, NULL, 10);
+            } else {
+                /* Policy went away (CPU hotplug); try again later */
+                close(policy->fd);
+                policy->fd = -1;
+                policy->retry_at = now + CPUFREQ_RETRY_INTERVAL * G_USEC_PER_SEC;
+                policy->cur_khz = 0;
+            }
+        }
+
+        xrg_dataset_add_value(policy->freq_mhz, policy->cur_khz / 1000.0);
+
+        if (policy->fd >= 0) {
+            weighted_khz += policy->cur_khz * policy->num_cpus;
+            counted_cpus += policy->num_cpus;
+        }
+    }
+
+    gdouble average_khz = counted_cpus ? (gdouble)weighted_khz / counted_cpus : 0.0;
+    xrg_dataset_add_value(collector->average_mhz, average_khz / 1000.0);
+    xrg_dataset_add_value(collector->average_percent,
+                          collector->max_khz ? average_khz / collector->max_khz * 100.0 : 0.0);
+}
+
+/* Getters */
+
+gboolean xrg_cpufreq_collector_is_available(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    return collector->num_policies > 0;
+}
+
+gint xrg_cpufreq_collector_get_num_policies(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->num_policies;
+}
+
+gdouble xrg_cpufreq_collector_get_average_mhz(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return xrg_dataset_get_latest(collector->average_mhz);
+}
+
+gdouble xrg_cpufreq_collector_get_max_mhz(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return collector->max_khz / 1000.0;
+}
+
+gdouble xrg_cpufreq_collector_get_cpu_mhz(XRGCPUFreqCollector *collector, gint cpu) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    g_return_val_if_fail(cpu >= 0 && cpu < collector->num_cpus, 0.0);
+
+    gint policy = collector->policy_of_cpu[cpu];
+    if (policy < 0)
+        return 0.0;
+    return collector->policies[policy].cur_khz / 1000.0;
+}
+
+/* Dataset access */
+
+XRGDataset* xrg_cpufreq_collector_get_average_dataset(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->average_mhz;
+}
+
+XRGDataset* xrg_cpufreq_collector_get_average_percent_dataset(XRGCPUFreqCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->average_percent;
+}
+
+XRGDataset* xrg_cpufreq_collector_get_cpu_dataset(XRGCPUFreqCollector *collector, gint cpu) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    g_return_val_if_fail(cpu >= 0 && cpu < collector->num_cpus, NULL);
+
+    gint policy = collector->policy_of_cpu[cpu];
+    if (policy < 0)
+        return NULL;
+    return collector->policies[policy].freq_mhz;
+}
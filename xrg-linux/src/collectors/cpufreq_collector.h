@@ -0,0 +1,66 @@
+#ifndef XRG_CPUFREQ_COLLECTOR_H
+#define XRG_CPUFREQ_COLLECTOR_H
+
+#include <glib.h>
+#include "../core/dataset.h"
+
+/**
+ * XRGCPUFreqCollector - CPU clock frequency collector
+ *
+ * Reads scaling_cur_freq from /sys/devices/system/cpu/cpufreq/policy*:
+ * - One persistent fd per cpufreq policy, re-read with pread() each tick
+ * - CPUs sharing a policy share one read and one dataset
+ * - Average frequency (MHz and % of maximum) weighted by CPUs per policy
+ * - A policy whose read fails (its CPUs went offline) is reopened every
+ *   CPUFREQ_RETRY_INTERVAL seconds, so it reports again once they return
+ *
+ * Machines without cpufreq (most VMs) report no policies and the
+ * collector is marked unavailable.
+ */
+
+#define CPUFREQ_RETRY_INTERVAL 10  /* Seconds between attempts to reopen a failed policy */
+
+typedef struct _XRGCPUFreqCollector XRGCPUFreqCollector;
+
+typedef struct {
+    gchar *dir;            /* sysfs policy directory */
+    gint fd;               /* Open scaling_cur_freq, -1 while it fails */
+    gint64 retry_at;       /* Monotonic time to try reopening a failed fd */
+    gint num_cpus;         /* CPUs governed by this policy */
+    guint64 cur_khz;       /* Latest reading */
+    guint64 max_khz;       /* cpuinfo_max_freq */
+    XRGDataset *freq_mhz;  /* Frequency history */
+} XRGCPUFreqPolicy;
+
+struct _XRGCPUFreqCollector {
+    gint num_cpus;            /* Size of policy_of_cpu */
+    gint *policy_of_cpu;      /* CPU id -> policy index, -1 if none */
+
+    XRGCPUFreqPolicy *policies;
+    gint num_policies;
+
+    guint64 max_khz;          /* Highest cpuinfo_max_freq of any policy */
+
+    /* Datasets */
+    XRGDataset *average_mhz;      /* CPU-weighted average frequency */
+    XRGDataset *average_percent;  /* Average as % of max_khz */
+};
+
+/* Lifecycle */
+XRGCPUFreqCollector* xrg_cpufreq_collector_new(gint dataset_capacity);
+void xrg_cpufreq_collector_free(XRGCPUFreqCollector *collector);
+void xrg_cpufreq_collector_update(XRGCPUFreqCollector *collector);
+
+/* Getters */
+gboolean xrg_cpufreq_collector_is_available(XRGCPUFreqCollector *collector);
+gint xrg_cpufreq_collector_get_num_policies(XRGCPUFreqCollector *collector);
+gdouble xrg_cpufreq_collector_get_average_mhz(XRGCPUFreqCollector *collector);
+gdouble xrg_cpufreq_collector_get_max_mhz(XRGCPUFreqCollector *collector);
+gdouble xrg_cpufreq_collector_get_cpu_mhz(XRGCPUFreqCollector *collector, gint cpu);
+
+/* Dataset access */
+XRGDataset* xrg_cpufreq_collector_get_average_dataset(XRGCPUFreqCollector *collector);
+XRGDataset* xrg_cpufreq_collector_get_average_percent_dataset(XRGCPUFreqCollector *collector);
+XRGDataset* xrg_cpufreq_collector_get_cpu_dataset(XRGCPUFreqCollector *collector, gint cpu);
+
+#endif /* XRG_CPUFREQ_COLLECTOR_H */
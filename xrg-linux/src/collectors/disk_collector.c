@@ -1,92 +1,447 @@
 #include "disk_collector.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 #define PROC_DISKSTATS "/proc/diskstats"
+#define SYS_BLOCK "/sys/block"
 #define SECTOR_SIZE 512  /* Standard sector size in bytes */
+#define DISKSTATS_BUFFER_SIZE 8192
+
+/* Table key: the kernel's own dev_t layout (12-bit major, 20-bit minor) */
+#define DEV_KEY(major, minor) GUINT_TO_POINTER(((major) << 20) | (minor))
+
+/* Counters after the device name in /proc/diskstats (kernel 2.6.25+) */
+typedef enum {
+    DISKSTATS_READS,
+    DISKSTATS_READS_MERGED,
+    DISKSTATS_SECTORS_READ,
+    DISKSTATS_TIME_READING,     /* ms */
+    DISKSTATS_WRITES,
+    DISKSTATS_WRITES_MERGED,
+    DISKSTATS_SECTORS_WRITTEN,
+    DISKSTATS_TIME_WRITING,     /* ms */
+    DISKSTATS_IN_FLIGHT,
+    DISKSTATS_IO_TICKS,         /* ms */
+    DISKSTATS_TIME_IN_QUEUE,    /* ms, weighted */
+    DISKSTATS_NUM_FIELDS        /* Newer kernels append discard and flush counters */
+} DiskstatsField;
+
+struct _XRGDiskCollector {
+    gint dataset_capacity;
+
+    /* Device table */
+    GPtrArray *devices;             /* XRGDiskDevice, in discovery order */
+    GHashTable *by_dev;             /* DEV_KEY -> XRGDiskDevice (owns) */
+    gpointer primary_key;           /* DEV_KEY of the busiest disk; NULL if none */
+    guint generation;               /* Incremented every update */
+
+    /* Datasets for graphing */
+    XRGDataset *read_rate;          /* Busiest disk, read in MB/s */
+    XRGDataset *write_rate;         /* Busiest disk, write in MB/s */
+    XRGDataset *all_read_rate;      /* All physical disks, read in MB/s */
+    XRGDataset *all_write_rate;     /* All physical disks, write in MB/s */
+    gdouble all_read;               /* Latest aggregate, bytes per second */
+    gdouble all_write;
+    XRGDiskLoadHistory primary_load;
+    XRGDiskLoadHistory all_load;
+
+    /* /proc/diskstats, held open */
+    gint diskstats_fd;
+    gchar *buf;
+    gsize buf_size;
+
+    /* Update tracking */
+    gint64 last_update_time;
+};
+
+static void load_history_init(XRGDiskLoadHistory *load, gint capacity) {
+    load->iops = xrg_dataset_new(capacity);
+    load->await = xrg_dataset_new(capacity);
+    load->util = xrg_dataset_new(capacity);
+    load->queue_depth = xrg_dataset_new(capacity);
+}
 
-/**
- * Check if device name is a whole disk (not a partition)
- * Examples: sda, nvme0n1, vda are whole disks
- *           sda1, nvme0n1p1, vda1 are partitions
+static void load_history_free(XRGDiskLoadHistory *load) {
+    xrg_dataset_free(load->iops);
+    xrg_dataset_free(load->await);
+    xrg_dataset_free(load->util);
+    xrg_dataset_free(load->queue_depth);
+}
+
+static void load_history_add(XRGDiskLoadHistory *load, gdouble iops, gdouble await,
+                             gdouble util, gdouble queue_depth) {
+    xrg_dataset_add_value(load->iops, iops);
+    xrg_dataset_add_value(load->await, await);
+    xrg_dataset_add_value(load->util, util);
+    xrg_dataset_add_value(load->queue_depth, queue_depth);
+}
+
+static void disk_device_free(gpointer data) {
+    XRGDiskDevice *disk = data;
+
+    xrg_dataset_free(disk->read_history);
+    xrg_dataset_free(disk->write_history);
+    load_history_free(&disk->load);
+    g_free(disk);
+}
+
+static XRGDiskDevice* lookup_device(XRGDiskCollector *collector, guint major, guint minor) {
+    return g_hash_table_lookup(collector->by_dev, DEV_KEY(major, minor));
+}
+
+static XRGDiskDevice* add_device(XRGDiskCollector *collector, guint major, guint minor, const gchar *name) {
+    XRGDiskDevice *disk = g_new0(XRGDiskDevice, 1);
+    disk->major = major;
+    disk->minor = minor;
+    g_strlcpy(disk->name, name, DISK_NAME_LEN);
+    g_strlcpy(disk->label, name, DISK_NAME_LEN);
+    disk->type = XRG_DISK_TYPE_OTHER;
+    disk->read_history = xrg_dataset_new(collector->dataset_capacity);
+    disk->write_history = xrg_dataset_new(collector->dataset_capacity);
+    load_history_init(&disk->load, collector->dataset_capacity);
+
+    g_ptr_array_add(collector->devices, disk);
+    g_hash_table_insert(collector->by_dev, DEV_KEY(major, minor), disk);
+    return disk;
+}
+
+/*============================================================================
+ * Device Enumeration
+ *============================================================================*/
+
+/* Helper: Read a small sysfs attribute relative to dir_fd, trailing newline stripped */
+static gboolean read_sysfs_attr(gint dir_fd, const gchar *name, gchar *value, gsize size) {
+    gint fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return FALSE;
+
+    ssize_t n = read(fd, value, size - 1);
+    close(fd);
+    if (n <= 0)
+        return FALSE;
+
+    value[n] = '\0';
+    if (value[n - 1] == '\n')
+        value[n - 1] = '\0';
+    return TRUE;
+}
+
+/* Helper: Does dir_fd have an entry called name */
+static gboolean sysfs_has(gint dir_fd, const gchar *name) {
+    struct stat st;
+    return fstatat(dir_fd, name, &st, 0) == 0;
+}
+
+/* Add or reclassify one block device from its sysfs directory */
+static XRGDiskDevice* register_sysfs_device(XRGDiskCollector *collector, gint dir_fd, const gchar *name,
+                                            XRGDiskType type, const gchar *parent) {
+    gchar dev[32];
+    guint major, minor;
+    if (!read_sysfs_attr(dir_fd, "dev", dev, sizeof(dev)) || sscanf(dev, "%u:%u", &major, &minor) != 2)
+        return NULL;
+
+    XRGDiskDevice *disk = lookup_device(collector, major, minor);
+    if (disk == NULL)
+        disk = add_device(collector, major, minor, name);
+    else if (strcmp(disk->name, name) != 0) {
+        /* Number reused by a different device */
+        g_strlcpy(disk->name, name, DISK_NAME_LEN);
+        disk->have_sample = FALSE;
+    }
+
+    disk->type = type;
+    g_strlcpy(disk->parent, parent ? parent : "", DISK_NAME_LEN);
+    g_strlcpy(disk->label, name, DISK_NAME_LEN);
+    if (type == XRG_DISK_TYPE_DM) {
+        gchar dm_name[DISK_NAME_LEN];
+        if (read_sysfs_attr(dir_fd, "dm/name", dm_name, sizeof(dm_name)) && dm_name[0])
+            g_strlcpy(disk->label, dm_name, DISK_NAME_LEN);
+    }
+    return disk;
+}
+
+/*
+ * Walk /sys/block. Each entry is a whole device: dm-* have a dm/
+ * directory, md arrays an md/ directory, and hardware disks a device
+ * link; loop, ram and zram have none of these. Partitions are the
+ * subdirectories that contain a "partition" attribute.
  */
-static gboolean is_whole_disk(const gchar *name) {
-    gint len = strlen(name);
-    if (len == 0)
+static void enumerate_devices(XRGDiskCollector *collector) {
+    DIR *dir = opendir(SYS_BLOCK);
+    if (dir == NULL)
+        return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        gint dev_fd = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dev_fd < 0)
+            continue;
+
+        XRGDiskType type = XRG_DISK_TYPE_OTHER;
+        if (sysfs_has(dev_fd, "dm"))
+            type = XRG_DISK_TYPE_DM;
+        else if (sysfs_has(dev_fd, "md"))
+            type = XRG_DISK_TYPE_MD;
+        else if (sysfs_has(dev_fd, "device"))
+            type = XRG_DISK_TYPE_DISK;
+
+        register_sysfs_device(collector, dev_fd, entry->d_name, type, NULL);
+
+        /* Partitions */
+        gint part_dir_fd = dup(dev_fd);
+        DIR *part_dir = part_dir_fd >= 0 ? fdopendir(part_dir_fd) : NULL;
+        if (part_dir) {
+            struct dirent *part;
+            while ((part = readdir(part_dir)) != NULL) {
+                if (part->d_type != DT_DIR || part->d_name[0] == '.')
+                    continue;
+
+                gint part_fd = openat(dev_fd, part->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (part_fd < 0)
+                    continue;
+                if (sysfs_has(part_fd, "partition"))
+                    register_sysfs_device(collector, part_fd, part->d_name, XRG_DISK_TYPE_PARTITION, entry->d_name);
+                close(part_fd);
+            }
+            closedir(part_dir);
+        } else if (part_dir_fd >= 0) {
+            close(part_dir_fd);
+        }
+
+        close(dev_fd);
+    }
+
+    closedir(dir);
+}
+
+/*============================================================================
+ * Sampling
+ *============================================================================*/
+
+/* Helper: Parse an unsigned decimal after optional spaces; NULL if there is none */
+static const gchar* parse_u64(const gchar *p, guint64 *value) {
+    while (*p == ' ')
+        p++;
+    if (*p < '0' || *p > '9')
+        return NULL;
+
+    guint64 v = 0;
+    while (*p >= '0' && *p <= '9')
+        v = v * 10 + (*p++ - '0');
+    *value = v;
+    return p;
+}
+
+/* Read the whole of /proc/diskstats into buf; returns FALSE on error */
+static gboolean read_diskstats(XRGDiskCollector *collector) {
+    if (collector->diskstats_fd < 0)
         return FALSE;
 
-    /* Check if last character is a digit - if so, likely a partition */
-    gchar last_char = name[len - 1];
+    gsize len = 0;
+    for (;;) {
+        if (len + 1 >= collector->buf_size) {
+            collector->buf_size *= 2;
+            collector->buf = g_realloc(collector->buf, collector->buf_size);
+        }
+        ssize_t n = pread(collector->diskstats_fd, collector->buf + len, collector->buf_size - len - 1, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return FALSE;
+        if (n == 0)
+            break;
+        len += n;
+    }
+    collector->buf[len] = '\0';
+    return TRUE;
+}
+
+/* Helper: Increase of a counter, 0 if it went backwards (reset) */
+static guint64 counter_delta(guint64 current, guint64 previous) {
+    return current >= previous ? current - previous : 0;
+}
 
-    /* Special handling for nvme devices (nvme0n1 is whole, nvme0n1p1 is partition) */
-    if (g_str_has_prefix(name, "nvme")) {
-        /* nvme0n1 is whole disk, nvme0n1p1 is partition */
-        return !strstr(name, "p");  /* Has 'p' means partition */
+/* Store a new sample for a device and derive its rates */
+static void record_sample(XRGDiskCollector *collector, XRGDiskDevice *disk,
+                          const guint64 fields[DISKSTATS_NUM_FIELDS], gdouble time_delta) {
+    /* First sighting: no previous sample, so a rate would wrongly
+     * count all I/O since boot as one interval */
+    if (disk->have_sample && time_delta > 0) {
+        guint64 read_delta = counter_delta(fields[DISKSTATS_SECTORS_READ], disk->sectors_read);
+        guint64 write_delta = counter_delta(fields[DISKSTATS_SECTORS_WRITTEN], disk->sectors_written);
+        guint64 reads = counter_delta(fields[DISKSTATS_READS], disk->reads_completed);
+        guint64 writes = counter_delta(fields[DISKSTATS_WRITES], disk->writes_completed);
+        guint64 read_ms = counter_delta(fields[DISKSTATS_TIME_READING], disk->time_reading);
+        guint64 write_ms = counter_delta(fields[DISKSTATS_TIME_WRITING], disk->time_writing);
+        gdouble interval_ms = time_delta * 1000.0;
+
+        disk->read_rate = (gdouble)(read_delta * SECTOR_SIZE) / time_delta;
+        disk->write_rate = (gdouble)(write_delta * SECTOR_SIZE) / time_delta;
+        disk->read_iops = reads / time_delta;
+        disk->write_iops = writes / time_delta;
+
+        /* Time fields are summed over I/Os, so divide by the I/Os completed */
+        disk->read_await = reads > 0 ? (gdouble)read_ms / reads : 0.0;
+        disk->write_await = writes > 0 ? (gdouble)write_ms / writes : 0.0;
+        disk->await = reads + writes > 0 ? (gdouble)(read_ms + write_ms) / (reads + writes) : 0.0;
+        disk->util = MIN(counter_delta(fields[DISKSTATS_IO_TICKS], disk->io_ticks) / interval_ms * 100.0, 100.0);
+        disk->queue_depth = counter_delta(fields[DISKSTATS_TIME_IN_QUEUE], disk->time_in_queue) / interval_ms;
+
+        xrg_dataset_add_value(disk->read_history, disk->read_rate / (1024.0 * 1024.0));
+        xrg_dataset_add_value(disk->write_history, disk->write_rate / (1024.0 * 1024.0));
+        load_history_add(&disk->load, disk->read_iops + disk->write_iops, disk->await,
+                         disk->util, disk->queue_depth);
+    } else {
+        disk->read_rate = 0.0;
+        disk->write_rate = 0.0;
+        disk->read_iops = disk->write_iops = 0.0;
+        disk->read_await = disk->write_await = disk->await = 0.0;
+        disk->util = 0.0;
+        disk->queue_depth = 0.0;
     }
 
-    /* md RAID arrays (md0, md127) are whole disks; md0p1 is a partition */
-    if (g_str_has_prefix(name, "md") && isdigit(name[2])) {
-        return !strstr(name + 2, "p");
+    disk->reads_completed = fields[DISKSTATS_READS];
+    disk->writes_completed = fields[DISKSTATS_WRITES];
+    disk->sectors_read = fields[DISKSTATS_SECTORS_READ];
+    disk->sectors_written = fields[DISKSTATS_SECTORS_WRITTEN];
+    disk->time_reading = fields[DISKSTATS_TIME_READING];
+    disk->time_writing = fields[DISKSTATS_TIME_WRITING];
+    disk->io_ticks = fields[DISKSTATS_IO_TICKS];
+    disk->time_in_queue = fields[DISKSTATS_TIME_IN_QUEUE];
+    disk->in_flight = fields[DISKSTATS_IN_FLIGHT];
+    disk->have_sample = TRUE;
+    disk->generation = collector->generation;
+}
+
+/*
+ * Parse /proc/diskstats:
+ *   major minor name reads reads_merged sectors_read time_reading writes ...
+ * Devices the table does not know trigger one walk of /sys/block.
+ */
+static void parse_diskstats(XRGDiskCollector *collector, gdouble time_delta) {
+    gboolean enumerated = FALSE;
+
+    for (const gchar *line = collector->buf; line && *line; ) {
+        const gchar *next = strchr(line, '\n');
+        if (next) next++;
+
+        guint64 major, minor;
+        const gchar *p = parse_u64(line, &major);
+        if (p) p = parse_u64(p, &minor);
+        if (p == NULL) {
+            line = next;
+            continue;
+        }
+
+        /* Device name */
+        while (*p == ' ')
+            p++;
+        const gchar *name = p;
+        while (*p && *p != ' ' && *p != '\n')
+            p++;
+        gsize name_len = MIN((gsize)(p - name), DISK_NAME_LEN - 1);
+
+        guint64 fields[DISKSTATS_NUM_FIELDS];
+        gint parsed = 0;
+        while (parsed < DISKSTATS_NUM_FIELDS && (p = parse_u64(p, &fields[parsed])) != NULL)
+            parsed++;
+
+        if (parsed == DISKSTATS_NUM_FIELDS && name_len > 0) {
+            XRGDiskDevice *disk = lookup_device(collector, major, minor);
+            if (disk == NULL && !enumerated) {
+                /* Hotplugged since the last walk */
+                enumerate_devices(collector);
+                enumerated = TRUE;
+                disk = lookup_device(collector, major, minor);
+            }
+            if (disk == NULL) {
+                /* Not in /sys/block (e.g. hidden); track it unclassified */
+                gchar dev_name[DISK_NAME_LEN];
+                memcpy(dev_name, name, name_len);
+                dev_name[name_len] = '\0';
+                disk = add_device(collector, major, minor, dev_name);
+            }
+            record_sample(collector, disk, fields, time_delta);
+        }
+
+        line = next;
     }
+}
+
+/* Drop devices that were not reported this update */
+static void sweep_devices(XRGDiskCollector *collector) {
+    for (guint i = collector->devices->len; i-- > 0; ) {
+        XRGDiskDevice *disk = g_ptr_array_index(collector->devices, i);
+        if (disk->generation == collector->generation)
+            continue;
 
-    /* For regular disks (sd*, vd*, hd*), check if ends with digit */
-    if (isdigit(last_char))
-        return FALSE;  /* Partition */
+        g_ptr_array_remove_index(collector->devices, i);
+        g_hash_table_remove(collector->by_dev, DEV_KEY(disk->major, disk->minor));  /* Frees it */
+    }
+}
 
-    return TRUE;  /* Whole disk */
+/* Helper: Can the device be the primary one (a whole disk or an array built on disks) */
+static gboolean is_primary_candidate(const XRGDiskDevice *disk) {
+    return disk->type == XRG_DISK_TYPE_DISK || disk->type == XRG_DISK_TYPE_DM ||
+           disk->type == XRG_DISK_TYPE_MD;
 }
 
 /**
- * Find primary disk device (first whole disk with activity)
+ * Find primary disk device (the busiest whole disk)
  */
-static gint find_primary_disk(XRGDiskCollector *collector) {
+static XRGDiskDevice* find_primary_disk(XRGDiskCollector *collector) {
     /* Prefer the whole disk with the highest current I/O rate, so the graph
      * follows the active device (e.g. an md RAID array under load) instead
      * of being pinned to whichever disk appears first in /proc/diskstats */
-    gint busiest = -1;
+    XRGDiskDevice *busiest = NULL;
     gdouble busiest_rate = 0.0;
-    for (gint i = 0; i < collector->num_devices; i++) {
-        DiskDevice *disk = &collector->devices[i];
+    for (guint i = 0; i < collector->devices->len; i++) {
+        XRGDiskDevice *disk = g_ptr_array_index(collector->devices, i);
 
-        if (!is_whole_disk(disk->name))
+        if (!is_primary_candidate(disk))
             continue;
 
         gdouble rate = disk->read_rate + disk->write_rate;
         if (rate > busiest_rate) {
             busiest_rate = rate;
-            busiest = i;
+            busiest = disk;
         }
     }
-    if (busiest >= 0)
+    if (busiest)
         return busiest;
 
     /* Idle system: keep the previous primary to avoid flapping */
-    if (collector->primary_device_idx >= 0 &&
-        collector->primary_device_idx < collector->num_devices &&
-        is_whole_disk(collector->devices[collector->primary_device_idx].name))
-        return collector->primary_device_idx;
-
-    /* Look for first whole disk with I/O activity */
-    for (gint i = 0; i < collector->num_devices; i++) {
-        DiskDevice *disk = &collector->devices[i];
-
-        if (!is_whole_disk(disk->name))
-            continue;
-
-        /* Check if disk has any activity */
-        if (disk->sectors_read > 0 || disk->sectors_written > 0) {
-            return i;
-        }
+    XRGDiskDevice *previous = collector->primary_key
+                              ? g_hash_table_lookup(collector->by_dev, collector->primary_key) : NULL;
+    if (previous)
+        return previous;
+
+    /* Look for first physical disk with I/O activity, then any candidate */
+    for (guint i = 0; i < collector->devices->len; i++) {
+        XRGDiskDevice *disk = g_ptr_array_index(collector->devices, i);
+        if (disk->type == XRG_DISK_TYPE_DISK && (disk->sectors_read > 0 || disk->sectors_written > 0))
+            return disk;
     }
-
-    /* Fallback to first whole disk */
-    for (gint i = 0; i < collector->num_devices; i++) {
-        if (is_whole_disk(collector->devices[i].name))
-            return i;
+    for (guint i = 0; i < collector->devices->len; i++) {
+        XRGDiskDevice *disk = g_ptr_array_index(collector->devices, i);
+        if (is_primary_candidate(disk))
+            return disk;
     }
 
-    return 0;  /* Last resort */
+    return NULL;
+}
+
+static XRGDiskDevice* get_primary(XRGDiskCollector *collector) {
+    return collector->primary_key ? g_hash_table_lookup(collector->by_dev, collector->primary_key) : NULL;
 }
 
 /**
@@ -95,13 +450,27 @@ static gint find_primary_disk(XRGDiskCollector *collector) {
 XRGDiskCollector* xrg_disk_collector_new(gint dataset_capacity) {
     XRGDiskCollector *collector = g_new0(XRGDiskCollector, 1);
 
+    collector->dataset_capacity = dataset_capacity;
+
     /* Create datasets */
     collector->read_rate = xrg_dataset_new(dataset_capacity);
     collector->write_rate = xrg_dataset_new(dataset_capacity);
+    collector->all_read_rate = xrg_dataset_new(dataset_capacity);
+    collector->all_write_rate = xrg_dataset_new(dataset_capacity);
+    load_history_init(&collector->primary_load, dataset_capacity);
+    load_history_init(&collector->all_load, dataset_capacity);
+
+    /* Device table (by_dev owns the entries) */
+    collector->devices = g_ptr_array_new();
+    collector->by_dev = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, disk_device_free);
 
-    /* Initialize */
-    collector->num_devices = 0;
-    collector->primary_device_idx = 0;
+    collector->diskstats_fd = open(PROC_DISKSTATS, O_RDONLY | O_CLOEXEC);
+    if (collector->diskstats_fd < 0)
+        g_warning("Failed to open %s", PROC_DISKSTATS);
+    collector->buf_size = DISKSTATS_BUFFER_SIZE;
+    collector->buf = g_malloc(collector->buf_size);
+
+    enumerate_devices(collector);
     collector->last_update_time = g_get_monotonic_time();
 
     /* Do initial read */
@@ -117,9 +486,20 @@ void xrg_disk_collector_free(XRGDiskCollector *collector) {
     if (collector == NULL)
         return;
 
+    if (collector->diskstats_fd >= 0)
+        close(collector->diskstats_fd);
+
+    g_ptr_array_free(collector->devices, TRUE);
+    g_hash_table_destroy(collector->by_dev);
+
     xrg_dataset_free(collector->read_rate);
     xrg_dataset_free(collector->write_rate);
+    xrg_dataset_free(collector->all_read_rate);
+    xrg_dataset_free(collector->all_write_rate);
+    load_history_free(&collector->primary_load);
+    load_history_free(&collector->all_load);
 
+    g_free(collector->buf);
     g_free(collector);
 }
 
@@ -133,84 +513,48 @@ void xrg_disk_collector_update(XRGDiskCollector *collector) {
     gint64 current_time = g_get_monotonic_time();
     gdouble time_delta = (current_time - collector->last_update_time) / 1000000.0;  /* seconds */
 
-    /* Read /proc/diskstats */
-    FILE *fp = fopen(PROC_DISKSTATS, "r");
-    if (fp == NULL) {
-        g_warning("Failed to open %s", PROC_DISKSTATS);
+    if (!read_diskstats(collector))
         return;
-    }
-
-    gchar line[256];
-    gint disk_idx = 0;
-
-    /* Parse disk lines */
-    while (fgets(line, sizeof(line), fp) && disk_idx < MAX_DISKS) {
-        DiskDevice *disk = &collector->devices[disk_idx];
-
-        /* Format: major minor device reads_completed reads_merged sectors_read time_reading
-                   writes_completed writes_merged sectors_written time_writing ... */
-        gint major, minor;
-        gchar device_name[DISK_NAME_LEN];
-        guint64 reads_completed, reads_merged, sectors_read, time_reading;
-        guint64 writes_completed, writes_merged, sectors_written, time_writing;
-
-        gint parsed = sscanf(line, "%d %d %31s %lu %lu %lu %lu %lu %lu %lu %lu",
-                           &major, &minor, device_name,
-                           &reads_completed, &reads_merged, &sectors_read, &time_reading,
-                           &writes_completed, &writes_merged, &sectors_written, &time_writing);
-
-        if (parsed >= 11) {
-            /* Only track whole disks, not partitions */
-            if (!is_whole_disk(device_name))
-                continue;
-
-            /* First sighting: no previous sample, so a rate would wrongly
-             * count all I/O since boot as one interval */
-            gboolean first_sight = !disk->active;
-
-            /* Save previous values */
-            disk->prev_sectors_read = disk->sectors_read;
-            disk->prev_sectors_written = disk->sectors_written;
-
-            /* Update current values */
-            g_strlcpy(disk->name, device_name, DISK_NAME_LEN);
-            disk->reads_completed = reads_completed;
-            disk->writes_completed = writes_completed;
-            disk->sectors_read = sectors_read;
-            disk->sectors_written = sectors_written;
-            disk->active = TRUE;
-
-            /* Calculate rates (bytes per second) */
-            if (time_delta > 0 && !first_sight) {
-                guint64 read_delta = disk->sectors_read - disk->prev_sectors_read;
-                guint64 write_delta = disk->sectors_written - disk->prev_sectors_written;
-
-                disk->read_rate = (gdouble)(read_delta * SECTOR_SIZE) / time_delta;
-                disk->write_rate = (gdouble)(write_delta * SECTOR_SIZE) / time_delta;
-            } else {
-                disk->read_rate = 0.0;
-                disk->write_rate = 0.0;
-            }
 
-            disk_idx++;
-        }
+    collector->generation++;
+    parse_diskstats(collector, time_delta);
+    sweep_devices(collector);
+
+    /* Aggregate over physical disks only: partitions, dm and md devices
+     * would count the same I/O again */
+    collector->all_read = 0.0;
+    collector->all_write = 0.0;
+    gdouble all_iops = 0.0, all_io_ms = 0.0, all_util = 0.0, all_queue_depth = 0.0;
+    for (guint i = 0; i < collector->devices->len; i++) {
+        XRGDiskDevice *disk = g_ptr_array_index(collector->devices, i);
+        if (disk->type != XRG_DISK_TYPE_DISK)
+            continue;
+        collector->all_read += disk->read_rate;
+        collector->all_write += disk->write_rate;
+
+        gdouble iops = disk->read_iops + disk->write_iops;
+        all_iops += iops;
+        all_io_ms += disk->await * iops;
+        all_util = MAX(all_util, disk->util);
+        all_queue_depth += disk->queue_depth;
     }
 
-    fclose(fp);
-    collector->num_devices = disk_idx;
-
     /* Identify primary disk */
-    collector->primary_device_idx = find_primary_disk(collector);
-
-    /* Store primary disk rates in datasets (convert to MB/s) */
-    if (collector->num_devices > 0 && time_delta > 0) {
-        DiskDevice *primary = &collector->devices[collector->primary_device_idx];
-
-        gdouble read_mbps = primary->read_rate / (1024.0 * 1024.0);
-        gdouble write_mbps = primary->write_rate / (1024.0 * 1024.0);
-
-        xrg_dataset_add_value(collector->read_rate, read_mbps);
-        xrg_dataset_add_value(collector->write_rate, write_mbps);
+    XRGDiskDevice *primary = find_primary_disk(collector);
+    collector->primary_key = primary ? DEV_KEY(primary->major, primary->minor) : NULL;
+
+    /* Store rates in datasets (convert to MB/s) */
+    if (primary && time_delta > 0) {
+        xrg_dataset_add_value(collector->read_rate, primary->read_rate / (1024.0 * 1024.0));
+        xrg_dataset_add_value(collector->write_rate, primary->write_rate / (1024.0 * 1024.0));
+        load_history_add(&collector->primary_load, primary->read_iops + primary->write_iops,
+                         primary->await, primary->util, primary->queue_depth);
+    }
+    if (time_delta > 0) {
+        xrg_dataset_add_value(collector->all_read_rate, collector->all_read / (1024.0 * 1024.0));
+        xrg_dataset_add_value(collector->all_write_rate, collector->all_write / (1024.0 * 1024.0));
+        load_history_add(&collector->all_load, all_iops, all_iops > 0 ? all_io_ms / all_iops : 0.0,
+                         all_util, all_queue_depth);
     }
 
     collector->last_update_time = current_time;
@@ -220,37 +564,71 @@ void xrg_disk_collector_update(XRGDiskCollector *collector) {
 
 const gchar* xrg_disk_collector_get_primary_device(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, "");
-    if (collector->num_devices == 0)
-        return "";
-    return collector->devices[collector->primary_device_idx].name;
+    XRGDiskDevice *primary = get_primary(collector);
+    return primary ? primary->label : "";
 }
 
 gdouble xrg_disk_collector_get_read_rate(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0.0);
-    if (collector->num_devices == 0)
-        return 0.0;
-    return collector->devices[collector->primary_device_idx].read_rate / (1024.0 * 1024.0);
+    XRGDiskDevice *primary = get_primary(collector);
+    return primary ? primary->read_rate / (1024.0 * 1024.0) : 0.0;
 }
 
 gdouble xrg_disk_collector_get_write_rate(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0.0);
-    if (collector->num_devices == 0)
-        return 0.0;
-    return collector->devices[collector->primary_device_idx].write_rate / (1024.0 * 1024.0);
+    XRGDiskDevice *primary = get_primary(collector);
+    return primary ? primary->write_rate / (1024.0 * 1024.0) : 0.0;
 }
 
 guint64 xrg_disk_collector_get_total_read(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0);
-    if (collector->num_devices == 0)
-        return 0;
-    return collector->devices[collector->primary_device_idx].sectors_read * SECTOR_SIZE;
+    XRGDiskDevice *primary = get_primary(collector);
+    return primary ? primary->sectors_read * SECTOR_SIZE : 0;
 }
 
 guint64 xrg_disk_collector_get_total_written(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0);
-    if (collector->num_devices == 0)
-        return 0;
-    return collector->devices[collector->primary_device_idx].sectors_written * SECTOR_SIZE;
+    XRGDiskDevice *primary = get_primary(collector);
+    return primary ? primary->sectors_written * SECTOR_SIZE : 0;
+}
+
+gdouble xrg_disk_collector_get_all_read_rate(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return collector->all_read / (1024.0 * 1024.0);
+}
+
+gdouble xrg_disk_collector_get_all_write_rate(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return collector->all_write / (1024.0 * 1024.0);
+}
+
+const XRGDiskLoadHistory* xrg_disk_collector_get_primary_load(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return &collector->primary_load;
+}
+
+const XRGDiskLoadHistory* xrg_disk_collector_get_all_load(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return &collector->all_load;
+}
+
+/* Device table */
+
+gint xrg_disk_collector_get_num_devices(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->devices->len;
+}
+
+const XRGDiskDevice* xrg_disk_collector_get_device(XRGDiskCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->devices->len)
+        return NULL;
+    return g_ptr_array_index(collector->devices, index);
+}
+
+const XRGDiskDevice* xrg_disk_collector_find_device(XRGDiskCollector *collector, guint major, guint minor) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return lookup_device(collector, major, minor);
 }
 
 /* Dataset access */
@@ -264,3 +642,13 @@ XRGDataset* xrg_disk_collector_get_write_dataset(XRGDiskCollector *collector) {
     g_return_val_if_fail(collector != NULL, NULL);
     return collector->write_rate;
 }
+
+XRGDataset* xrg_disk_collector_get_all_read_dataset(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->all_read_rate;
+}
+
+XRGDataset* xrg_disk_collector_get_all_write_dataset(XRGDiskCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->all_write_rate;
+}
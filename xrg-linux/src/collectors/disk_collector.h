@@ -8,42 +8,74 @@
  * XRGDiskCollector - Disk I/O data collector
  *
  * Collects disk statistics from /proc/diskstats for:
- * - Bytes read/written per device
- * - Read/write rates
- * - Total I/O activity
+ * - Bytes read/written per device, with rates and history
+ * - IOPS, await, %util and queue depth from the diskstats time fields
+ * - Read/write rates of the busiest disk
+ * - Aggregate rates over all physical disks
+ *
+ * Block devices are enumerated from /sys/block, which tells whole disks,
+ * partitions, device-mapper and md RAID devices apart, and are kept in a
+ * growable table keyed by major:minor. /sys/block is walked again only
+ * when /proc/diskstats reports a device the table does not know.
  */
 
-#define MAX_DISKS 32
 #define DISK_NAME_LEN 32
 
+typedef enum {
+    XRG_DISK_TYPE_DISK,         /* Whole disk backed by hardware (sda, nvme0n1, vda, mmcblk0) */
+    XRG_DISK_TYPE_PARTITION,    /* Partition of another device (sda1, nvme0n1p1) */
+    XRG_DISK_TYPE_DM,           /* Device-mapper (LVM, dm-crypt) */
+    XRG_DISK_TYPE_MD,           /* md RAID array */
+    XRG_DISK_TYPE_OTHER         /* loop, ram, zram and other virtual devices */
+} XRGDiskType;
+
+/* Latency and load history: one set per device, the busiest disk and all disks */
+typedef struct {
+    XRGDataset *iops;               /* Reads + writes completed per second */
+    XRGDataset *await;              /* ms per completed I/O, queueing included */
+    XRGDataset *util;               /* % of time with I/O in flight */
+    XRGDataset *queue_depth;        /* Average I/Os in flight */
+} XRGDiskLoadHistory;
+
 typedef struct {
-    gchar name[DISK_NAME_LEN];
+    guint major;
+    guint minor;
+    gchar name[DISK_NAME_LEN];      /* Kernel name, e.g. "dm-0" */
+    gchar label[DISK_NAME_LEN];     /* Device-mapper name ("vg-root"), else same as name */
+    gchar parent[DISK_NAME_LEN];    /* Whole disk of a partition, else empty */
+    XRGDiskType type;
+    guint generation;               /* Last update that saw this device */
+
+    /* Cumulative counters */
     guint64 reads_completed;
     guint64 writes_completed;
     guint64 sectors_read;
     guint64 sectors_written;
-    guint64 prev_sectors_read;
-    guint64 prev_sectors_written;
-    gdouble read_rate;   /* Bytes per second */
-    gdouble write_rate;  /* Bytes per second */
-    gboolean active;
-} DiskDevice;
-
-typedef struct _XRGDiskCollector XRGDiskCollector;
+    guint64 time_reading;           /* ms spent on reads */
+    guint64 time_writing;           /* ms spent on writes */
+    guint64 io_ticks;               /* ms with I/O in flight */
+    guint64 time_in_queue;          /* ms, weighted by I/Os in flight */
+    guint64 in_flight;              /* I/Os in flight now */
+    gboolean have_sample;           /* Counters above hold a previous sample */
 
-struct _XRGDiskCollector {
-    /* Disk devices */
-    DiskDevice devices[MAX_DISKS];
-    gint num_devices;
-    gint primary_device_idx;  /* Index of primary device */
+    /* Rates */
+    gdouble read_rate;              /* Bytes per second */
+    gdouble write_rate;             /* Bytes per second */
+    gdouble read_iops;
+    gdouble write_iops;
+    gdouble read_await;             /* ms per read */
+    gdouble write_await;            /* ms per write */
+    gdouble await;                  /* ms per I/O */
+    gdouble util;                   /* % busy; can read 100 while an SSD still has headroom */
+    gdouble queue_depth;
 
-    /* Datasets for graphing (primary device) */
-    XRGDataset *read_rate;    /* Read in MB/s */
-    XRGDataset *write_rate;   /* Write in MB/s */
+    /* History */
+    XRGDataset *read_history;       /* MB/s */
+    XRGDataset *write_history;      /* MB/s */
+    XRGDiskLoadHistory load;
+} XRGDiskDevice;
 
-    /* Update tracking */
-    gint64 last_update_time;
-};
+typedef struct _XRGDiskCollector XRGDiskCollector;
 
 /* Constructor and destructor */
 XRGDiskCollector* xrg_disk_collector_new(gint dataset_capacity);
@@ -52,15 +84,34 @@ void xrg_disk_collector_free(XRGDiskCollector *collector);
 /* Update methods */
 void xrg_disk_collector_update(XRGDiskCollector *collector);
 
-/* Getters */
+/* Getters (busiest disk) */
 const gchar* xrg_disk_collector_get_primary_device(XRGDiskCollector *collector);
 gdouble xrg_disk_collector_get_read_rate(XRGDiskCollector *collector);
 gdouble xrg_disk_collector_get_write_rate(XRGDiskCollector *collector);
 guint64 xrg_disk_collector_get_total_read(XRGDiskCollector *collector);
 guint64 xrg_disk_collector_get_total_written(XRGDiskCollector *collector);
 
+/* Aggregate over physical disks, in MB/s */
+gdouble xrg_disk_collector_get_all_read_rate(XRGDiskCollector *collector);
+gdouble xrg_disk_collector_get_all_write_rate(XRGDiskCollector *collector);
+
+/*
+ * Load history of the busiest disk and of all physical disks together
+ * (IOPS and queue depth summed, await weighted by I/Os, %util of the
+ * busiest member)
+ */
+const XRGDiskLoadHistory* xrg_disk_collector_get_primary_load(XRGDiskCollector *collector);
+const XRGDiskLoadHistory* xrg_disk_collector_get_all_load(XRGDiskCollector *collector);
+
+/* Device table, in discovery order; entries are valid until the next update */
+gint xrg_disk_collector_get_num_devices(XRGDiskCollector *collector);
+const XRGDiskDevice* xrg_disk_collector_get_device(XRGDiskCollector *collector, gint index);
+const XRGDiskDevice* xrg_disk_collector_find_device(XRGDiskCollector *collector, guint major, guint minor);
+
 /* Dataset access */
 XRGDataset* xrg_disk_collector_get_read_dataset(XRGDiskCollector *collector);
 XRGDataset* xrg_disk_collector_get_write_dataset(XRGDiskCollector *collector);
+XRGDataset* xrg_disk_collector_get_all_read_dataset(XRGDiskCollector *collector);
+XRGDataset* xrg_disk_collector_get_all_write_dataset(XRGDiskCollector *collector);
 
 #endif /* XRG_DISK_COLLECTOR_H */
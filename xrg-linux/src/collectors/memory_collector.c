@@ -1,20 +1,409 @@
 #include "memory_collector.h"
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
 
 #define PROC_MEMINFO "/proc/meminfo"
 #define PROC_VMSTAT "/proc/vmstat"
+#define SYS_NODE_PATH "/sys/devices/system/node"
+#define READ_BUFFER_SIZE 8192
+#define NODE_MEMINFO_HEAD 256   /* Enough for the MemTotal, MemFree and MemUsed lines */
+
+/* Key/value files, in counter order */
+typedef enum {
+    SOURCE_MEMINFO,     /* "MemTotal:       131886844 kB" */
+    SOURCE_VMSTAT,      /* "pgpgin 123456" */
+    NUM_SOURCES
+} CounterSource;
+
+static const gchar *source_paths[NUM_SOURCES] = { PROC_MEMINFO, PROC_VMSTAT };
+
+/* Counters the memory graph itself is drawn from */
+typedef enum {
+    KEY_MEM_TOTAL,
+    KEY_MEM_FREE,
+    KEY_MEM_AVAILABLE,
+    KEY_BUFFERS,
+    KEY_CACHED,
+    KEY_SLAB,
+    KEY_SWAP_TOTAL,
+    KEY_SWAP_FREE,
+    KEY_PGPGIN,
+    KEY_PGPGOUT,
+    NUM_KEYS
+} WellKnownKey;
+
+static const gchar *well_known_names[NUM_KEYS] = {
+    "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "Slab",
+    "SwapTotal", "SwapFree", "pgpgin", "pgpgout"
+};
+
+/* One line of a learned layout */
+typedef struct {
+    gchar *name;
+    guint key_len;              /* Checked on every read to catch a layout change */
+    guint64 scale;              /* 1024 for kB fields, else 1 */
+    gboolean cumulative;
+} CounterInfo;
+
+typedef struct {
+    gchar *name;
+    gint index;                 /* Counter slot; -1 while the kernel lacks it */
+    XRGDataset *history;
+} TrackedCounter;
+
+/* numastat lines the node view uses */
+typedef enum {
+    NUMASTAT_HIT,
+    NUMASTAT_MISS,
+    NUMASTAT_FOREIGN,
+    NUM_NUMASTAT
+} NumastatKey;
+
+static const gchar *numastat_names[NUM_NUMASTAT] = { "numa_hit", "numa_miss", "numa_foreign" };
+
+typedef struct {
+    XRGNumaNode info;
+    gint meminfo_fd;
+    gint numastat_fd;
+    guint64 numastat[NUM_NUMASTAT];
+    gboolean have_numastat;
+} NumaNode;
+
+struct _XRGMemoryCollector {
+    gint dataset_capacity;
+
+    /* Held files and the learned layout */
+    gint fds[NUM_SOURCES];
+    gint first_counter[NUM_SOURCES + 1];    /* Slot of each file's first line; last = count */
+    GArray *counters;                       /* CounterInfo, one per line */
+    GHashTable *index_by_name;              /* name -> slot + 1 */
+    gint known[NUM_KEYS];                   /* Slot of each well-known key, -1 if absent */
+    gchar *buf;
+    gsize buf_size;
+
+    /* Values per slot */
+    guint64 *values;
+    guint64 *prev_values;
+    gdouble *rates;
+    gboolean have_sample;
+
+    GPtrArray *tracked;                     /* TrackedCounter */
+    GPtrArray *numa_nodes;                  /* NumaNode, by id */
+
+    /* Memory totals (bytes) */
+    guint64 mem_total;
+    guint64 mem_available;
+    guint64 mem_used;  /* Calculated */
+
+    /* Swap (bytes) */
+    guint64 swap_total;
+    guint64 swap_used;  /* Calculated */
+
+    /* Datasets for graphing */
+    XRGDataset *used_memory;      /* App memory */
+    XRGDataset *wired_memory;     /* Kernel/buffers */
+    XRGDataset *cached_memory;    /* Cache */
+    XRGDataset *swap_memory;      /* Swap usage */
+    XRGDataset *page_activity;    /* Page in/out rate */
+
+    /* Update tracking */
+    gint64 last_update_time;
+};
+
+static void tracked_counter_free(gpointer data) {
+    TrackedCounter *tracked = data;
+    g_free(tracked->name);
+    xrg_dataset_free(tracked->history);
+    g_free(tracked);
+}
+
+static gssize read_held_file(XRGMemoryCollector *collector, gint fd) {
+    gsize len = 0;
+    for (;;) {
+        if (len + 1 >= collector->buf_size) {
+            collector->buf_size *= 2;
+            collector->buf = g_realloc(collector->buf, collector->buf_size);
+        }
+        ssize_t n = pread(fd, collector->buf + len, collector->buf_size - len - 1, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            break;
+        len += n;
+    }
+    collector->buf[len] = '\0';
+    return len;
+}
+
+/*============================================================================
+ * Layout
+ *============================================================================*/
+
+static void clear_layout(XRGMemoryCollector *collector) {
+    for (guint i = 0; i < collector->counters->len; i++)
+        g_free(g_array_index(collector->counters, CounterInfo, i).name);
+    g_array_set_size(collector->counters, 0);
+    g_hash_table_remove_all(collector->index_by_name);
+}
+
+/* Helper: Length of the key at p ("MemTotal:" or "pgpgin ") */
+static guint key_length(const gchar *p) {
+    const gchar *start = p;
+    while (*p && *p != ':' && *p != ' ' && *p != '\n')
+        p++;
+    return p - start;
+}
+
+/*
+ * Learn the key of every line in both files. Slots are assigned in file
+ * order, so a read only has to count lines to know where a value goes.
+ */
+static void learn_layout(XRGMemoryCollector *collector) {
+    clear_layout(collector);
+
+    for (gint source = 0; source < NUM_SOURCES; source++) {
+        collector->first_counter[source] = collector->counters->len;
+        if (collector->fds[source] < 0 || read_held_file(collector, collector->fds[source]) <= 0)
+            continue;
+
+        for (gchar *line = collector->buf; *line; ) {
+            gchar *end = strchr(line, '\n');
+            if (end) *end = '\0';
+
+            CounterInfo info = { 0 };
+            info.key_len = key_length(line);
+            if (info.key_len > 0) {
+                info.name = g_strndup(line, info.key_len);
+                info.scale = g_str_has_suffix(line, " kB") ? 1024 : 1;
+                info.cumulative = source == SOURCE_VMSTAT && !g_str_has_prefix(info.name, "nr_");
+                g_array_append_val(collector->counters, info);
+                g_hash_table_replace(collector->index_by_name, info.name,
+                                     GINT_TO_POINTER(collector->counters->len));
+            }
+
+            if (end == NULL)
+                break;
+            line = end + 1;
+        }
+    }
+    collector->first_counter[NUM_SOURCES] = collector->counters->len;
+
+    guint count = collector->counters->len;
+    collector->values = g_renew(guint64, collector->values, MAX(count, 1));
+    collector->prev_values = g_renew(guint64, collector->prev_values, MAX(count, 1));
+    collector->rates = g_renew(gdouble, collector->rates, MAX(count, 1));
+    memset(collector->values, 0, MAX(count, 1) * sizeof(guint64));
+    memset(collector->rates, 0, MAX(count, 1) * sizeof(gdouble));
+    collector->have_sample = FALSE;
+
+    for (gint key = 0; key < NUM_KEYS; key++)
+        collector->known[key] = xrg_memory_collector_find_counter(collector, well_known_names[key]);
+    for (guint i = 0; i < collector->tracked->len; i++) {
+        TrackedCounter *tracked = g_ptr_array_index(collector->tracked, i);
+        tracked->index = xrg_memory_collector_find_counter(collector, tracked->name);
+    }
+}
+
+/*
+ * Read one file into its slots. Returns FALSE if a line does not fit the
+ * learned layout (a key of another length, or the wrong number of lines).
+ */
+static gboolean read_source(XRGMemoryCollector *collector, gint source) {
+    if (collector->fds[source] < 0)
+        return TRUE;
+    if (read_held_file(collector, collector->fds[source]) <= 0)
+        return TRUE;    /* Keep the previous values */
+
+    gint slot = collector->first_counter[source];
+    gint end_slot = collector->first_counter[source + 1];
+    const CounterInfo *counters = (const CounterInfo *)collector->counters->data;
+
+    const gchar *p = collector->buf;
+    while (*p) {
+        if (slot >= end_slot || key_length(p) != counters[slot].key_len)
+            return FALSE;
+        p += counters[slot].key_len;
+        while (*p == ':' || *p == ' ')
+            p++;
+
+        guint64 value = 0;
+        while (*p >= '0' && *p <= '9')
+            value = value * 10 + (guint64)(*p++ - '0');
+        collector->values[slot] = value * counters[slot].scale;
+        slot++;
+
+        while (*p && *p != '\n')
+            p++;
+        if (*p == '\n')
+            p++;
+    }
+    return slot == end_slot;
+}
+
+/* Helper: Current value of a well-known counter, 0 if the kernel lacks it */
+static guint64 known_value(XRGMemoryCollector *collector, WellKnownKey key) {
+    return collector->known[key] >= 0 ? collector->values[collector->known[key]] : 0;
+}
+
+/*============================================================================
+ * NUMA Nodes
+ *============================================================================*/
+
+static void numa_node_free(gpointer data) {
+    NumaNode *node = data;
+    if (node->meminfo_fd >= 0)
+        close(node->meminfo_fd);
+    if (node->numastat_fd >= 0)
+        close(node->numastat_fd);
+    xrg_dataset_free(node->info.used_history);
+    xrg_dataset_free(node->info.miss_history);
+    g_free(node);
+}
+
+static gint compare_numa_nodes(gconstpointer a, gconstpointer b) {
+    const NumaNode *node_a = *(NumaNode * const *)a;
+    const NumaNode *node_b = *(NumaNode * const *)b;
+    return node_a->info.id - node_b->info.id;
+}
 
-/* Helper: Parse meminfo value in kB */
-static guint64 parse_meminfo_kb(const gchar *line) {
-    guint64 value = 0;
-    gchar unit[16] = {0};
+/* Find the nodeN directories and hold their meminfo and numastat open */
+static void discover_numa_nodes(XRGMemoryCollector *collector) {
+    DIR *dir = opendir(SYS_NODE_PATH);
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!g_str_has_prefix(entry->d_name, "node") || !g_ascii_isdigit(entry->d_name[4]))
+            continue;
+
+        gchar *meminfo_path = g_strdup_printf(SYS_NODE_PATH "/%s/meminfo", entry->d_name);
+        gchar *numastat_path = g_strdup_printf(SYS_NODE_PATH "/%s/numastat", entry->d_name);
+        gint meminfo_fd = open(meminfo_path, O_RDONLY | O_CLOEXEC);
+        gint numastat_fd = open(numastat_path, O_RDONLY | O_CLOEXEC);
+        g_free(meminfo_path);
+        g_free(numastat_path);
+        if (meminfo_fd < 0) {
+            if (numastat_fd >= 0)
+                close(numastat_fd);
+            continue;
+        }
+
+        NumaNode *node = g_new0(NumaNode, 1);
+        node->info.id = (gint)g_ascii_strtoll(entry->d_name + 4, NULL, 10);
+        node->info.used_history = xrg_dataset_new(collector->dataset_capacity);
+        node->info.miss_history = xrg_dataset_new(collector->dataset_capacity);
+        node->meminfo_fd = meminfo_fd;
+        node->numastat_fd = numastat_fd;
+        g_ptr_array_add(collector->numa_nodes, node);
+    }
+    closedir(dir);
+
+    g_ptr_array_sort(collector->numa_nodes, compare_numa_nodes);
+}
+
+/*
+ * Read the head of a node's meminfo:
+ *   Node 0 MemTotal:       65842148 kB
+ *   Node 0 MemFree:        12068320 kB
+ *   Node 0 MemUsed:        53773828 kB
+ * The three lines come first, so the rest of the file is never read.
+ */
+static void read_node_meminfo(NumaNode *node) {
+    gchar buf[NODE_MEMINFO_HEAD];
+    ssize_t len = pread(node->meminfo_fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0)
+        return;
+    buf[len] = '\0';
+
+    for (gchar *line = buf; line && *line; ) {
+        gchar *next = strchr(line, '\n');
+        if (next == NULL)
+            break;      /* Cut off by the buffer */
+        *next++ = '\0';
+
+        /* Skip "Node N " */
+        gchar *key = strchr(line, ' ');
+        key = key ? strchr(key + 1, ' ') : NULL;
+        if (key == NULL)
+            break;
+        key++;
+
+        guint64 *field = NULL;
+        if (g_str_has_prefix(key, "MemTotal:"))
+            field = &node->info.mem_total;
+        else if (g_str_has_prefix(key, "MemFree:"))
+            field = &node->info.mem_free;
+        else if (g_str_has_prefix(key, "MemUsed:"))
+            field = &node->info.mem_used;
+        if (field)
+            *field = g_ascii_strtoull(strchr(key, ':') + 1, NULL, 10) * 1024;
+        line = next;
+    }
+}
+
+static void read_node_numastat(NumaNode *node, gdouble time_delta) {
+    if (node->numastat_fd < 0)
+        return;
 
-    /* Format: "MemTotal:       131886844 kB" */
-    if (sscanf(line, "%*s %lu %15s", &value, unit) >= 1) {
-        return value * 1024;  /* Convert kB to bytes */
+    gchar buf[512];
+    ssize_t len = pread(node->numastat_fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0)
+        return;
+    buf[len] = '\0';
+
+    guint64 values[NUM_NUMASTAT];
+    memcpy(values, node->numastat, sizeof(values));
+    for (gchar *line = buf; line && *line; ) {
+        gchar *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        for (gint key = 0; key < NUM_NUMASTAT; key++) {
+            gsize name_len = strlen(numastat_names[key]);
+            if (strncmp(line, numastat_names[key], name_len) == 0 && line[name_len] == ' ') {
+                values[key] = g_ascii_strtoull(line + name_len + 1, NULL, 10);
+                break;
+            }
+        }
+        line = next;
+    }
+
+    /* Pages per second; a counter that went backwards gives 0 */
+    gdouble rates[NUM_NUMASTAT] = { 0.0 };
+    if (node->have_numastat && time_delta > 0) {
+        for (gint key = 0; key < NUM_NUMASTAT; key++) {
+            if (values[key] >= node->numastat[key])
+                rates[key] = (values[key] - node->numastat[key]) / time_delta;
+        }
+    }
+    node->info.hit_rate = rates[NUMASTAT_HIT];
+    node->info.miss_rate = rates[NUMASTAT_MISS];
+    node->info.foreign_rate = rates[NUMASTAT_FOREIGN];
+    memcpy(node->numastat, values, sizeof(values));
+    node->have_numastat = TRUE;
+}
+
+static void update_numa_nodes(XRGMemoryCollector *collector, gdouble time_delta) {
+    guint64 all_nodes_total = 0;
+    for (guint i = 0; i < collector->numa_nodes->len; i++) {
+        NumaNode *node = g_ptr_array_index(collector->numa_nodes, i);
+        read_node_meminfo(node);
+        read_node_numastat(node, time_delta);
+        all_nodes_total += node->info.mem_total;
+    }
+
+    for (guint i = 0; i < collector->numa_nodes->len; i++) {
+        NumaNode *node = g_ptr_array_index(collector->numa_nodes, i);
+        gdouble used_pct = all_nodes_total > 0 ? (gdouble)node->info.mem_used / all_nodes_total * 100.0 : 0.0;
+        xrg_dataset_add_value(node->info.used_history, used_pct);
+        xrg_dataset_add_value(node->info.miss_history, node->info.miss_rate + node->info.foreign_rate);
     }
-    return 0;
 }
 
 /**
@@ -23,6 +412,22 @@ static guint64 parse_meminfo_kb(const gchar *line) {
 XRGMemoryCollector* xrg_memory_collector_new(gint dataset_capacity) {
     XRGMemoryCollector *collector = g_new0(XRGMemoryCollector, 1);
 
+    collector->dataset_capacity = dataset_capacity;
+    collector->counters = g_array_new(FALSE, FALSE, sizeof(CounterInfo));
+    collector->index_by_name = g_hash_table_new(g_str_hash, g_str_equal);
+    collector->tracked = g_ptr_array_new_with_free_func(tracked_counter_free);
+    collector->numa_nodes = g_ptr_array_new_with_free_func(numa_node_free);
+    collector->buf_size = READ_BUFFER_SIZE;
+    collector->buf = g_malloc(collector->buf_size);
+
+    for (gint source = 0; source < NUM_SOURCES; source++) {
+        collector->fds[source] = open(source_paths[source], O_RDONLY | O_CLOEXEC);
+        if (collector->fds[source] < 0)
+            g_warning("Failed to open %s", source_paths[source]);
+    }
+    learn_layout(collector);
+    discover_numa_nodes(collector);
+
     /* Create datasets */
     collector->used_memory = xrg_dataset_new(dataset_capacity);
     collector->wired_memory = xrg_dataset_new(dataset_capacity);
@@ -46,6 +451,21 @@ void xrg_memory_collector_free(XRGMemoryCollector *collector) {
     if (collector == NULL)
         return;
 
+    for (gint source = 0; source < NUM_SOURCES; source++) {
+        if (collector->fds[source] >= 0)
+            close(collector->fds[source]);
+    }
+
+    clear_layout(collector);
+    g_array_free(collector->counters, TRUE);
+    g_hash_table_destroy(collector->index_by_name);
+    g_ptr_array_free(collector->tracked, TRUE);
+    g_ptr_array_free(collector->numa_nodes, TRUE);
+    g_free(collector->values);
+    g_free(collector->prev_values);
+    g_free(collector->rates);
+    g_free(collector->buf);
+
     xrg_dataset_free(collector->used_memory);
     xrg_dataset_free(collector->wired_memory);
     xrg_dataset_free(collector->cached_memory);
@@ -61,56 +481,42 @@ void xrg_memory_collector_free(XRGMemoryCollector *collector) {
 void xrg_memory_collector_update(XRGMemoryCollector *collector) {
     g_return_if_fail(collector != NULL);
 
-    /* Read /proc/meminfo */
-    FILE *fp = fopen(PROC_MEMINFO, "r");
-    if (fp == NULL) {
-        g_warning("Failed to open %s", PROC_MEMINFO);
+    if (collector->fds[SOURCE_MEMINFO] < 0)
         return;
-    }
 
-    gchar line[256];
-    while (fgets(line, sizeof(line), fp)) {
-        if (g_str_has_prefix(line, "MemTotal:")) {
-            collector->mem_total = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "MemFree:")) {
-            collector->mem_free = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "MemAvailable:")) {
-            collector->mem_available = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "Buffers:")) {
-            collector->mem_buffers = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "Cached:")) {
-            collector->mem_cached = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "Slab:")) {
-            collector->mem_slab = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "SwapTotal:")) {
-            collector->swap_total = parse_meminfo_kb(line);
-        } else if (g_str_has_prefix(line, "SwapFree:")) {
-            collector->swap_free = parse_meminfo_kb(line);
+    gint64 now = g_get_monotonic_time();
+    gdouble time_delta = (now - collector->last_update_time) / (gdouble)G_USEC_PER_SEC;
+    guint count = collector->counters->len;
+    memcpy(collector->prev_values, collector->values, MAX(count, 1) * sizeof(guint64));
+
+    /* A file that no longer fits its layout is learned again and re-read */
+    for (gint source = 0; source < NUM_SOURCES; source++) {
+        if (!read_source(collector, source)) {
+            learn_layout(collector);
+            count = collector->counters->len;
+            for (gint reread = 0; reread < NUM_SOURCES; reread++)
+                read_source(collector, reread);
+            break;
         }
     }
 
-    fclose(fp);
+    /* Rates of the event counters */
+    const CounterInfo *counters = (const CounterInfo *)collector->counters->data;
+    for (guint slot = 0; slot < count; slot++) {
+        if (!counters[slot].cumulative || !collector->have_sample || time_delta <= 0)
+            collector->rates[slot] = 0.0;
+        else if (collector->values[slot] >= collector->prev_values[slot])
+            collector->rates[slot] = (collector->values[slot] - collector->prev_values[slot]) / time_delta;
+        else
+            collector->rates[slot] = 0.0;   /* Wrapped or reset */
+    }
 
     /* Calculate used memory */
+    collector->mem_total = known_value(collector, KEY_MEM_TOTAL);
+    collector->mem_available = known_value(collector, KEY_MEM_AVAILABLE);
     collector->mem_used = collector->mem_total - collector->mem_available;
-    collector->swap_used = collector->swap_total - collector->swap_free;
-
-    /* Read /proc/vmstat for page activity */
-    fp = fopen(PROC_VMSTAT, "r");
-    if (fp != NULL) {
-        collector->prev_page_in = collector->page_in;
-        collector->prev_page_out = collector->page_out;
-
-        while (fgets(line, sizeof(line), fp)) {
-            if (g_str_has_prefix(line, "pgpgin ")) {
-                sscanf(line, "pgpgin %lu", &collector->page_in);
-            } else if (g_str_has_prefix(line, "pgpgout ")) {
-                sscanf(line, "pgpgout %lu", &collector->page_out);
-            }
-        }
-
-        fclose(fp);
-    }
+    collector->swap_total = known_value(collector, KEY_SWAP_TOTAL);
+    collector->swap_used = collector->swap_total - known_value(collector, KEY_SWAP_FREE);
 
     /* Calculate percentages and store in datasets */
     gdouble total_gb = collector->mem_total / (1024.0 * 1024.0 * 1024.0);
@@ -120,11 +526,12 @@ void xrg_memory_collector_update(XRGMemoryCollector *collector) {
     xrg_dataset_add_value(collector->used_memory, used_gb / total_gb * 100.0);
 
     /* Wired memory (buffers + slab) */
-    gdouble wired_gb = (collector->mem_buffers + collector->mem_slab) / (1024.0 * 1024.0 * 1024.0);
+    gdouble wired_gb = (known_value(collector, KEY_BUFFERS) + known_value(collector, KEY_SLAB)) /
+                       (1024.0 * 1024.0 * 1024.0);
     xrg_dataset_add_value(collector->wired_memory, wired_gb / total_gb * 100.0);
 
     /* Cached memory */
-    gdouble cached_gb = collector->mem_cached / (1024.0 * 1024.0 * 1024.0);
+    gdouble cached_gb = known_value(collector, KEY_CACHED) / (1024.0 * 1024.0 * 1024.0);
     xrg_dataset_add_value(collector->cached_memory, cached_gb / total_gb * 100.0);
 
     /* Swap usage */
@@ -136,11 +543,36 @@ void xrg_memory_collector_update(XRGMemoryCollector *collector) {
     }
 
     /* Page activity (delta) */
-    guint64 page_delta = (collector->page_in - collector->prev_page_in) +
-                         (collector->page_out - collector->prev_page_out);
+    guint64 page_delta = 0;
+    if (collector->have_sample) {
+        for (gint key = KEY_PGPGIN; key <= KEY_PGPGOUT; key++) {
+            gint slot = collector->known[key];
+            if (slot >= 0 && collector->values[slot] >= collector->prev_values[slot])
+                page_delta += collector->values[slot] - collector->prev_values[slot];
+        }
+    }
     xrg_dataset_add_value(collector->page_activity, (gdouble)page_delta);
 
-    collector->last_update_time = g_get_monotonic_time();
+    /* Tracked counters */
+    for (guint i = 0; i < collector->tracked->len; i++) {
+        TrackedCounter *tracked = g_ptr_array_index(collector->tracked, i);
+        gdouble value = 0.0;
+        if (tracked->index >= 0) {
+            const CounterInfo *info = &counters[tracked->index];
+            if (info->cumulative)
+                value = collector->rates[tracked->index];
+            else if (info->scale == 1024)
+                value = collector->values[tracked->index] / (1024.0 * 1024.0);
+            else
+                value = (gdouble)collector->values[tracked->index];
+        }
+        xrg_dataset_add_value(tracked->history, value);
+    }
+
+    update_numa_nodes(collector, time_delta);
+
+    collector->have_sample = TRUE;
+    collector->last_update_time = now;
 }
 
 /* Getters */
@@ -193,3 +625,106 @@ XRGDataset* xrg_memory_collector_get_swap_dataset(XRGMemoryCollector *collector)
     g_return_val_if_fail(collector != NULL, NULL);
     return collector->swap_memory;
 }
+
+/* Counters */
+
+gint xrg_memory_collector_get_num_counters(XRGMemoryCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->counters->len;
+}
+
+gint xrg_memory_collector_find_counter(XRGMemoryCollector *collector, const gchar *name) {
+    g_return_val_if_fail(collector != NULL && name != NULL, -1);
+    return GPOINTER_TO_INT(g_hash_table_lookup(collector->index_by_name, name)) - 1;
+}
+
+const gchar* xrg_memory_collector_get_counter_name(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->counters->len)
+        return NULL;
+    return g_array_index(collector->counters, CounterInfo, index).name;
+}
+
+gboolean xrg_memory_collector_counter_is_cumulative(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    if (index < 0 || index >= (gint)collector->counters->len)
+        return FALSE;
+    return g_array_index(collector->counters, CounterInfo, index).cumulative;
+}
+
+gboolean xrg_memory_collector_counter_is_bytes(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    if (index < 0 || index >= (gint)collector->counters->len)
+        return FALSE;
+    return g_array_index(collector->counters, CounterInfo, index).scale == 1024;
+}
+
+guint64 xrg_memory_collector_get_counter_value(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, 0);
+    if (index < 0 || index >= (gint)collector->counters->len)
+        return 0;
+    return collector->values[index];
+}
+
+gdouble xrg_memory_collector_get_counter_rate(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    if (index < 0 || index >= (gint)collector->counters->len)
+        return 0.0;
+    return collector->rates[index];
+}
+
+XRGDataset* xrg_memory_collector_get_counter_history(XRGMemoryCollector *collector, const gchar *name) {
+    g_return_val_if_fail(collector != NULL && name != NULL, NULL);
+
+    for (guint i = 0; i < collector->tracked->len; i++) {
+        TrackedCounter *tracked = g_ptr_array_index(collector->tracked, i);
+        if (strcmp(tracked->name, name) == 0)
+            return tracked->history;
+    }
+    return NULL;
+}
+
+XRGDataset* xrg_memory_collector_track_counter(XRGMemoryCollector *collector, const gchar *name) {
+    g_return_val_if_fail(collector != NULL && name != NULL, NULL);
+
+    XRGDataset *history = xrg_memory_collector_get_counter_history(collector, name);
+    if (history != NULL)
+        return history;
+
+    gint index = xrg_memory_collector_find_counter(collector, name);
+    if (index < 0)
+        return NULL;
+
+    TrackedCounter *tracked = g_new0(TrackedCounter, 1);
+    tracked->name = g_strdup(name);
+    tracked->index = index;
+    tracked->history = xrg_dataset_new(collector->dataset_capacity);
+    g_ptr_array_add(collector->tracked, tracked);
+    return tracked->history;
+}
+
+void xrg_memory_collector_untrack_counter(XRGMemoryCollector *collector, const gchar *name) {
+    g_return_if_fail(collector != NULL && name != NULL);
+
+    for (guint i = 0; i < collector->tracked->len; i++) {
+        TrackedCounter *tracked = g_ptr_array_index(collector->tracked, i);
+        if (strcmp(tracked->name, name) == 0) {
+            g_ptr_array_remove_index(collector->tracked, i);
+            return;
+        }
+    }
+}
+
+/* NUMA nodes */
+
+gint xrg_memory_collector_get_num_numa_nodes(XRGMemoryCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->numa_nodes->len;
+}
+
+const XRGNumaNode* xrg_memory_collector_get_numa_node(XRGMemoryCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->numa_nodes->len)
+        return NULL;
+    return &((NumaNode *)g_ptr_array_index(collector->numa_nodes, index))->info;
+}
@@ -12,41 +12,33 @@
  * - Used memory breakdown (apps, wired, compressed)
  * - Swap usage
  * - Page in/out activity
+ * - Any other meminfo or vmstat counter, with history on request
+ * - Per-NUMA-node memory and allocation counters, from
+ *   /sys/devices/system/node/nodeN/{meminfo,numastat}
+ *
+ * Both files are held open and the order of their keys is learned on the
+ * first read. Later reads walk the buffer line by line and store each
+ * value in its slot without comparing key names; the layout is learned
+ * again only if a line's key no longer has the expected length.
  */
 
-typedef struct _XRGMemoryCollector XRGMemoryCollector;
-
-struct _XRGMemoryCollector {
-    /* Memory totals (bytes) */
-    guint64 mem_total;
+typedef struct {
+    gint id;                    /* N of nodeN */
+    guint64 mem_total;          /* Bytes */
     guint64 mem_free;
-    guint64 mem_available;
-    guint64 mem_buffers;
-    guint64 mem_cached;
-    guint64 mem_slab;
-    guint64 mem_used;  /* Calculated */
+    guint64 mem_used;
 
-    /* Swap (bytes) */
-    guint64 swap_total;
-    guint64 swap_free;
-    guint64 swap_used;  /* Calculated */
+    /* numastat, pages per second */
+    gdouble hit_rate;           /* Allocated on this node as intended */
+    gdouble miss_rate;          /* Allocated here because the preferred node was short */
+    gdouble foreign_rate;       /* Meant for this node but allocated elsewhere */
 
-    /* Page activity */
-    guint64 page_in;
-    guint64 page_out;
-    guint64 prev_page_in;
-    guint64 prev_page_out;
+    /* History */
+    XRGDataset *used_history;   /* % of all nodes' memory, so the nodes stack to the total */
+    XRGDataset *miss_history;   /* miss + foreign pages/s */
+} XRGNumaNode;
 
-    /* Datasets for graphing */
-    XRGDataset *used_memory;      /* App memory */
-    XRGDataset *wired_memory;     /* Kernel/buffers */
-    XRGDataset *cached_memory;    /* Cache */
-    XRGDataset *swap_memory;      /* Swap usage */
-    XRGDataset *page_activity;    /* Page in/out rate */
-
-    /* Update tracking */
-    gint64 last_update_time;
-};
+typedef struct _XRGMemoryCollector XRGMemoryCollector;
 
 /* Constructor and destructor */
 XRGMemoryCollector* xrg_memory_collector_new(gint dataset_capacity);
@@ -68,4 +60,34 @@ XRGDataset* xrg_memory_collector_get_wired_dataset(XRGMemoryCollector *collector
 XRGDataset* xrg_memory_collector_get_cached_dataset(XRGMemoryCollector *collector);
 XRGDataset* xrg_memory_collector_get_swap_dataset(XRGMemoryCollector *collector);
 
+/*
+ * Every meminfo and vmstat counter, meminfo first, in file order. vmstat
+ * counters other than the nr_* gauges count events since boot and are
+ * "cumulative"; their rate is per second over the last update.
+ */
+gint xrg_memory_collector_get_num_counters(XRGMemoryCollector *collector);
+gint xrg_memory_collector_find_counter(XRGMemoryCollector *collector, const gchar *name);  /* -1 if absent */
+const gchar* xrg_memory_collector_get_counter_name(XRGMemoryCollector *collector, gint index);
+gboolean xrg_memory_collector_counter_is_cumulative(XRGMemoryCollector *collector, gint index);
+gboolean xrg_memory_collector_counter_is_bytes(XRGMemoryCollector *collector, gint index);  /* kB field */
+guint64 xrg_memory_collector_get_counter_value(XRGMemoryCollector *collector, gint index);  /* Bytes for kB fields */
+gdouble xrg_memory_collector_get_counter_rate(XRGMemoryCollector *collector, gint index);
+
+/*
+ * Keep history for a counter, starting with the next update: events per
+ * second if cumulative, MB for kB fields, the raw value otherwise. Tracking
+ * a counter twice returns the same dataset. NULL if the kernel has no
+ * counter by that name.
+ */
+XRGDataset* xrg_memory_collector_track_counter(XRGMemoryCollector *collector, const gchar *name);
+void xrg_memory_collector_untrack_counter(XRGMemoryCollector *collector, const gchar *name);
+XRGDataset* xrg_memory_collector_get_counter_history(XRGMemoryCollector *collector, const gchar *name);  /* NULL if untracked */
+
+/*
+ * NUMA nodes, by id. Nodes are found when the collector is created; a
+ * kernel without NUMA support still has node0.
+ */
+gint xrg_memory_collector_get_num_numa_nodes(XRGMemoryCollector *collector);
+const XRGNumaNode* xrg_memory_collector_get_numa_node(XRGMemoryCollector *collector, gint index);
+
 #endif /* XRG_MEMORY_COLLECTOR_H */
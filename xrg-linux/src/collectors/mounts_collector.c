@@ -0,0 +1,378 @@
+#include "mounts_collector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <sys/statvfs.h>
+
+#define PROC_MOUNTINFO "/proc/self/mountinfo"
+#define MOUNTINFO_BUFFER_SIZE (16 * 1024)
+#define FILL_TIME_CONSTANT_HOURS 1.0  /* Samples this old weigh 1/e in the fit */
+#define FILL_MIN_SAMPLES 6            /* Before a fill rate is reported */
+
+/* Filesystems with no capacity worth showing */
+static const gchar *pseudo_fs_types[] = {
+    "proc", "sysfs", "devtmpfs", "devpts", "tmpfs", "ramfs", "cgroup", "cgroup2",
+    "securityfs", "debugfs", "tracefs", "pstore", "bpf", "configfs", "fusectl",
+    "mqueue", "hugetlbfs", "autofs", "binfmt_misc", "rpc_pipefs", "nsfs",
+    "efivarfs", "selinuxfs", "squashfs", "overlay", "iso9660", "fuse.gvfsd-fuse", "fuse.portal",
+    NULL
+};
+
+/* Filesystems whose statvfs() may block on the network */
+static const gchar *remote_fs_types[] = {
+    "nfs", "nfs4", "cifs", "smb3", "smbfs", "ceph", "glusterfs", "9p",
+    "fuse.sshfs", "afs", "lustre",
+    NULL
+};
+
+struct _XRGMountsCollector {
+    gint dataset_capacity;
+
+    GPtrArray *mounts;              /* XRGMountInfo, in mountinfo order */
+    GHashTable *by_id;              /* mount_id -> XRGMountInfo (owns) */
+    guint generation;               /* Incremented every mountinfo parse */
+
+    gint mountinfo_fd;              /* Held open for poll(); -1 if unavailable */
+    gchar *buf;
+    gsize buf_size;
+
+    gint64 start_time;              /* Origin of the fill-rate fit, monotonic microseconds */
+    gint64 last_statvfs_time;
+};
+
+static void mount_info_free(gpointer data) {
+    XRGMountInfo *mount = data;
+
+    g_free(mount->mount_point);
+    g_free(mount->fs_type);
+    g_free(mount->source);
+    xrg_dataset_free(mount->used_history);
+    xrg_dataset_free(mount->free_history);
+    xrg_dataset_free(mount->inode_history);
+    g_free(mount);
+}
+
+/* Helper: Is name in a NULL-terminated list */
+static gboolean fs_type_in(const gchar *name, const gchar **list) {
+    for (gint i = 0; list[i]; i++) {
+        if (strcmp(name, list[i]) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*============================================================================
+ * Mount Table
+ *============================================================================*/
+
+/* Helper: Undo mountinfo's octal escapes (\040 for space) in place */
+static void unescape_mountinfo(gchar *s) {
+    gchar *out = s;
+    while (*s) {
+        if (s[0] == '\\' && s[1] >= '0' && s[1] <= '3' && s[2] >= '0' && s[2] <= '7' &&
+            s[3] >= '0' && s[3] <= '7') {
+            *out++ = (gchar)((s[1] - '0') * 64 + (s[2] - '0') * 8 + (s[3] - '0'));
+            s += 4;
+        } else {
+            *out++ = *s++;
+        }
+    }
+    *out = '\0';
+}
+
+/* Helper: Next space-separated field, NUL-terminated in place */
+static gchar* next_field(gchar **p) {
+    while (**p == ' ')
+        (*p)++;
+    if (**p == '\0')
+        return NULL;
+
+    gchar *field = *p;
+    while (**p && **p != ' ')
+        (*p)++;
+    if (**p)
+        *(*p)++ = '\0';
+    return field;
+}
+
+static gboolean read_mountinfo(XRGMountsCollector *collector) {
+    gsize len = 0;
+    for (;;) {
+        if (len + 1 >= collector->buf_size) {
+            collector->buf_size *= 2;
+            collector->buf = g_realloc(collector->buf, collector->buf_size);
+        }
+        ssize_t n = pread(collector->mountinfo_fd, collector->buf + len, collector->buf_size - len - 1, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return FALSE;
+        if (n == 0)
+            break;
+        len += n;
+    }
+    collector->buf[len] = '\0';
+    return TRUE;
+}
+
+/*
+ * Parse mountinfo into the table:
+ *   36 35 98:0 /root /mnt rw,noatime master:1 - ext4 /dev/sda1 rw
+ * (ID, parent ID, major:minor, root, mount point, options, optional
+ * fields up to "-", type, source, superblock options)
+ */
+static void parse_mountinfo(XRGMountsCollector *collector) {
+    if (!read_mountinfo(collector))
+        return;
+
+    collector->generation++;
+    GHashTable *seen_devs = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    gchar *line = collector->buf;
+    while (line && *line) {
+        gchar *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        gchar *p = line;
+        gchar *id = next_field(&p);
+        next_field(&p);                         /* Parent ID */
+        gchar *dev = next_field(&p);
+        next_field(&p);                         /* Root within the filesystem */
+        gchar *mount_point = next_field(&p);
+        gchar *field = next_field(&p);          /* Mount options */
+        while (field && strcmp(field, "-") != 0)
+            field = next_field(&p);             /* Optional fields */
+        gchar *fs_type = field ? next_field(&p) : NULL;
+        gchar *source = fs_type ? next_field(&p) : NULL;
+
+        guint major, minor;
+        line = next;
+        if (source == NULL || sscanf(dev, "%u:%u", &major, &minor) != 2)
+            continue;
+        if (fs_type_in(fs_type, pseudo_fs_types) || fs_type_in(fs_type, remote_fs_types))
+            continue;
+
+        /* Bind mounts and subvolumes report the same numbers again */
+        gpointer dev_key = GUINT_TO_POINTER((major << 20) | minor);
+        if (g_hash_table_contains(seen_devs, dev_key))
+            continue;
+        g_hash_table_add(seen_devs, dev_key);
+
+        gint mount_id = atoi(id);
+        unescape_mountinfo(mount_point);
+        XRGMountInfo *mount = g_hash_table_lookup(collector->by_id, GINT_TO_POINTER(mount_id));
+        if (mount && strcmp(mount->mount_point, mount_point) != 0) {
+            /* ID reused for another mount */
+            g_ptr_array_remove(collector->mounts, mount);
+            g_hash_table_remove(collector->by_id, GINT_TO_POINTER(mount_id));
+            mount = NULL;
+        }
+        if (mount == NULL) {
+            mount = g_new0(XRGMountInfo, 1);
+            mount->mount_id = mount_id;
+            mount->major = major;
+            mount->minor = minor;
+            mount->mount_point = g_strdup(mount_point);
+            mount->fs_type = g_strdup(fs_type);
+            unescape_mountinfo(source);
+            mount->source = g_strdup(source);
+            mount->hours_to_full = -1.0;
+            mount->used_history = xrg_dataset_new(collector->dataset_capacity);
+            mount->free_history = xrg_dataset_new(collector->dataset_capacity);
+            mount->inode_history = xrg_dataset_new(collector->dataset_capacity);
+            g_ptr_array_add(collector->mounts, mount);
+            g_hash_table_insert(collector->by_id, GINT_TO_POINTER(mount_id), mount);
+        }
+        mount->generation = collector->generation;
+    }
+
+    g_hash_table_destroy(seen_devs);
+
+    /* Drop unmounted filesystems */
+    for (guint i = collector->mounts->len; i-- > 0; ) {
+        XRGMountInfo *mount = g_ptr_array_index(collector->mounts, i);
+        if (mount->generation == collector->generation)
+            continue;
+        g_ptr_array_remove_index(collector->mounts, i);
+        g_hash_table_remove(collector->by_id, GINT_TO_POINTER(mount->mount_id));  /* Frees it */
+    }
+}
+
+/* Has the mount table changed since the last parse */
+static gboolean mountinfo_changed(XRGMountsCollector *collector) {
+    struct pollfd pfd = { .fd = collector->mountinfo_fd, .events = POLLPRI };
+    if (poll(&pfd, 1, 0) <= 0)
+        return FALSE;
+    return (pfd.revents & (POLLPRI | POLLERR)) != 0;
+}
+
+/*============================================================================
+ * Capacity Sampling
+ *============================================================================*/
+
+/*
+ * Add a (time, used bytes) point to the weighted least-squares fit. Old
+ * points decay by e^(-age / FILL_TIME_CONSTANT_HOURS), so the sums stay
+ * O(1) per sample and the slope follows the recent trend.
+ */
+static void update_fill_rate(XRGMountInfo *mount, gdouble hours, gdouble used) {
+    gdouble decay = mount->fit_samples > 0 ? exp(-(hours - mount->fit_last_hours) / FILL_TIME_CONSTANT_HOURS) : 1.0;
+    mount->fit_last_hours = hours;
+    mount->fit_w = mount->fit_w * decay + 1.0;
+    mount->fit_t = mount->fit_t * decay + hours;
+    mount->fit_y = mount->fit_y * decay + used;
+    mount->fit_tt = mount->fit_tt * decay + hours * hours;
+    mount->fit_ty = mount->fit_ty * decay + hours * used;
+    mount->fit_samples++;
+
+    gdouble denominator = mount->fit_w * mount->fit_tt - mount->fit_t * mount->fit_t;
+    if (mount->fit_samples < FILL_MIN_SAMPLES || denominator <= 1e-12) {
+        mount->fill_rate = 0.0;
+        mount->hours_to_full = -1.0;
+        return;
+    }
+
+    mount->fill_rate = (mount->fit_w * mount->fit_ty - mount->fit_t * mount->fit_y) / denominator;
+    mount->hours_to_full = mount->fill_rate > 0.0 ? mount->avail_bytes / mount->fill_rate : -1.0;
+}
+
+static void sample_mount(XRGMountInfo *mount, gint64 now, gint64 start_time) {
+    /* Stamped before the call, so a failing mount waits out the interval too */
+    mount->sampled_at = now;
+
+    struct statvfs st;
+    if (statvfs(mount->mount_point, &st) != 0 || st.f_blocks == 0)
+        return;
+
+    guint64 block_size = st.f_frsize ? st.f_frsize : st.f_bsize;
+    mount->total_bytes = (guint64)st.f_blocks * block_size;
+    mount->used_bytes = (guint64)(st.f_blocks - st.f_bfree) * block_size;
+    mount->avail_bytes = (guint64)st.f_bavail * block_size;
+    mount->total_inodes = st.f_files;
+    mount->used_inodes = st.f_files >= st.f_ffree ? st.f_files - st.f_ffree : 0;
+
+    /* Like df: reserved blocks count neither as used nor as available */
+    guint64 usable = mount->used_bytes + mount->avail_bytes;
+    mount->used_percent = usable > 0 ? (gdouble)mount->used_bytes / usable * 100.0 : 0.0;
+    mount->inode_percent = mount->total_inodes > 0
+                           ? (gdouble)mount->used_inodes / mount->total_inodes * 100.0 : 0.0;
+
+    gdouble hours = (now - start_time) / 3600e6;
+    update_fill_rate(mount, hours, (gdouble)mount->used_bytes);
+    mount->have_stats = TRUE;
+
+    xrg_dataset_add_value(mount->used_history, mount->used_bytes / (1024.0 * 1024.0 * 1024.0));
+    xrg_dataset_add_value(mount->free_history, mount->avail_bytes / (1024.0 * 1024.0 * 1024.0));
+    xrg_dataset_add_value(mount->inode_history, mount->inode_percent);
+}
+
+/**
+ * Create new mounts collector
+ */
+XRGMountsCollector* xrg_mounts_collector_new(gint dataset_capacity) {
+    XRGMountsCollector *collector = g_new0(XRGMountsCollector, 1);
+
+    collector->dataset_capacity = dataset_capacity;
+    collector->start_time = g_get_monotonic_time();
+    collector->mounts = g_ptr_array_new();
+    collector->by_id = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, mount_info_free);
+
+    collector->buf_size = MOUNTINFO_BUFFER_SIZE;
+    collector->buf = g_malloc(collector->buf_size);
+    collector->mountinfo_fd = open(PROC_MOUNTINFO, O_RDONLY | O_CLOEXEC);
+    if (collector->mountinfo_fd < 0)
+        g_warning("Failed to open %s", PROC_MOUNTINFO);
+    else
+        parse_mountinfo(collector);
+
+    /* Do initial read */
+    xrg_mounts_collector_update(collector);
+
+    return collector;
+}
+
+/**
+ * Free mounts collector
+ */
+void xrg_mounts_collector_free(XRGMountsCollector *collector) {
+    if (collector == NULL)
+        return;
+
+    if (collector->mountinfo_fd >= 0)
+        close(collector->mountinfo_fd);
+
+    g_ptr_array_free(collector->mounts, TRUE);
+    g_hash_table_destroy(collector->by_id);
+    g_free(collector->buf);
+    g_free(collector);
+}
+
+/**
+ * Update mounts: re-parse the table if it changed, then statvfs() every
+ * MOUNTS_STATVFS_INTERVAL seconds (new mounts right away)
+ */
+void xrg_mounts_collector_update(XRGMountsCollector *collector) {
+    g_return_if_fail(collector != NULL);
+
+    if (collector->mountinfo_fd < 0)
+        return;
+
+    if (mountinfo_changed(collector))
+        parse_mountinfo(collector);
+
+    gint64 now = g_get_monotonic_time();
+    if (collector->last_statvfs_time == 0)
+        collector->last_statvfs_time = now - MOUNTS_STATVFS_INTERVAL * G_USEC_PER_SEC;
+    gboolean interval_due = now - collector->last_statvfs_time >= MOUNTS_STATVFS_INTERVAL * G_USEC_PER_SEC;
+
+    for (guint i = 0; i < collector->mounts->len; i++) {
+        XRGMountInfo *mount = g_ptr_array_index(collector->mounts, i);
+        if (interval_due || mount->sampled_at == 0)
+            sample_mount(mount, now, collector->start_time);
+    }
+    if (interval_due)
+        collector->last_statvfs_time = now;
+}
+
+/* Getters */
+
+gint xrg_mounts_collector_get_num_mounts(XRGMountsCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->mounts->len;
+}
+
+const XRGMountInfo* xrg_mounts_collector_get_mount(XRGMountsCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->mounts->len)
+        return NULL;
+    return g_ptr_array_index(collector->mounts, index);
+}
+
+const XRGMountInfo* xrg_mounts_collector_get_fullest(XRGMountsCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+
+    const XRGMountInfo *fullest = NULL;
+    for (guint i = 0; i < collector->mounts->len; i++) {
+        const XRGMountInfo *mount = g_ptr_array_index(collector->mounts, i);
+        if (mount->have_stats && (fullest == NULL || mount->used_percent > fullest->used_percent))
+            fullest = mount;
+    }
+    return fullest;
+}
+
+const XRGMountInfo* xrg_mounts_collector_get_first_to_fill(XRGMountsCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+
+    const XRGMountInfo *first = NULL;
+    for (guint i = 0; i < collector->mounts->len; i++) {
+        const XRGMountInfo *mount = g_ptr_array_index(collector->mounts, i);
+        if (mount->hours_to_full >= 0.0 && (first == NULL || mount->hours_to_full < first->hours_to_full))
+            first = mount;
+    }
+    return first;
+}
@@ -0,0 +1,78 @@
+#ifndef XRG_MOUNTS_COLLECTOR_H
+#define XRG_MOUNTS_COLLECTOR_H
+
+#include <glib.h>
+#include "../core/dataset.h"
+
+/**
+ * XRGMountsCollector - Filesystem capacity and inode usage
+ *
+ * Keeps /proc/self/mountinfo open and parses it again only when poll()
+ * reports a change (POLLPRI), so the mount table costs nothing while it is
+ * stable. Each local filesystem is sampled with statvfs() every
+ * MOUNTS_STATVFS_INTERVAL seconds:
+ * - Used and free bytes, inode usage, with history
+ * - Fill rate from an exponentially weighted linear fit of used bytes,
+ *   and the hours left until the filesystem is full at that rate
+ *
+ * Pseudo filesystems (proc, sysfs, cgroup, tmpfs, ...) are skipped, as
+ * are remote ones (nfs, cifs, ...) whose statvfs() can block on an
+ * unreachable server. A filesystem mounted more than once is listed
+ * once, at its first mount point.
+ */
+
+#define MOUNTS_STATVFS_INTERVAL 10  /* Seconds between statvfs() samples */
+
+typedef struct {
+    gint mount_id;              /* From mountinfo; stable while mounted */
+    guint major;
+    guint minor;
+    gchar *mount_point;
+    gchar *fs_type;
+    gchar *source;              /* e.g. /dev/nvme0n1p2 */
+    guint generation;           /* Last mountinfo parse that listed it */
+
+    /* Latest statvfs() sample */
+    gboolean have_stats;
+    gint64 sampled_at;          /* Last attempt, monotonic microseconds; 0 = never */
+    guint64 total_bytes;
+    guint64 used_bytes;
+    guint64 avail_bytes;        /* Free to unprivileged users */
+    guint64 total_inodes;       /* 0 if the filesystem has no inode limit (btrfs) */
+    guint64 used_inodes;
+    gdouble used_percent;       /* Of what users can have, as df reports it */
+    gdouble inode_percent;
+
+    /* Fill-rate estimate */
+    gdouble fill_rate;          /* Bytes per hour, negative while shrinking */
+    gdouble hours_to_full;      /* < 0 if not filling or not known yet */
+
+    /* Weighted least-squares sums of (hours, used bytes) for the fit */
+    gdouble fit_w, fit_t, fit_y, fit_tt, fit_ty;
+    gdouble fit_last_hours;     /* Time of the newest point, for decay */
+    gint fit_samples;
+
+    /* History, one value per statvfs() sample */
+    XRGDataset *used_history;   /* GB */
+    XRGDataset *free_history;   /* GB available */
+    XRGDataset *inode_history;  /* % of inodes used */
+} XRGMountInfo;
+
+typedef struct _XRGMountsCollector XRGMountsCollector;
+
+/* Constructor and destructor */
+XRGMountsCollector* xrg_mounts_collector_new(gint dataset_capacity);
+void xrg_mounts_collector_free(XRGMountsCollector *collector);
+
+/* Update methods */
+void xrg_mounts_collector_update(XRGMountsCollector *collector);
+
+/* Mounts in mountinfo order; entries are valid until the next update */
+gint xrg_mounts_collector_get_num_mounts(XRGMountsCollector *collector);
+const XRGMountInfo* xrg_mounts_collector_get_mount(XRGMountsCollector *collector, gint index);
+
+/* Highest used_percent, and the one that will be full soonest; NULL if none */
+const XRGMountInfo* xrg_mounts_collector_get_fullest(XRGMountsCollector *collector);
+const XRGMountInfo* xrg_mounts_collector_get_first_to_fill(XRGMountsCollector *collector);
+
+#endif /* XRG_MOUNTS_COLLECTOR_H */
@@ -1,16 +1,800 @@
 #include "network_collector.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <ctype.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
 
 #define PROC_NET_DEV "/proc/net/dev"
+#define PROC_NET_SNMP "/proc/net/snmp"
+#define PROC_NET_NETSTAT "/proc/net/netstat"
+#define NETLINK_BUFFER_SIZE (32 * 1024)
+
+/*
+ * Protocol counters. Both files are pairs of lines, a header naming the
+ * fields and a line of values, each starting with the section name:
+ *   Tcp: RtoAlgorithm RtoMin ... RetransSegs ...
+ *   Tcp: 1 200 ... 42 ...
+ */
+typedef enum {
+    SNMP_FILE_SNMP,
+    SNMP_FILE_NETSTAT,
+    SNMP_NUM_FILES
+} SnmpFile;
+
+typedef struct {
+    SnmpFile file;
+    const gchar *section;
+    const gchar *field;
+} ProtocolCounterSpec;
+
+/* Indexed by XRGNetworkStat */
+static const ProtocolCounterSpec protocol_counters[XRG_NETWORK_NUM_STATS] = {
+    [XRG_NETWORK_STAT_RETRANSMITS]       = { SNMP_FILE_SNMP,    "Tcp",    "RetransSegs" },
+    [XRG_NETWORK_STAT_LISTEN_OVERFLOWS]  = { SNMP_FILE_NETSTAT, "TcpExt", "ListenOverflows" },
+    [XRG_NETWORK_STAT_SYN_DROPS]         = { SNMP_FILE_NETSTAT, "TcpExt", "ListenDrops" },
+    [XRG_NETWORK_STAT_UDP_RCVBUF_ERRORS] = { SNMP_FILE_SNMP,    "Udp",    "RcvbufErrors" },
+    [XRG_NETWORK_STAT_ACTIVE_OPENS]      = { SNMP_FILE_SNMP,    "Tcp",    "ActiveOpens" },
+    [XRG_NETWORK_STAT_PASSIVE_OPENS]     = { SNMP_FILE_SNMP,    "Tcp",    "PassiveOpens" },
+};
+
+static const gchar *protocol_counter_names[XRG_NETWORK_NUM_STATS] = {
+    [XRG_NETWORK_STAT_RETRANSMITS]       = "TCP retransmits",
+    [XRG_NETWORK_STAT_LISTEN_OVERFLOWS]  = "Listen overflows",
+    [XRG_NETWORK_STAT_SYN_DROPS]         = "SYN drops",
+    [XRG_NETWORK_STAT_UDP_RCVBUF_ERRORS] = "UDP rcvbuf errors",
+    [XRG_NETWORK_STAT_ACTIVE_OPENS]      = "TCP active opens",
+    [XRG_NETWORK_STAT_PASSIVE_OPENS]     = "TCP passive opens",
+};
+
+/* Where one wanted counter sits: the n-th line, the n-th value on it */
+typedef struct {
+    gint line;
+    gint column;
+    XRGNetworkStat stat;
+} SnmpColumn;
+
+/* One held-open counter file and its layout, learned on the first read */
+typedef struct {
+    gint fd;                        /* -1 if missing */
+    GArray *columns;                /* SnmpColumn, ordered by line then column; NULL until built */
+} SnmpSource;
+
+/* One interface's counters as read, before they are turned into rates */
+typedef struct {
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    guint64 rx_packets;
+    guint64 tx_packets;
+    guint64 rx_errors;
+    guint64 tx_errors;
+    guint64 rx_dropped;
+    guint64 tx_dropped;
+} InterfaceCounters;
+
+struct _XRGNetworkCollector {
+    gint dataset_capacity;
+
+    /* Interface table */
+    GPtrArray *interfaces;          /* XRGNetworkInterface, in discovery order */
+    GHashTable *by_index;           /* ifindex -> XRGNetworkInterface */
+    GHashTable *by_name;            /* name -> XRGNetworkInterface (for /proc/net/dev) */
+    GPtrArray *groups;              /* XRGNetworkGroup, in discovery order */
+    GHashTable *groups_by_name;     /* prefix -> XRGNetworkGroup */
+    gint primary_ifindex;           /* 0 if there are no interfaces */
+    guint generation;               /* Incremented every update */
+
+    /* Datasets for graphing (primary interface) */
+    XRGDataset *download_rate;      /* Download in MB/s */
+    XRGDataset *upload_rate;        /* Upload in MB/s */
+
+    /* rtnetlink: dumps on netlink_fd, notifications on events_fd (-1 if unavailable) */
+    gint netlink_fd;
+    gint events_fd;
+    guint32 netlink_seq;
+    gboolean use_stats_dump;        /* RTM_GETSTATS works; else /proc/net/dev */
+    gboolean resync_needed;         /* Notifications were lost or a default route went away */
+    gint default_ifindex4;          /* Preferred default route's interface, 0 if none */
+    gint default_ifindex6;
+    guint32 default_metric4;        /* Its RTA_PRIORITY; the lowest metric wins */
+    guint32 default_metric6;
+    gchar *buf;                     /* Netlink replies, or /proc/net/dev contents */
+    gsize buf_size;
+    gdouble time_delta;             /* Seconds since the previous update */
+
+    /* Protocol counters (TCP/UDP health) */
+    SnmpSource snmp_sources[SNMP_NUM_FILES];
+    guint64 stat_counters[XRG_NETWORK_NUM_STATS];
+    gboolean stat_found[XRG_NETWORK_NUM_STATS];
+    gboolean have_stats;            /* stat_counters hold a previous sample */
+    gdouble stat_rates[XRG_NETWORK_NUM_STATS];
+    XRGDataset *stat_datasets[XRG_NETWORK_NUM_STATS];   /* Events per second */
+
+    /* Update tracking */
+    gint64 last_update_time;
+};
+
+static void network_interface_free(gpointer data) {
+    XRGNetworkInterface *iface = data;
+
+    xrg_dataset_free(iface->packets);
+    xrg_dataset_free(iface->errors);
+    xrg_dataset_free(iface->drops);
+    g_free(iface);
+}
+
+static void network_group_free(gpointer data) {
+    XRGNetworkGroup *group = data;
+
+    xrg_dataset_free(group->download_rate);
+    xrg_dataset_free(group->upload_rate);
+    g_free(group);
+}
+
+static XRGNetworkInterface* lookup_interface(XRGNetworkCollector *collector, gint ifindex) {
+    return g_hash_table_lookup(collector->by_index, GINT_TO_POINTER(ifindex));
+}
+
+/* Add an interface to the table; name may be NULL to look it up by index */
+static XRGNetworkInterface* add_interface(XRGNetworkCollector *collector, gint ifindex, const gchar *name) {
+    gchar ifname[IF_NAMESIZE];
+    if (name == NULL) {
+        if (if_indextoname(ifindex, ifname) == NULL)
+            return NULL;
+        name = ifname;
+    }
+
+    XRGNetworkInterface *iface = g_new0(XRGNetworkInterface, 1);
+    iface->ifindex = ifindex;
+    g_strlcpy(iface->name, name, INTERFACE_NAME_LEN);
+    iface->packets = xrg_dataset_new(collector->dataset_capacity);
+    iface->errors = xrg_dataset_new(collector->dataset_capacity);
+    iface->drops = xrg_dataset_new(collector->dataset_capacity);
+
+    g_ptr_array_add(collector->interfaces, iface);
+    g_hash_table_insert(collector->by_index, GINT_TO_POINTER(ifindex), iface);
+    g_hash_table_insert(collector->by_name, iface->name, iface);
+    return iface;
+}
+
+/* Helper: Rate of a counter, 0 if it went backwards (reset) */
+static gdouble counter_rate(guint64 current, guint64 previous, gdouble time_delta) {
+    return current >= previous ? (current - previous) / time_delta : 0.0;
+}
+
+/* Store a new sample for an interface and derive its rates */
+static void record_sample(XRGNetworkCollector *collector, XRGNetworkInterface *iface,
+                          const InterfaceCounters *counters, gdouble time_delta) {
+    /* Already sampled by a stats dump that failed part way, before /proc/net/dev */
+    if (iface->have_sample && iface->generation == collector->generation)
+        return;
+
+    if (iface->have_sample && time_delta > 0) {
+        iface->rx_rate = counter_rate(counters->rx_bytes, iface->rx_bytes, time_delta);
+        iface->tx_rate = counter_rate(counters->tx_bytes, iface->tx_bytes, time_delta);
+        iface->packet_rate = counter_rate(counters->rx_packets, iface->rx_packets, time_delta) +
+                             counter_rate(counters->tx_packets, iface->tx_packets, time_delta);
+        iface->error_rate = counter_rate(counters->rx_errors, iface->rx_errors, time_delta) +
+                            counter_rate(counters->tx_errors, iface->tx_errors, time_delta);
+        iface->drop_rate = counter_rate(counters->rx_dropped, iface->rx_dropped, time_delta) +
+                           counter_rate(counters->tx_dropped, iface->tx_dropped, time_delta);
+
+        xrg_dataset_add_value(iface->packets, iface->packet_rate);
+        xrg_dataset_add_value(iface->errors, iface->error_rate);
+        xrg_dataset_add_value(iface->drops, iface->drop_rate);
+    }
+
+    iface->rx_bytes = counters->rx_bytes;
+    iface->tx_bytes = counters->tx_bytes;
+    iface->rx_packets = counters->rx_packets;
+    iface->tx_packets = counters->tx_packets;
+    iface->rx_errors = counters->rx_errors;
+    iface->tx_errors = counters->tx_errors;
+    iface->rx_dropped = counters->rx_dropped;
+    iface->tx_dropped = counters->tx_dropped;
+    iface->have_sample = TRUE;
+    iface->generation = collector->generation;
+}
+
+/* Drop an interface from the lookup tables and free it; the caller removes it from the array */
+static void forget_interface(XRGNetworkCollector *collector, XRGNetworkInterface *iface) {
+    if (g_hash_table_lookup(collector->by_name, iface->name) == iface)
+        g_hash_table_remove(collector->by_name, iface->name);
+    g_hash_table_remove(collector->by_index, GINT_TO_POINTER(iface->ifindex));  /* Frees it */
+}
+
+/* Take an interface out of the table */
+static void remove_interface(XRGNetworkCollector *collector, XRGNetworkInterface *iface) {
+    for (guint i = 0; i < collector->interfaces->len; i++) {
+        if (g_ptr_array_index(collector->interfaces, i) == iface) {
+            g_ptr_array_remove_index(collector->interfaces, i);
+            break;
+        }
+    }
+    forget_interface(collector, iface);
+}
+
+/* RTM_NEWSTATS: one interface's 64-bit counters */
+static void handle_stats(XRGNetworkCollector *collector, struct nlmsghdr *nl) {
+    struct if_stats_msg *ifsm = NLMSG_DATA(nl);
+    struct rtattr *rta = (struct rtattr *)((gchar *)ifsm + NLMSG_ALIGN(sizeof(*ifsm)));
+    gint rta_len = nl->nlmsg_len - NLMSG_LENGTH(sizeof(*ifsm));
+
+    for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+        if (rta->rta_type != IFLA_STATS_LINK_64)
+            continue;
+
+        /* Newer kernels append fields; copy what this build knows about */
+        struct rtnl_link_stats64 stats;
+        memset(&stats, 0, sizeof(stats));
+        memcpy(&stats, RTA_DATA(rta), MIN(RTA_PAYLOAD(rta), sizeof(stats)));
+
+        /* Normally known from link events; look the name up if one was missed */
+        XRGNetworkInterface *iface = lookup_interface(collector, ifsm->ifindex);
+        if (iface == NULL)
+            iface = add_interface(collector, ifsm->ifindex, NULL);
+        if (iface == NULL)
+            continue;
+
+        InterfaceCounters counters = {
+            .rx_bytes = stats.rx_bytes,
+            .tx_bytes = stats.tx_bytes,
+            .rx_packets = stats.rx_packets,
+            .tx_packets = stats.tx_packets,
+            .rx_errors = stats.rx_errors,
+            .tx_errors = stats.tx_errors,
+            .rx_dropped = stats.rx_dropped,
+            .tx_dropped = stats.tx_dropped,
+        };
+        record_sample(collector, iface, &counters, collector->time_delta);
+    }
+}
+
+/* RTM_NEWLINK / RTM_DELLINK: interface added, changed (rename, up/down) or removed */
+static void handle_link(XRGNetworkCollector *collector, struct nlmsghdr *nl) {
+    struct ifinfomsg *ifi = NLMSG_DATA(nl);
+    XRGNetworkInterface *iface = lookup_interface(collector, ifi->ifi_index);
+
+    /* Bridge port events (a port leaving a bridge) are about an interface that still exists */
+    if (ifi->ifi_family == AF_BRIDGE)
+        return;
+
+    if (nl->nlmsg_type == RTM_DELLINK) {
+        if (iface)
+            remove_interface(collector, iface);
+        return;
+    }
+
+    const gchar *name = NULL;
+    struct rtattr *rta = IFLA_RTA(ifi);
+    gint rta_len = IFLA_PAYLOAD(nl);
+    for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+        if (rta->rta_type == IFLA_IFNAME)
+            name = RTA_DATA(rta);
+    }
+
+    if (iface == NULL) {
+        iface = add_interface(collector, ifi->ifi_index, name);
+        if (iface == NULL)
+            return;
+    } else if (name && strcmp(iface->name, name) != 0) {
+        /* Renamed: same ifindex, so counters and history carry on */
+        if (g_hash_table_lookup(collector->by_name, iface->name) == iface)
+            g_hash_table_remove(collector->by_name, iface->name);
+        g_strlcpy(iface->name, name, INTERFACE_NAME_LEN);
+        g_hash_table_insert(collector->by_name, iface->name, iface);
+    }
+
+    iface->is_up = (ifi->ifi_flags & IFF_UP) != 0;
+    iface->is_running = (ifi->ifi_flags & IFF_RUNNING) != 0;
+}
+
+/* RTM_NEWROUTE / RTM_DELROUTE: track the main table's default routes */
+static void handle_route(XRGNetworkCollector *collector, struct nlmsghdr *nl) {
+    struct rtmsg *rtm = NLMSG_DATA(nl);
+    if (rtm->rtm_dst_len != 0 || rtm->rtm_table != RT_TABLE_MAIN || rtm->rtm_type != RTN_UNICAST)
+        return;
+
+    gint *default_ifindex;
+    guint32 *default_metric;
+    if (rtm->rtm_family == AF_INET) {
+        default_ifindex = &collector->default_ifindex4;
+        default_metric = &collector->default_metric4;
+    } else if (rtm->rtm_family == AF_INET6) {
+        default_ifindex = &collector->default_ifindex6;
+        default_metric = &collector->default_metric6;
+    } else {
+        return;
+    }
+
+    gint oif = 0;
+    guint32 metric = 0;
+    struct rtattr *rta = RTM_RTA(rtm);
+    gint rta_len = RTM_PAYLOAD(nl);
+    for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+        if (rta->rta_type == RTA_OIF) {
+            oif = *(guint32 *)RTA_DATA(rta);
+        } else if (rta->rta_type == RTA_PRIORITY) {
+            metric = *(guint32 *)RTA_DATA(rta);
+        } else if (rta->rta_type == RTA_MULTIPATH && oif == 0 &&
+                   RTA_PAYLOAD(rta) >= sizeof(struct rtnexthop)) {
+            oif = ((struct rtnexthop *)RTA_DATA(rta))->rtnh_ifindex;  /* First next hop */
+        }
+    }
+
+    if (nl->nlmsg_type == RTM_NEWROUTE) {
+        /* e.g. ethernet at metric 100 over wifi at 600, whatever order they arrive in */
+        if (oif > 0 && (*default_ifindex == 0 || *default_ifindex == oif || metric < *default_metric)) {
+            *default_ifindex = oif;
+            *default_metric = metric;
+        }
+    } else if (oif > 0 && *default_ifindex == oif) {
+        /* Another default route may remain; ask the kernel again */
+        *default_ifindex = 0;
+        collector->resync_needed = TRUE;
+    }
+}
+
+static void handle_rtnl_message(XRGNetworkCollector *collector, struct nlmsghdr *nl) {
+    switch (nl->nlmsg_type) {
+        case RTM_NEWSTATS:
+            handle_stats(collector, nl);
+            break;
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            handle_link(collector, nl);
+            break;
+        case RTM_NEWROUTE:
+        case RTM_DELROUTE:
+            handle_route(collector, nl);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Send a dump request on the request socket and handle every reply.
+ * Returns 0, or a negative errno: the kernel's answer in NLMSG_ERROR
+ * (-EOPNOTSUPP for RTM_GETSTATS before 4.7), or the socket's failure.
+ */
+static gint netlink_dump(XRGNetworkCollector *collector, guint16 type, const void *payload, gsize payload_len) {
+    struct {
+        struct nlmsghdr nl;
+        gchar payload[32];
+    } req;
+
+    g_return_val_if_fail(payload_len <= sizeof(req.payload), -EINVAL);
+
+    memset(&req, 0, sizeof(req));
+    req.nl.nlmsg_len = NLMSG_LENGTH(payload_len);
+    req.nl.nlmsg_type = type;
+    req.nl.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nl.nlmsg_seq = ++collector->netlink_seq;
+    memcpy(req.payload, payload, payload_len);
+
+    if (send(collector->netlink_fd, &req, req.nl.nlmsg_len, 0) < 0)
+        return -errno;
+
+    for (;;) {
+        ssize_t len = recv(collector->netlink_fd, collector->buf, collector->buf_size, 0);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            return -errno;
+        }
+
+        for (struct nlmsghdr *nl = (struct nlmsghdr *)collector->buf; NLMSG_OK(nl, (guint)len);
+             nl = NLMSG_NEXT(nl, len)) {
+            if (nl->nlmsg_seq != collector->netlink_seq)
+                continue;   /* Left over from an earlier, interrupted dump */
+            if (nl->nlmsg_type == NLMSG_DONE)
+                return 0;
+            if (nl->nlmsg_type == NLMSG_ERROR) {
+                if (nl->nlmsg_len < NLMSG_LENGTH(sizeof(struct nlmsgerr)))
+                    return -EIO;
+                gint error = ((struct nlmsgerr *)NLMSG_DATA(nl))->error;
+                return error < 0 ? error : -EIO;
+            }
+            handle_rtnl_message(collector, nl);
+        }
+    }
+}
+
+/* Read all interfaces' counters with one RTM_GETSTATS dump; 0 or a negative errno */
+static gint read_netlink_stats(XRGNetworkCollector *collector) {
+    struct if_stats_msg ifsm;
+    memset(&ifsm, 0, sizeof(ifsm));
+    ifsm.family = AF_UNSPEC;
+    ifsm.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+
+    return netlink_dump(collector, RTM_GETSTATS, &ifsm, sizeof(ifsm));
+}
+
+/* Rebuild names, flags and default routes from full dumps */
+static void resync_links(XRGNetworkCollector *collector) {
+    struct ifinfomsg ifi;
+    memset(&ifi, 0, sizeof(ifi));
+    ifi.ifi_family = AF_UNSPEC;
+    netlink_dump(collector, RTM_GETLINK, &ifi, sizeof(ifi));
+
+    struct rtmsg rtm;
+    memset(&rtm, 0, sizeof(rtm));
+    rtm.rtm_family = AF_UNSPEC;
+    collector->default_ifindex4 = collector->default_ifindex6 = 0;
+    netlink_dump(collector, RTM_GETROUTE, &rtm, sizeof(rtm));
+
+    collector->resync_needed = FALSE;
+}
+
+/* Apply link and route notifications queued since the last update */
+static void drain_link_events(XRGNetworkCollector *collector) {
+    if (collector->events_fd < 0)
+        return;
+
+    for (;;) {
+        ssize_t len = recv(collector->events_fd, collector->buf, collector->buf_size, MSG_DONTWAIT);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS) {
+                /* The kernel dropped notifications; the table may be stale */
+                collector->resync_needed = TRUE;
+                continue;
+            }
+            break;  /* EAGAIN: nothing more queued */
+        }
+
+        for (struct nlmsghdr *nl = (struct nlmsghdr *)collector->buf; NLMSG_OK(nl, (guint)len);
+             nl = NLMSG_NEXT(nl, len)) {
+            handle_rtnl_message(collector, nl);
+        }
+    }
+
+    if (collector->resync_needed)
+        resync_links(collector);
+}
+
+/* Subscribe to link and route notifications; -1 if netlink is unavailable */
+static gint open_link_events(void) {
+    gint fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0)
+        return -1;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Fallback: /proc/net/dev, "  eth0: rx_bytes rx_packets rx_errs rx_drop ... tx_bytes ..." */
+static gboolean read_proc_net_dev(XRGNetworkCollector *collector, gdouble time_delta) {
+    gint fd = open(PROC_NET_DEV, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        g_warning("Failed to open %s", PROC_NET_DEV);
+        return FALSE;
+    }
+
+    gsize len = 0;
+    for (;;) {
+        if (len + 1 >= collector->buf_size) {
+            collector->buf_size *= 2;
+            collector->buf = g_realloc(collector->buf, collector->buf_size);
+        }
+        ssize_t n = read(fd, collector->buf + len, collector->buf_size - len - 1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        len += n;
+    }
+    close(fd);
+    collector->buf[len] = '\0';
+
+    /* Skip the two header lines */
+    gchar *line = collector->buf;
+    for (gint i = 0; i < 2 && line; i++) {
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+
+    while (line && *line) {
+        gchar *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        while (*line == ' ') line++;
+        gchar *colon = strchr(line, ':');
+        if (colon == NULL) {
+            line = next;
+            continue;
+        }
+        *colon = '\0';
+
+        /* 16 counters: 8 receive, then 8 transmit */
+        guint64 values[16];
+        gchar *p = colon + 1;
+        gint fields = 0;
+        for (; fields < 16; fields++) {
+            gchar *end;
+            values[fields] = strtoull(p, &end, 10);
+            if (end == p) break;
+            p = end;
+        }
+
+        if (fields == 16) {
+            XRGNetworkInterface *iface = g_hash_table_lookup(collector->by_name, line);
+            if (iface == NULL) {
+                gint ifindex = if_nametoindex(line);
+                if (ifindex > 0 && lookup_interface(collector, ifindex) == NULL)
+                    iface = add_interface(collector, ifindex, line);
+            }
+
+            if (iface) {
+                InterfaceCounters counters = {
+                    .rx_bytes = values[0],
+                    .rx_packets = values[1],
+                    .rx_errors = values[2],
+                    .rx_dropped = values[3],
+                    .tx_bytes = values[8],
+                    .tx_packets = values[9],
+                    .tx_errors = values[10],
+                    .tx_dropped = values[11],
+                };
+                record_sample(collector, iface, &counters, time_delta);
+            }
+        }
+
+        line = next;
+    }
+
+    return TRUE;
+}
+
+/*============================================================================
+ * Protocol Counters
+ *============================================================================*/
+
+/* Read a whole held-open proc file into the shared buffer; returns its length, -1 on error */
+static gssize read_held_file(XRGNetworkCollector *collector, gint fd) {
+    gsize len = 0;
+    for (;;) {
+        if (len + 1 >= collector->buf_size) {
+            collector->buf_size *= 2;
+            collector->buf = g_realloc(collector->buf, collector->buf_size);
+        }
+        ssize_t n = pread(fd, collector->buf + len, collector->buf_size - len - 1, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            break;
+        len += n;
+    }
+    collector->buf[len] = '\0';
+    return len;
+}
+
+static gint compare_snmp_columns(gconstpointer a, gconstpointer b) {
+    const SnmpColumn *ca = a, *cb = b;
+    if (ca->line != cb->line)
+        return ca->line - cb->line;
+    return ca->column - cb->column;
+}
+
+/*
+ * Learn where the wanted counters of one file are: zip each header line
+ * with the values line after it and note the line and column of every
+ * field in the table. Lines can move: /proc/net/snmp prints its IcmpMsg
+ * pairs only once ICMP message types have been counted, and adds a pair
+ * per 16 types, pushing Tcp and Udp down. Reads check the section name
+ * on each stored line and learn the layout again if it moved.
+ */
+static void build_snmp_layout(SnmpSource *source, SnmpFile file, gchar *text) {
+    source->columns = g_array_new(FALSE, FALSE, sizeof(SnmpColumn));
+
+    gchar **lines = g_strsplit(text, "\n", -1);
+    for (gint line = 0; lines[line] && lines[line + 1]; line += 2) {
+        gchar **names = g_strsplit_set(lines[line], " ", -1);
+        gsize section_len = strlen(names[0]);
+        if (section_len == 0 || names[0][section_len - 1] != ':') {
+            g_strfreev(names);
+            break;
+        }
+        names[0][section_len - 1] = '\0';
+
+        for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++) {
+            const ProtocolCounterSpec *spec = &protocol_counters[stat];
+            if (spec->file != file || strcmp(spec->section, names[0]) != 0)
+                continue;
+            for (gint i = 1; names[i]; i++) {
+                if (strcmp(names[i], spec->field) == 0) {
+                    SnmpColumn column = { .line = line + 1, .column = i - 1, .stat = stat };
+                    g_array_append_val(source->columns, column);
+                    break;
+                }
+            }
+        }
+        g_strfreev(names);
+    }
+    g_strfreev(lines);
+
+    g_array_sort(source->columns, compare_snmp_columns);
+}
+
+/*
+ * Pull the wanted counters out of the buffer using the layout. Returns
+ * FALSE, leaving the rest unread, at a line whose section is not the one
+ * the layout expects there.
+ */
+static gboolean parse_snmp_columns(XRGNetworkCollector *collector, SnmpSource *source) {
+    const gchar *p = collector->buf;
+    gint line = 0;
+    for (guint i = 0; i < source->columns->len; i++) {
+        const SnmpColumn *column = &g_array_index(source->columns, SnmpColumn, i);
+
+        /* Skip to the line */
+        while (line < column->line && p) {
+            p = strchr(p, '\n');
+            if (p) p++;
+            line++;
+        }
+        if (p == NULL)
+            return FALSE;
+
+        const gchar *section = protocol_counters[column->stat].section;
+        gsize section_len = strlen(section);
+        if (strncmp(p, section, section_len) != 0 || p[section_len] != ':')
+            return FALSE;
+
+        /* Skip the section name and the values before the column */
+        const gchar *q = strchr(p, ' ');
+        for (gint c = 0; q && c < column->column; c++)
+            q = strchr(q + 1, ' ');
+        if (q == NULL)
+            continue;
+
+        collector->stat_counters[column->stat] = g_ascii_strtoull(q + 1, NULL, 10);
+        collector->stat_found[column->stat] = TRUE;
+    }
+    return TRUE;
+}
+
+static void read_snmp_source(XRGNetworkCollector *collector, SnmpSource *source, SnmpFile file) {
+    if (source->fd < 0)
+        return;
+    if (read_held_file(collector, source->fd) <= 0)
+        return;
+
+    if (source->columns && parse_snmp_columns(collector, source))
+        return;
+
+    /* First read, or the lines moved */
+    if (source->columns)
+        g_array_free(source->columns, TRUE);
+    build_snmp_layout(source, file, collector->buf);
+    parse_snmp_columns(collector, source);
+}
+
+static void update_protocol_stats(XRGNetworkCollector *collector, gdouble time_delta) {
+    guint64 previous[XRG_NETWORK_NUM_STATS];
+    memcpy(previous, collector->stat_counters, sizeof(previous));
+
+    for (gint file = 0; file < SNMP_NUM_FILES; file++)
+        read_snmp_source(collector, &collector->snmp_sources[file], file);
+
+    if (collector->have_stats && time_delta > 0) {
+        for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++) {
+            if (!collector->stat_found[stat])
+                continue;
+            collector->stat_rates[stat] = counter_rate(collector->stat_counters[stat], previous[stat], time_delta);
+            xrg_dataset_add_value(collector->stat_datasets[stat], collector->stat_rates[stat]);
+        }
+    }
+    collector->have_stats = TRUE;
+}
+
+/*
+ * Drop interfaces that were not reported this update. One compacting pass,
+ * so a sweep stays linear with hundreds of veths and the rest keep their order.
+ */
+static void sweep_interfaces(XRGNetworkCollector *collector) {
+    guint kept = 0;
+    for (guint i = 0; i < collector->interfaces->len; i++) {
+        XRGNetworkInterface *iface = g_ptr_array_index(collector->interfaces, i);
+        if (iface->generation == collector->generation)
+            collector->interfaces->pdata[kept++] = iface;
+        else
+            forget_interface(collector, iface);
+    }
+    g_ptr_array_set_size(collector->interfaces, kept);
+}
+
+/* Helper: Group name of an interface, its leading letters ("veth" for veth1a2b) */
+static void interface_group_name(const gchar *name, gchar group_name[INTERFACE_NAME_LEN]) {
+    gsize len = 0;
+    while (name[len] && isalpha((guchar)name[len]) && len < INTERFACE_NAME_LEN - 1)
+        len++;
+    if (len == 0)
+        len = MIN(strlen(name), INTERFACE_NAME_LEN - 1);
+
+    memcpy(group_name, name, len);
+    group_name[len] = '\0';
+}
+
+/* Sum interfaces into their groups; groups left without members are dropped */
+static void update_groups(XRGNetworkCollector *collector) {
+    for (guint i = 0; i < collector->groups->len; i++) {
+        XRGNetworkGroup *group = g_ptr_array_index(collector->groups, i);
+        group->num_interfaces = 0;
+        group->rx_rate = group->tx_rate = 0.0;
+        group->packet_rate = group->error_rate = group->drop_rate = 0.0;
+    }
+
+    for (guint i = 0; i < collector->interfaces->len; i++) {
+        XRGNetworkInterface *iface = g_ptr_array_index(collector->interfaces, i);
+
+        gchar group_name[INTERFACE_NAME_LEN];
+        interface_group_name(iface->name, group_name);
+
+        XRGNetworkGroup *group = g_hash_table_lookup(collector->groups_by_name, group_name);
+        if (group == NULL) {
+            group = g_new0(XRGNetworkGroup, 1);
+            g_strlcpy(group->name, group_name, INTERFACE_NAME_LEN);
+            group->download_rate = xrg_dataset_new(collector->dataset_capacity);
+            group->upload_rate = xrg_dataset_new(collector->dataset_capacity);
+            g_ptr_array_add(collector->groups, group);
+            g_hash_table_insert(collector->groups_by_name, group->name, group);
+        }
+
+        group->num_interfaces++;
+        group->generation = collector->generation;
+        group->rx_rate += iface->rx_rate;
+        group->tx_rate += iface->tx_rate;
+        group->packet_rate += iface->packet_rate;
+        group->error_rate += iface->error_rate;
+        group->drop_rate += iface->drop_rate;
+    }
+
+    for (guint i = collector->groups->len; i-- > 0; ) {
+        XRGNetworkGroup *group = g_ptr_array_index(collector->groups, i);
+        if (group->generation != collector->generation) {
+            g_ptr_array_remove_index(collector->groups, i);
+            g_hash_table_remove(collector->groups_by_name, group->name);  /* Frees it */
+            continue;
+        }
+
+        xrg_dataset_add_value(group->download_rate, group->rx_rate / (1024.0 * 1024.0));
+        xrg_dataset_add_value(group->upload_rate, group->tx_rate / (1024.0 * 1024.0));
+    }
+}
 
 /**
- * Find primary network interface (first non-loopback with traffic)
+ * Find primary network interface: the one the default route uses, or
+ * else the first non-loopback with traffic
  */
 static gint find_primary_interface(XRGNetworkCollector *collector) {
+    if (collector->default_ifindex4 > 0 && lookup_interface(collector, collector->default_ifindex4))
+        return collector->default_ifindex4;
+    if (collector->default_ifindex6 > 0 && lookup_interface(collector, collector->default_ifindex6))
+        return collector->default_ifindex6;
+
     /* Look for first active non-loopback interface with traffic */
-    for (gint i = 0; i < collector->num_interfaces; i++) {
-        NetworkInterface *iface = &collector->interfaces[i];
+    for (guint i = 0; i < collector->interfaces->len; i++) {
+        XRGNetworkInterface *iface = g_ptr_array_index(collector->interfaces, i);
 
         /* Skip loopback */
         if (g_str_has_prefix(iface->name, "lo"))
@@ -18,17 +802,25 @@ static gint find_primary_interface(XRGNetworkCollector *collector) {
 
         /* Check if interface has any traffic */
         if (iface->rx_bytes > 0 || iface->tx_bytes > 0) {
-            return i;
+            return iface->ifindex;
         }
     }
 
     /* Fallback to first non-loopback */
-    for (gint i = 0; i < collector->num_interfaces; i++) {
-        if (!g_str_has_prefix(collector->interfaces[i].name, "lo"))
-            return i;
+    for (guint i = 0; i < collector->interfaces->len; i++) {
+        XRGNetworkInterface *iface = g_ptr_array_index(collector->interfaces, i);
+        if (!g_str_has_prefix(iface->name, "lo"))
+            return iface->ifindex;
     }
 
-    return 0;  /* Last resort - use first interface */
+    /* Last resort - use first interface */
+    if (collector->interfaces->len > 0)
+        return ((XRGNetworkInterface *)g_ptr_array_index(collector->interfaces, 0))->ifindex;
+    return 0;
+}
+
+static XRGNetworkInterface* get_primary(XRGNetworkCollector *collector) {
+    return collector->primary_ifindex > 0 ? lookup_interface(collector, collector->primary_ifindex) : NULL;
 }
 
 /**
@@ -37,13 +829,34 @@ static gint find_primary_interface(XRGNetworkCollector *collector) {
 XRGNetworkCollector* xrg_network_collector_new(gint dataset_capacity) {
     XRGNetworkCollector *collector = g_new0(XRGNetworkCollector, 1);
 
+    collector->dataset_capacity = dataset_capacity;
+
     /* Create datasets */
     collector->download_rate = xrg_dataset_new(dataset_capacity);
     collector->upload_rate = xrg_dataset_new(dataset_capacity);
 
-    /* Initialize */
-    collector->num_interfaces = 0;
-    collector->primary_interface_idx = 0;
+    /* Interface table (by_index owns the entries) */
+    collector->interfaces = g_ptr_array_new();
+    collector->by_index = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, network_interface_free);
+    collector->by_name = g_hash_table_new(g_str_hash, g_str_equal);
+    collector->groups = g_ptr_array_new();
+    collector->groups_by_name = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, network_group_free);
+
+    collector->buf_size = NETLINK_BUFFER_SIZE;
+    collector->buf = g_malloc(collector->buf_size);
+
+    /* Protocol counters */
+    collector->snmp_sources[SNMP_FILE_SNMP].fd = open(PROC_NET_SNMP, O_RDONLY | O_CLOEXEC);
+    collector->snmp_sources[SNMP_FILE_NETSTAT].fd = open(PROC_NET_NETSTAT, O_RDONLY | O_CLOEXEC);
+    for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++)
+        collector->stat_datasets[stat] = xrg_dataset_new(dataset_capacity);
+
+    /* Subscribe before the first dump so no change falls in between */
+    collector->events_fd = open_link_events();
+    collector->netlink_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    collector->use_stats_dump = collector->netlink_fd >= 0;
+    if (collector->netlink_fd >= 0)
+        resync_links(collector);
     collector->last_update_time = g_get_monotonic_time();
 
     /* Do initial read */
@@ -59,9 +872,29 @@ void xrg_network_collector_free(XRGNetworkCollector *collector) {
     if (collector == NULL)
         return;
 
+    if (collector->netlink_fd >= 0)
+        close(collector->netlink_fd);
+    if (collector->events_fd >= 0)
+        close(collector->events_fd);
+    for (gint file = 0; file < SNMP_NUM_FILES; file++) {
+        if (collector->snmp_sources[file].fd >= 0)
+            close(collector->snmp_sources[file].fd);
+        if (collector->snmp_sources[file].columns)
+            g_array_free(collector->snmp_sources[file].columns, TRUE);
+    }
+    for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++)
+        xrg_dataset_free(collector->stat_datasets[stat]);
+
+    g_ptr_array_free(collector->interfaces, TRUE);
+    g_hash_table_destroy(collector->by_name);
+    g_hash_table_destroy(collector->by_index);
+    g_ptr_array_free(collector->groups, TRUE);
+    g_hash_table_destroy(collector->groups_by_name);
+
     xrg_dataset_free(collector->download_rate);
     xrg_dataset_free(collector->upload_rate);
 
+    g_free(collector->buf);
     g_free(collector);
 }
 
@@ -75,68 +908,34 @@ void xrg_network_collector_update(XRGNetworkCollector *collector) {
     gint64 current_time = g_get_monotonic_time();
     gdouble time_delta = (current_time - collector->last_update_time) / 1000000.0;  /* seconds */
 
-    /* Read /proc/net/dev */
-    FILE *fp = fopen(PROC_NET_DEV, "r");
-    if (fp == NULL) {
-        g_warning("Failed to open %s", PROC_NET_DEV);
-        return;
-    }
-
-    gchar line[256];
-    gint iface_idx = 0;
-
-    /* Skip header lines */
-    fgets(line, sizeof(line), fp);
-    fgets(line, sizeof(line), fp);
+    collector->generation++;
+    collector->time_delta = time_delta;
 
-    /* Parse interface lines */
-    while (fgets(line, sizeof(line), fp) && iface_idx < MAX_INTERFACES) {
-        NetworkInterface *iface = &collector->interfaces[iface_idx];
+    /* Interface and route changes arrive as notifications; polling is counters only */
+    drain_link_events(collector);
 
-        /* Parse line: "  eth0: 12345 67890 ... 98765 43210 ..." */
-        gchar iface_name[INTERFACE_NAME_LEN];
-        guint64 rx_bytes, rx_packets, rx_errs, rx_drop, rx_fifo, rx_frame, rx_compressed, rx_multicast;
-        guint64 tx_bytes, tx_packets, tx_errs, tx_drop, tx_fifo, tx_colls, tx_carrier, tx_compressed;
-
-        gint parsed = sscanf(line, " %31[^:]: %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
-                           iface_name,
-                           &rx_bytes, &rx_packets, &rx_errs, &rx_drop, &rx_fifo, &rx_frame, &rx_compressed, &rx_multicast,
-                           &tx_bytes, &tx_packets, &tx_errs, &tx_drop, &tx_fifo, &tx_colls, &tx_carrier, &tx_compressed);
-
-        if (parsed >= 9) {  /* At least interface name + RX + TX bytes */
-            /* Save previous values */
-            iface->prev_rx_bytes = iface->rx_bytes;
-            iface->prev_tx_bytes = iface->tx_bytes;
-
-            /* Update current values */
-            g_strlcpy(iface->name, iface_name, INTERFACE_NAME_LEN);
-            iface->rx_bytes = rx_bytes;
-            iface->tx_bytes = tx_bytes;
-            iface->active = TRUE;
-
-            /* Calculate rates (bytes per second) */
-            if (time_delta > 0) {
-                guint64 rx_delta = iface->rx_bytes - iface->prev_rx_bytes;
-                guint64 tx_delta = iface->tx_bytes - iface->prev_tx_bytes;
-
-                iface->rx_rate = (gdouble)rx_delta / time_delta;
-                iface->tx_rate = (gdouble)tx_delta / time_delta;
-            }
-
-            iface_idx++;
+    gboolean read_ok = FALSE;
+    if (collector->use_stats_dump) {
+        gint error = read_netlink_stats(collector);
+        read_ok = error == 0;
+        if (error == -EOPNOTSUPP || error == -EINVAL) {
+            /* The kernel has no RTM_GETSTATS; stay on /proc/net/dev from now on */
+            collector->use_stats_dump = FALSE;
         }
+        /* Anything else (ENOBUFS, a short reply) falls back for this update only */
     }
+    if (!read_ok && !read_proc_net_dev(collector, time_delta))
+        return;
 
-    fclose(fp);
-    collector->num_interfaces = iface_idx;
+    sweep_interfaces(collector);
+    update_groups(collector);
 
     /* Identify primary interface */
-    collector->primary_interface_idx = find_primary_interface(collector);
+    collector->primary_ifindex = find_primary_interface(collector);
 
     /* Store primary interface rates in datasets (convert to MB/s) */
-    if (collector->num_interfaces > 0 && time_delta > 0) {
-        NetworkInterface *primary = &collector->interfaces[collector->primary_interface_idx];
-
+    XRGNetworkInterface *primary = get_primary(collector);
+    if (primary && time_delta > 0) {
         gdouble download_mbps = primary->rx_rate / (1024.0 * 1024.0);
         gdouble upload_mbps = primary->tx_rate / (1024.0 * 1024.0);
 
@@ -144,6 +943,8 @@ void xrg_network_collector_update(XRGNetworkCollector *collector) {
         xrg_dataset_add_value(collector->upload_rate, upload_mbps);
     }
 
+    update_protocol_stats(collector, time_delta);
+
     collector->last_update_time = current_time;
 }
 
@@ -151,37 +952,68 @@ void xrg_network_collector_update(XRGNetworkCollector *collector) {
 
 const gchar* xrg_network_collector_get_primary_interface(XRGNetworkCollector *collector) {
     g_return_val_if_fail(collector != NULL, "");
-    if (collector->num_interfaces == 0)
-        return "";
-    return collector->interfaces[collector->primary_interface_idx].name;
+    XRGNetworkInterface *primary = get_primary(collector);
+    return primary ? primary->name : "";
 }
 
 gdouble xrg_network_collector_get_download_rate(XRGNetworkCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0.0);
-    if (collector->num_interfaces == 0)
-        return 0.0;
-    return collector->interfaces[collector->primary_interface_idx].rx_rate / (1024.0 * 1024.0);
+    XRGNetworkInterface *primary = get_primary(collector);
+    return primary ? primary->rx_rate / (1024.0 * 1024.0) : 0.0;
 }
 
 gdouble xrg_network_collector_get_upload_rate(XRGNetworkCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0.0);
-    if (collector->num_interfaces == 0)
-        return 0.0;
-    return collector->interfaces[collector->primary_interface_idx].tx_rate / (1024.0 * 1024.0);
+    XRGNetworkInterface *primary = get_primary(collector);
+    return primary ? primary->tx_rate / (1024.0 * 1024.0) : 0.0;
 }
 
 guint64 xrg_network_collector_get_total_rx(XRGNetworkCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0);
-    if (collector->num_interfaces == 0)
-        return 0;
-    return collector->interfaces[collector->primary_interface_idx].rx_bytes;
+    XRGNetworkInterface *primary = get_primary(collector);
+    return primary ? primary->rx_bytes : 0;
 }
 
 guint64 xrg_network_collector_get_total_tx(XRGNetworkCollector *collector) {
     g_return_val_if_fail(collector != NULL, 0);
-    if (collector->num_interfaces == 0)
-        return 0;
-    return collector->interfaces[collector->primary_interface_idx].tx_bytes;
+    XRGNetworkInterface *primary = get_primary(collector);
+    return primary ? primary->tx_bytes : 0;
+}
+
+gboolean xrg_network_collector_is_using_netlink(XRGNetworkCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    return collector->use_stats_dump;
+}
+
+/* Interface table */
+
+gint xrg_network_collector_get_num_interfaces(XRGNetworkCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->interfaces->len;
+}
+
+const XRGNetworkInterface* xrg_network_collector_get_interface(XRGNetworkCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->interfaces->len)
+        return NULL;
+    return g_ptr_array_index(collector->interfaces, index);
+}
+
+const XRGNetworkInterface* xrg_network_collector_find_interface(XRGNetworkCollector *collector, gint ifindex) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return lookup_interface(collector, ifindex);
+}
+
+gint xrg_network_collector_get_num_groups(XRGNetworkCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->groups->len;
+}
+
+const XRGNetworkGroup* xrg_network_collector_get_group(XRGNetworkCollector *collector, gint index) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    if (index < 0 || index >= (gint)collector->groups->len)
+        return NULL;
+    return g_ptr_array_index(collector->groups, index);
 }
 
 /* Dataset access */
@@ -195,3 +1027,28 @@ XRGDataset* xrg_network_collector_get_upload_dataset(XRGNetworkCollector *collec
     g_return_val_if_fail(collector != NULL, NULL);
     return collector->upload_rate;
 }
+
+/* Protocol counters */
+
+gboolean xrg_network_collector_has_stat(XRGNetworkCollector *collector, XRGNetworkStat stat) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    g_return_val_if_fail(stat >= 0 && stat < XRG_NETWORK_NUM_STATS, FALSE);
+    return collector->stat_found[stat];
+}
+
+gdouble xrg_network_collector_get_stat_rate(XRGNetworkCollector *collector, XRGNetworkStat stat) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    g_return_val_if_fail(stat >= 0 && stat < XRG_NETWORK_NUM_STATS, 0.0);
+    return collector->stat_rates[stat];
+}
+
+XRGDataset* xrg_network_collector_get_stat_dataset(XRGNetworkCollector *collector, XRGNetworkStat stat) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    g_return_val_if_fail(stat >= 0 && stat < XRG_NETWORK_NUM_STATS, NULL);
+    return collector->stat_datasets[stat];
+}
+
+const gchar* xrg_network_stat_get_name(XRGNetworkStat stat) {
+    g_return_val_if_fail(stat >= 0 && stat < XRG_NETWORK_NUM_STATS, "");
+    return protocol_counter_names[stat];
+}
@@ -7,41 +7,81 @@
 /**
  * XRGNetworkCollector - Network traffic data collector
  *
- * Collects network statistics from /proc/net/dev for:
- * - Bytes received/transmitted per interface
- * - Upload/download rates
- * - Total bandwidth usage
+ * Reads every interface's counters with one rtnetlink RTM_GETSTATS dump
+ * (64-bit link stats), or from /proc/net/dev on kernels without it:
+ * - Bytes, packets, errors and drops per interface, with rates
+ * - Upload/download rates of the primary interface
+ * - Interface groups by name prefix (all veth* combined, and so on)
+ * - TCP/UDP health rates from /proc/net/snmp and /proc/net/netstat
+ *
+ * Interfaces live in a growable table keyed by ifindex, so there is no
+ * limit on their number and an interface keeps its entry (and history)
+ * while others come and go. Additions, removals, renames and up/down
+ * changes arrive as RTNLGRP_LINK notifications, and the primary interface
+ * is the one the default route goes through.
  */
 
-#define MAX_INTERFACES 16
 #define INTERFACE_NAME_LEN 32
 
 typedef struct {
+    gint ifindex;
     gchar name[INTERFACE_NAME_LEN];
+    guint generation;           /* Last update that saw this interface */
+    gboolean is_up;             /* Administratively up (IFF_UP) */
+    gboolean is_running;        /* Operationally up (IFF_RUNNING) */
+
+    /* Cumulative counters */
     guint64 rx_bytes;
     guint64 tx_bytes;
-    guint64 prev_rx_bytes;
-    guint64 prev_tx_bytes;
-    gdouble rx_rate;  /* Bytes per second */
-    gdouble tx_rate;  /* Bytes per second */
-    gboolean active;
-} NetworkInterface;
+    guint64 rx_packets;
+    guint64 tx_packets;
+    guint64 rx_errors;
+    guint64 tx_errors;
+    guint64 rx_dropped;
+    guint64 tx_dropped;
+    gboolean have_sample;       /* Counters above hold a previous sample */
 
-typedef struct _XRGNetworkCollector XRGNetworkCollector;
+    /* Rates, per second */
+    gdouble rx_rate;            /* Bytes */
+    gdouble tx_rate;            /* Bytes */
+    gdouble packet_rate;        /* Received + transmitted */
+    gdouble error_rate;         /* Received + transmitted */
+    gdouble drop_rate;          /* Received + transmitted */
 
-struct _XRGNetworkCollector {
-    /* Network interfaces */
-    NetworkInterface interfaces[MAX_INTERFACES];
+    /* History */
+    XRGDataset *packets;        /* Packets per second */
+    XRGDataset *errors;         /* Errors per second */
+    XRGDataset *drops;          /* Drops per second */
+} XRGNetworkInterface;
+
+/* Interfaces sharing a name prefix, e.g. "veth" for veth1a2b3c */
+typedef struct {
+    gchar name[INTERFACE_NAME_LEN];
     gint num_interfaces;
-    gint primary_interface_idx;  /* Index of primary interface */
+    guint generation;           /* Last update with members */
 
-    /* Datasets for graphing (primary interface) */
-    XRGDataset *download_rate;   /* Download in MB/s */
-    XRGDataset *upload_rate;     /* Upload in MB/s */
+    gdouble rx_rate;            /* Bytes per second */
+    gdouble tx_rate;
+    gdouble packet_rate;
+    gdouble error_rate;
+    gdouble drop_rate;
 
-    /* Update tracking */
-    gint64 last_update_time;
-};
+    XRGDataset *download_rate;  /* MB/s */
+    XRGDataset *upload_rate;    /* MB/s */
+} XRGNetworkGroup;
+
+/* Protocol counters, reported as events per second */
+typedef enum {
+    XRG_NETWORK_STAT_RETRANSMITS,       /* TCP segments retransmitted */
+    XRG_NETWORK_STAT_LISTEN_OVERFLOWS,  /* Accept queue full */
+    XRG_NETWORK_STAT_SYN_DROPS,         /* SYNs dropped at listening sockets, any reason */
+    XRG_NETWORK_STAT_UDP_RCVBUF_ERRORS, /* Datagrams dropped, receive buffer full */
+    XRG_NETWORK_STAT_ACTIVE_OPENS,      /* Outgoing TCP connections */
+    XRG_NETWORK_STAT_PASSIVE_OPENS,     /* Accepted TCP connections */
+    XRG_NETWORK_NUM_STATS
+} XRGNetworkStat;
+
+typedef struct _XRGNetworkCollector XRGNetworkCollector;
 
 /* Constructor and destructor */
 XRGNetworkCollector* xrg_network_collector_new(gint dataset_capacity);
@@ -56,9 +96,25 @@ gdouble xrg_network_collector_get_download_rate(XRGNetworkCollector *collector);
 gdouble xrg_network_collector_get_upload_rate(XRGNetworkCollector *collector);
 guint64 xrg_network_collector_get_total_rx(XRGNetworkCollector *collector);
 guint64 xrg_network_collector_get_total_tx(XRGNetworkCollector *collector);
+gboolean xrg_network_collector_is_using_netlink(XRGNetworkCollector *collector);
+
+/* Interface table, in discovery order; entries are valid until the next update */
+gint xrg_network_collector_get_num_interfaces(XRGNetworkCollector *collector);
+const XRGNetworkInterface* xrg_network_collector_get_interface(XRGNetworkCollector *collector, gint index);
+const XRGNetworkInterface* xrg_network_collector_find_interface(XRGNetworkCollector *collector, gint ifindex);
+
+/* Interface groups, in discovery order */
+gint xrg_network_collector_get_num_groups(XRGNetworkCollector *collector);
+const XRGNetworkGroup* xrg_network_collector_get_group(XRGNetworkCollector *collector, gint index);
 
 /* Dataset access */
 XRGDataset* xrg_network_collector_get_download_dataset(XRGNetworkCollector *collector);
 XRGDataset* xrg_network_collector_get_upload_dataset(XRGNetworkCollector *collector);
 
+/* Protocol counters; has_stat is FALSE if the kernel does not report it */
+gboolean xrg_network_collector_has_stat(XRGNetworkCollector *collector, XRGNetworkStat stat);
+gdouble xrg_network_collector_get_stat_rate(XRGNetworkCollector *collector, XRGNetworkStat stat);
+XRGDataset* xrg_network_collector_get_stat_dataset(XRGNetworkCollector *collector, XRGNetworkStat stat);
+const gchar* xrg_network_stat_get_name(XRGNetworkStat stat);
+
 #endif /* XRG_NETWORK_COLLECTOR_H */
@@ -0,0 +1,340 @@
+#include "perf_collector.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* Group read layout: nr, time_enabled, time_running, then one value per member */
+#define GROUP_READ_HEADER 3
+
+static const struct {
+    guint32 type;
+    guint64 config;
+    const gchar *name;
+} event_specs[XRG_PERF_NUM_EVENTS] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,       "cycles" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,     "instructions" },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,     "cache-misses" },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context-switches" },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS,   "cpu-migrations" },
+};
+
+/* One CPU's event group */
+typedef struct {
+    gint cpu;
+    gint fds[XRG_PERF_NUM_EVENTS];          /* -1 if not in the group; the first open fd leads */
+    gint slot[XRG_PERF_NUM_EVENTS];         /* Position in the group read, -1 if absent */
+    gint leader_fd;
+    guint64 prev_values[XRG_PERF_NUM_EVENTS];
+    guint64 prev_enabled;
+    guint64 prev_running;
+    gboolean have_sample;
+} PerfGroup;
+
+struct _XRGPerfCollector {
+    gint dataset_capacity;
+
+    GArray *groups;                         /* PerfGroup, one per CPU that opened */
+    gboolean hardware;                      /* Groups are led by cycles */
+    gboolean has_event[XRG_PERF_NUM_EVENTS];
+    gchar *error;
+    guint64 read_buf[GROUP_READ_HEADER + XRG_PERF_NUM_EVENTS];
+
+    /* Latest values, all CPUs */
+    gdouble rates[XRG_PERF_NUM_EVENTS];
+    gdouble ipc;
+    gdouble mpki;
+
+    /* Datasets for graphing */
+    XRGDataset *ipc_history;
+    XRGDataset *mpki_history;
+    XRGDataset *context_switch_history;
+    XRGDataset *migration_history;
+
+    gint64 last_update_time;
+};
+
+/*============================================================================
+ * Event Groups
+ *============================================================================*/
+
+static gint perf_event_open(struct perf_event_attr *attr, gint cpu, gint group_fd) {
+    /* pid -1 with a cpu counts everything that runs on that CPU */
+    return (gint)syscall(SYS_perf_event_open, attr, -1, cpu, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static gint open_event(XRGPerfEvent event, gint cpu, gint group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event_specs[event].type;
+    attr.config = event_specs[event].config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = group_fd < 0;   /* The leader starts the whole group once it is built */
+    return perf_event_open(&attr, cpu, group_fd);
+}
+
+static void close_group(PerfGroup *group) {
+    for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++) {
+        if (group->fds[e] >= 0)
+            close(group->fds[e]);
+        group->fds[e] = -1;
+    }
+}
+
+/*
+ * Open cpu's group: cycles leads with the other events as members, or in
+ * software mode context-switches leads. A member the CPU does not support
+ * is left out. Returns 0, or the errno of the leader.
+ */
+static gint open_group(PerfGroup *group, gint cpu, gboolean hardware, gchar **error) {
+    memset(group, 0, sizeof(*group));
+    group->cpu = cpu;
+    group->leader_fd = -1;
+    for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++) {
+        group->fds[e] = -1;
+        group->slot[e] = -1;
+    }
+
+    gint first = hardware ? XRG_PERF_CYCLES : XRG_PERF_CONTEXT_SWITCHES;
+    gint members = 0;
+    for (gint e = first; e < XRG_PERF_NUM_EVENTS; e++) {
+        gint fd = open_event(e, cpu, group->leader_fd);
+        if (fd < 0) {
+            if (group->leader_fd < 0)
+                return errno;
+            if (*error == NULL)
+                *error = g_strdup_printf("%s: %s", event_specs[e].name, strerror(errno));
+            continue;
+        }
+        if (group->leader_fd < 0)
+            group->leader_fd = fd;
+        group->fds[e] = fd;
+        group->slot[e] = members++;
+    }
+
+    ioctl(group->leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group->leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return 0;
+}
+
+static void open_groups(XRGPerfCollector *collector) {
+    gint num_cpus = (gint)sysconf(_SC_NPROCESSORS_CONF);
+    gint last_err = 0;
+    collector->hardware = TRUE;
+
+    for (gint cpu = 0; cpu < num_cpus; cpu++) {
+        PerfGroup group;
+        gint err = open_group(&group, cpu, collector->hardware, &collector->error);
+        if (err == 0) {
+            g_array_append_val(collector->groups, group);
+            continue;
+        }
+        if (err == ENODEV)
+            continue;   /* Offline CPU */
+
+        if (collector->hardware && collector->groups->len == 0) {
+            /* No PMU, or not allowed to use it: try again with software events only */
+            g_free(collector->error);
+            collector->error = g_strdup_printf("%s: %s", event_specs[XRG_PERF_CYCLES].name, strerror(err));
+            collector->hardware = FALSE;
+            cpu--;
+            continue;
+        }
+        last_err = err;
+    }
+
+    if (collector->groups->len == 0 && last_err != 0) {
+        g_free(collector->error);
+        collector->error = g_strdup_printf("%s: %s", event_specs[XRG_PERF_CONTEXT_SWITCHES].name,
+                                           strerror(last_err));
+    }
+
+    for (guint i = 0; i < collector->groups->len; i++) {
+        PerfGroup *group = &g_array_index(collector->groups, PerfGroup, i);
+        for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++) {
+            if (group->slot[e] >= 0)
+                collector->has_event[e] = TRUE;
+        }
+    }
+}
+
+/*
+ * Read one group and add its counts since the last read to totals,
+ * scaled up for the time the group was multiplexed off the PMU
+ */
+static void read_group(XRGPerfCollector *collector, PerfGroup *group, gdouble *totals) {
+    ssize_t len = read(group->leader_fd, collector->read_buf, sizeof(collector->read_buf));
+    if (len < (ssize_t)(GROUP_READ_HEADER * sizeof(guint64)))
+        return;
+
+    guint64 nr = collector->read_buf[0];
+    guint64 enabled = collector->read_buf[1];
+    guint64 running = collector->read_buf[2];
+    const guint64 *values = collector->read_buf + GROUP_READ_HEADER;
+    if ((gsize)len < (GROUP_READ_HEADER + nr) * sizeof(guint64))
+        return;
+
+    if (group->have_sample && running > group->prev_running) {
+        gdouble scale = (gdouble)(enabled - group->prev_enabled) / (running - group->prev_running);
+        for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++) {
+            gint slot = group->slot[e];
+            if (slot >= 0 && (guint64)slot < nr && values[slot] >= group->prev_values[e])
+                totals[e] += (values[slot] - group->prev_values[e]) * scale;
+        }
+    }
+
+    for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++) {
+        gint slot = group->slot[e];
+        if (slot >= 0 && (guint64)slot < nr)
+            group->prev_values[e] = values[slot];
+    }
+    group->prev_enabled = enabled;
+    group->prev_running = running;
+    group->have_sample = TRUE;
+}
+
+/**
+ * Create new perf collector
+ */
+XRGPerfCollector* xrg_perf_collector_new(gint dataset_capacity) {
+    XRGPerfCollector *collector = g_new0(XRGPerfCollector, 1);
+
+    collector->dataset_capacity = dataset_capacity;
+    collector->groups = g_array_new(FALSE, FALSE, sizeof(PerfGroup));
+    open_groups(collector);
+    if (collector->groups->len == 0)
+        g_warning("Performance counters unavailable (%s)", collector->error ? collector->error : "no CPUs");
+
+    /* Create datasets */
+    collector->ipc_history = xrg_dataset_new(dataset_capacity);
+    collector->mpki_history = xrg_dataset_new(dataset_capacity);
+    collector->context_switch_history = xrg_dataset_new(dataset_capacity);
+    collector->migration_history = xrg_dataset_new(dataset_capacity);
+
+    /* Initialize */
+    collector->last_update_time = g_get_monotonic_time();
+
+    /* Do initial read */
+    xrg_perf_collector_update(collector);
+
+    return collector;
+}
+
+/**
+ * Free perf collector
+ */
+void xrg_perf_collector_free(XRGPerfCollector *collector) {
+    if (collector == NULL)
+        return;
+
+    for (guint i = 0; i < collector->groups->len; i++)
+        close_group(&g_array_index(collector->groups, PerfGroup, i));
+    g_array_free(collector->groups, TRUE);
+    g_free(collector->error);
+
+    xrg_dataset_free(collector->ipc_history);
+    xrg_dataset_free(collector->mpki_history);
+    xrg_dataset_free(collector->context_switch_history);
+    xrg_dataset_free(collector->migration_history);
+
+    g_free(collector);
+}
+
+/**
+ * Read every CPU's group and derive rates, IPC and misses per instruction
+ */
+void xrg_perf_collector_update(XRGPerfCollector *collector) {
+    g_return_if_fail(collector != NULL);
+
+    gint64 now = g_get_monotonic_time();
+    gdouble time_delta = (now - collector->last_update_time) / (gdouble)G_USEC_PER_SEC;
+
+    gdouble totals[XRG_PERF_NUM_EVENTS] = { 0.0 };
+    for (guint i = 0; i < collector->groups->len; i++)
+        read_group(collector, &g_array_index(collector->groups, PerfGroup, i), totals);
+
+    for (gint e = 0; e < XRG_PERF_NUM_EVENTS; e++)
+        collector->rates[e] = time_delta > 0 ? totals[e] / time_delta : 0.0;
+
+    gdouble cycles = totals[XRG_PERF_CYCLES];
+    gdouble instructions = totals[XRG_PERF_INSTRUCTIONS];
+    collector->ipc = cycles > 0 ? instructions / cycles : 0.0;
+    collector->mpki = instructions > 0 ? totals[XRG_PERF_CACHE_MISSES] * 1000.0 / instructions : 0.0;
+
+    xrg_dataset_add_value(collector->ipc_history, collector->ipc);
+    xrg_dataset_add_value(collector->mpki_history, collector->mpki);
+    xrg_dataset_add_value(collector->context_switch_history, collector->rates[XRG_PERF_CONTEXT_SWITCHES]);
+    xrg_dataset_add_value(collector->migration_history, collector->rates[XRG_PERF_CPU_MIGRATIONS]);
+
+    collector->last_update_time = now;
+}
+
+/* Getters */
+
+gboolean xrg_perf_collector_is_available(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    return collector->groups->len > 0;
+}
+
+gboolean xrg_perf_collector_has_hardware(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    return collector->groups->len > 0 && collector->hardware;
+}
+
+gboolean xrg_perf_collector_has_event(XRGPerfCollector *collector, XRGPerfEvent event) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    g_return_val_if_fail(event >= 0 && event < XRG_PERF_NUM_EVENTS, FALSE);
+    return collector->has_event[event];
+}
+
+gint xrg_perf_collector_get_num_cpus(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0);
+    return collector->groups->len;
+}
+
+const gchar* xrg_perf_collector_get_error(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->error;
+}
+
+gdouble xrg_perf_collector_get_rate(XRGPerfCollector *collector, XRGPerfEvent event) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    g_return_val_if_fail(event >= 0 && event < XRG_PERF_NUM_EVENTS, 0.0);
+    return collector->rates[event];
+}
+
+gdouble xrg_perf_collector_get_ipc(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return collector->ipc;
+}
+
+gdouble xrg_perf_collector_get_cache_mpki(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, 0.0);
+    return collector->mpki;
+}
+
+/* Dataset access */
+
+XRGDataset* xrg_perf_collector_get_ipc_dataset(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->ipc_history;
+}
+
+XRGDataset* xrg_perf_collector_get_mpki_dataset(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->mpki_history;
+}
+
+XRGDataset* xrg_perf_collector_get_context_switch_dataset(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->context_switch_history;
+}
+
+XRGDataset* xrg_perf_collector_get_migration_dataset(XRGPerfCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->migration_history;
+}
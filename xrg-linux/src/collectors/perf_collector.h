@@ -0,0 +1,59 @@
+#ifndef XRG_PERF_COLLECTOR_H
+#define XRG_PERF_COLLECTOR_H
+
+#include <glib.h>
+#include "../core/dataset.h"
+
+/**
+ * XRGPerfCollector - Hardware performance counters
+ *
+ * Opens one perf_event_open() group per CPU, system-wide and in counting
+ * mode:
+ * - Hardware: cycles, instructions, cache-misses
+ * - Software: context-switches, cpu-migrations
+ *
+ * Groups are read with PERF_FORMAT_GROUP, so an update is one read() per
+ * CPU. Counts are scaled by time_enabled/time_running when the kernel has
+ * to multiplex the PMU.
+ *
+ * Without hardware counters (most VMs, or no PMU access) the collector
+ * falls back to the software events alone; IPC and miss rates then read 0.
+ * System-wide counting needs perf_event_paranoid <= 0 or CAP_PERFMON; if
+ * not even the software events open, the collector is unavailable.
+ */
+
+typedef enum {
+    XRG_PERF_CYCLES,
+    XRG_PERF_INSTRUCTIONS,
+    XRG_PERF_CACHE_MISSES,
+    XRG_PERF_CONTEXT_SWITCHES,
+    XRG_PERF_CPU_MIGRATIONS,
+    XRG_PERF_NUM_EVENTS
+} XRGPerfEvent;
+
+typedef struct _XRGPerfCollector XRGPerfCollector;
+
+/* Constructor and destructor */
+XRGPerfCollector* xrg_perf_collector_new(gint dataset_capacity);
+void xrg_perf_collector_free(XRGPerfCollector *collector);
+
+/* Update methods */
+void xrg_perf_collector_update(XRGPerfCollector *collector);
+
+/* Getters */
+gboolean xrg_perf_collector_is_available(XRGPerfCollector *collector);
+gboolean xrg_perf_collector_has_hardware(XRGPerfCollector *collector);
+gboolean xrg_perf_collector_has_event(XRGPerfCollector *collector, XRGPerfEvent event);
+gint xrg_perf_collector_get_num_cpus(XRGPerfCollector *collector);  /* CPUs with an open group */
+const gchar* xrg_perf_collector_get_error(XRGPerfCollector *collector);  /* Why events failed to open, or NULL */
+gdouble xrg_perf_collector_get_rate(XRGPerfCollector *collector, XRGPerfEvent event);  /* Per second, all CPUs */
+gdouble xrg_perf_collector_get_ipc(XRGPerfCollector *collector);  /* Instructions per cycle */
+gdouble xrg_perf_collector_get_cache_mpki(XRGPerfCollector *collector);  /* Cache misses per 1000 instructions */
+
+/* Dataset access */
+XRGDataset* xrg_perf_collector_get_ipc_dataset(XRGPerfCollector *collector);
+XRGDataset* xrg_perf_collector_get_mpki_dataset(XRGPerfCollector *collector);
+XRGDataset* xrg_perf_collector_get_context_switch_dataset(XRGPerfCollector *collector);  /* Per second */
+XRGDataset* xrg_perf_collector_get_migration_dataset(XRGPerfCollector *collector);  /* Per second */
+
+#endif /* XRG_PERF_COLLECTOR_H */
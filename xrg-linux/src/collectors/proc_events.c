@@ -0,0 +1,259 @@
+#include "proc_events.h"
+#include "proc_reader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#define MAX_QUEUED_EVENTS 65536   /* Beyond this, events are dropped and reported lost */
+
+struct _XRGProcEvents {
+    gint sock;                /* NETLINK_CONNECTOR socket */
+    gint wake_pipe[2];        /* Written to stop the listener */
+    GThread *thread;
+
+    XRGProcReader *reader;    /* For reading exiting processes' stat */
+    XRGProcBuffer buf;
+
+    GMutex lock;              /* Guards queue and lost */
+    GArray *queue;            /* XRGProcEvent */
+    gboolean lost;
+};
+
+/* Helper: Send a PROC_CN_MCAST_LISTEN/IGNORE request */
+static gboolean send_mcast_op(gint sock, enum proc_cn_mcast_op op) {
+    struct {
+        struct nlmsghdr nl;
+        struct cn_msg cn;
+        enum proc_cn_mcast_op op;
+    } __attribute__((packed)) msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.nl.nlmsg_len = sizeof(msg);
+    msg.nl.nlmsg_type = NLMSG_DONE;
+    msg.nl.nlmsg_pid = getpid();
+    msg.cn.id.idx = CN_IDX_PROC;
+    msg.cn.id.val = CN_VAL_PROC;
+    msg.cn.len = sizeof(enum proc_cn_mcast_op);
+    msg.op = op;
+
+    return send(sock, &msg, sizeof(msg), 0) == (ssize_t)sizeof(msg);
+}
+
+/* Helper: Fill an exit event from the zombie's /proc/[pid]/stat */
+static void capture_exit(XRGProcEvents *events, XRGProcEvent *event) {
+    gint pid_fd = xrg_proc_reader_open_pid(events->reader, event->pid);
+    if (pid_fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(pid_fd, &st) == 0 &&
+        xrg_proc_read_at(pid_fd, "stat", &events->buf, G_MAXSIZE) > 0) {
+        const gchar *comm_start = strchr(events->buf.data, '(');
+        const gchar *comm_end = strrchr(events->buf.data, ')');
+
+        if (comm_start && comm_end && comm_end > comm_start && comm_end[1] != '\0') {
+            /* Fields 3 (state) to 22 (starttime); utime is 14, stime 15 */
+            const gchar *p = comm_end + 2;
+            guint64 utime = 0, stime = 0, start_time = 0;
+            gint field = 3;
+
+            while (*p && field <= 22) {
+                while (*p == ' ') p++;
+                if (field == 14) utime = strtoull(p, NULL, 10);
+                else if (field == 15) stime = strtoull(p, NULL, 10);
+                else if (field == 22) start_time = strtoull(p, NULL, 10);
+                while (*p && *p != ' ') p++;
+                field++;
+            }
+
+            if (field > 22) {
+                gsize len = MIN((gsize)(comm_end - comm_start - 1), sizeof(event->comm) - 1);
+                memcpy(event->comm, comm_start + 1, len);
+                event->comm[len] = '\0';
+                event->uid = st.st_uid;
+                event->start_time = start_time;
+                event->cpu_total = utime + stime;
+                event->captured = TRUE;
+            }
+        }
+    }
+    close(pid_fd);
+}
+
+static void queue_event(XRGProcEvents *events, const XRGProcEvent *event) {
+    g_mutex_lock(&events->lock);
+    if (events->queue->len < MAX_QUEUED_EVENTS) {
+        g_array_append_val(events->queue, *event);
+    } else {
+        events->lost = TRUE;
+    }
+    g_mutex_unlock(&events->lock);
+}
+
+/* Helper: Translate one proc_event; thread events are dropped */
+static void handle_proc_event(XRGProcEvents *events, const struct proc_event *ev) {
+    XRGProcEvent event;
+    memset(&event, 0, sizeof(event));
+
+    switch (ev->what) {
+        case PROC_EVENT_FORK:
+            if (ev->event_data.fork.child_pid != ev->event_data.fork.child_tgid)
+                return;
+            event.type = XRG_PROC_EVENT_FORK;
+            event.pid = ev->event_data.fork.child_tgid;
+            event.parent_pid = ev->event_data.fork.parent_tgid;
+            break;
+
+        case PROC_EVENT_EXEC:
+            event.type = XRG_PROC_EVENT_EXEC;
+            event.pid = ev->event_data.exec.process_tgid;
+            break;
+
+        case PROC_EVENT_EXIT:
+            if (ev->event_data.exit.process_pid != ev->event_data.exit.process_tgid)
+                return;
+            event.type = XRG_PROC_EVENT_EXIT;
+            event.pid = ev->event_data.exit.process_tgid;
+            capture_exit(events, &event);
+            break;
+
+        default:
+            return;
+    }
+
+    queue_event(events, &event);
+}
+
+static gpointer listener_thread(gpointer data) {
+    XRGProcEvents *events = data;
+    gchar buf[8192] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+    struct pollfd fds[2] = {
+        { .fd = events->sock, .events = POLLIN },
+        { .fd = events->wake_pipe[0], .events = POLLIN },
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break;
+
+        ssize_t len = recv(events->sock, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == ENOBUFS) {
+                /* Kernel dropped messages; the next drain asks for a rescan */
+                g_mutex_lock(&events->lock);
+                events->lost = TRUE;
+                g_mutex_unlock(&events->lock);
+            } else if (errno != EINTR && errno != EAGAIN) {
+                break;
+            }
+            continue;
+        }
+
+        for (struct nlmsghdr *nl = (struct nlmsghdr *)buf; NLMSG_OK(nl, (guint)len); nl = NLMSG_NEXT(nl, len)) {
+            if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_NOOP)
+                continue;
+
+            struct cn_msg *cn = NLMSG_DATA(nl);
+            if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC)
+                continue;
+
+            handle_proc_event(events, (struct proc_event *)cn->data);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Create proc connector listener
+ */
+XRGProcEvents* xrg_proc_events_new(void) {
+    gint sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock < 0)
+        return NULL;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+
+    /* Joining the proc connector group needs CAP_NET_ADMIN (EPERM otherwise) */
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        !send_mcast_op(sock, PROC_CN_MCAST_LISTEN)) {
+        close(sock);
+        return NULL;
+    }
+
+    XRGProcEvents *events = g_new0(XRGProcEvents, 1);
+    events->sock = sock;
+    events->reader = xrg_proc_reader_new();
+    xrg_proc_buffer_init(&events->buf);
+    events->queue = g_array_new(FALSE, FALSE, sizeof(XRGProcEvent));
+    g_mutex_init(&events->lock);
+
+    if (!events->reader || pipe(events->wake_pipe) < 0) {
+        events->wake_pipe[0] = events->wake_pipe[1] = -1;
+        xrg_proc_events_free(events);
+        return NULL;
+    }
+
+    events->thread = g_thread_new("xrg-proc-events", listener_thread, events);
+    return events;
+}
+
+/**
+ * Free proc connector listener
+ */
+void xrg_proc_events_free(XRGProcEvents *events) {
+    if (events == NULL)
+        return;
+
+    if (events->thread) {
+        ssize_t n = write(events->wake_pipe[1], "x", 1);
+        (void)n;
+        g_thread_join(events->thread);
+    }
+
+    send_mcast_op(events->sock, PROC_CN_MCAST_IGNORE);
+    close(events->sock);
+    if (events->wake_pipe[0] >= 0) {
+        close(events->wake_pipe[0]);
+        close(events->wake_pipe[1]);
+    }
+
+    xrg_proc_reader_free(events->reader);
+    xrg_proc_buffer_clear(&events->buf);
+    g_array_free(events->queue, TRUE);
+    g_mutex_clear(&events->lock);
+    g_free(events);
+}
+
+gboolean xrg_proc_events_drain(XRGProcEvents *events, GArray *out) {
+    g_return_val_if_fail(events != NULL, FALSE);
+    g_return_val_if_fail(out != NULL, FALSE);
+
+    g_mutex_lock(&events->lock);
+    g_array_set_size(out, 0);
+    if (events->queue->len > 0) {
+        g_array_append_vals(out, events->queue->data, events->queue->len);
+        g_array_set_size(events->queue, 0);
+    }
+    gboolean complete = !events->lost;
+    events->lost = FALSE;
+    g_mutex_unlock(&events->lock);
+
+    return complete;
+}
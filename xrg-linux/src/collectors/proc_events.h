@@ -0,0 +1,53 @@
+#ifndef XRG_PROC_EVENTS_H
+#define XRG_PROC_EVENTS_H
+
+#include <glib.h>
+#include <sys/types.h>
+
+/**
+ * XRGProcEvents - Process lifecycle events from the netlink proc connector
+ *
+ * Subscribes to PROC_EVENT_FORK/EXEC/EXIT and queues process-level events
+ * (threads are ignored) from a listener thread. Exit events capture the
+ * name, owner and final CPU time from /proc/[pid]/stat while the process
+ * is still a zombie, so processes that live less than one update interval
+ * are still seen.
+ *
+ * Subscribing needs CAP_NET_ADMIN; without it xrg_proc_events_new()
+ * returns NULL and callers keep polling /proc.
+ */
+
+typedef struct _XRGProcEvents XRGProcEvents;
+
+typedef enum {
+    XRG_PROC_EVENT_FORK,
+    XRG_PROC_EVENT_EXEC,
+    XRG_PROC_EVENT_EXIT
+} XRGProcEventType;
+
+typedef struct {
+    XRGProcEventType type;
+    pid_t pid;              /* Process (thread group) ID */
+    pid_t parent_pid;       /* Fork only */
+
+    /* Exit only; captured == FALSE if the process was reaped before it could be read */
+    gboolean captured;
+    gchar comm[64];
+    uid_t uid;
+    guint64 start_time;     /* Jiffies since boot */
+    guint64 cpu_total;      /* utime + stime at exit, in jiffies */
+} XRGProcEvent;
+
+/* Lifecycle (new returns NULL if the connector cannot be used) */
+XRGProcEvents* xrg_proc_events_new(void);
+void xrg_proc_events_free(XRGProcEvents *events);
+
+/*
+ * Move every event received since the last call into out (a GArray of
+ * XRGProcEvent, cleared first). Returns FALSE if events were lost since
+ * the last call (socket or queue overflow); the caller should then
+ * reconcile against a full /proc scan.
+ */
+gboolean xrg_proc_events_drain(XRGProcEvents *events, GArray *out);
+
+#endif /* XRG_PROC_EVENTS_H */
@@ -0,0 +1,180 @@
+#include "proc_reader.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+
+#define DIRENT_BUFFER_SIZE (64 * 1024)  /* ~2000 /proc entries per syscall */
+#define PROC_BUFFER_INITIAL 4096
+
+/* Kernel dirent layout for getdents64 */
+struct linux_dirent64 {
+    guint64 d_ino;
+    gint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct _XRGProcReader {
+    gint proc_fd;         /* /proc, held open for the reader's lifetime */
+    gchar *dirent_buf;    /* getdents64 batch buffer */
+};
+
+/* Helper: Parse an all-digit directory name, 0 if it is not a PID */
+static pid_t parse_pid_name(const gchar *name) {
+    pid_t pid = 0;
+
+    for (const gchar *p = name; *p; p++) {
+        if (*p < '0' || *p > '9')
+            return 0;
+        pid = pid * 10 + (*p - '0');
+    }
+    return pid;
+}
+
+/* Helper: Format a PID into buf without going through printf */
+static const gchar* format_pid(pid_t pid, gchar buf[16]) {
+    gchar *p = buf + 15;
+    *p = '\0';
+    do {
+        *--p = '0' + (pid % 10);
+        pid /= 10;
+    } while (pid > 0);
+    return p;
+}
+
+/**
+ * Create new /proc reader
+ */
+XRGProcReader* xrg_proc_reader_new(void) {
+    gint fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        g_warning("Failed to open /proc");
+        return NULL;
+    }
+
+    XRGProcReader *reader = g_new0(XRGProcReader, 1);
+    reader->proc_fd = fd;
+    reader->dirent_buf = g_malloc(DIRENT_BUFFER_SIZE);
+    return reader;
+}
+
+/**
+ * Free /proc reader
+ */
+void xrg_proc_reader_free(XRGProcReader *reader) {
+    if (reader == NULL)
+        return;
+
+    close(reader->proc_fd);
+    g_free(reader->dirent_buf);
+    g_free(reader);
+}
+
+/**
+ * List PIDs: rewind the held /proc fd and read it in getdents64 batches
+ */
+gboolean xrg_proc_reader_list_pids(XRGProcReader *reader, GArray *pids) {
+    g_return_val_if_fail(reader != NULL, FALSE);
+
+    return xrg_proc_reader_list_dir(reader, reader->proc_fd, pids);
+}
+
+gboolean xrg_proc_reader_list_dir(XRGProcReader *reader, gint dir_fd, GArray *ids) {
+    g_return_val_if_fail(reader != NULL, FALSE);
+    g_return_val_if_fail(ids != NULL, FALSE);
+
+    g_array_set_size(ids, 0);
+
+    if (lseek(dir_fd, 0, SEEK_SET) < 0)
+        return FALSE;
+
+    for (;;) {
+        long n = syscall(SYS_getdents64, dir_fd, reader->dirent_buf, DIRENT_BUFFER_SIZE);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return FALSE;
+        }
+        if (n == 0)
+            break;
+
+        for (long offset = 0; offset < n; ) {
+            struct linux_dirent64 *d = (struct linux_dirent64 *)(reader->dirent_buf + offset);
+            offset += d->d_reclen;
+
+            if (d->d_type != DT_DIR && d->d_type != DT_UNKNOWN)
+                continue;
+
+            pid_t pid = parse_pid_name(d->d_name);
+            if (pid > 0)
+                g_array_append_val(ids, pid);
+        }
+    }
+
+    return TRUE;
+}
+
+gint xrg_proc_reader_open_pid(XRGProcReader *reader, pid_t pid) {
+    g_return_val_if_fail(reader != NULL, -1);
+
+    gchar name[16];
+    return openat(reader->proc_fd, format_pid(pid, name), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+gssize xrg_proc_read_at(gint dir_fd, const gchar *name, XRGProcBuffer *buf, gsize max_len) {
+    g_return_val_if_fail(buf != NULL, -1);
+
+    gint fd = openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    gsize len = 0;
+    for (;;) {
+        /* Keep room for the terminator; grow rather than truncate, up to max_len */
+        if (len + 1 >= buf->size) {
+            if (buf->size > max_len)
+                break;
+            buf->size = buf->size ? buf->size * 2 : PROC_BUFFER_INITIAL;
+            buf->data = g_realloc(buf->data, buf->size);
+        }
+
+        gsize want = MIN(buf->size - 1, max_len) - len;
+        if (want == 0)
+            break;
+
+        ssize_t n = read(fd, buf->data + len, want);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return -1;
+        }
+        if (n == 0)
+            break;
+        len += n;
+    }
+
+    close(fd);
+    buf->data[len] = '\0';
+    return len;
+}
+
+void xrg_proc_buffer_init(XRGProcBuffer *buf) {
+    g_return_if_fail(buf != NULL);
+
+    buf->size = PROC_BUFFER_INITIAL;
+    buf->data = g_malloc(buf->size);
+}
+
+void xrg_proc_buffer_clear(XRGProcBuffer *buf) {
+    g_return_if_fail(buf != NULL);
+
+    g_free(buf->data);
+    buf->data = NULL;
+    buf->size = 0;
+}
@@ -0,0 +1,50 @@
+#ifndef XRG_PROC_READER_H
+#define XRG_PROC_READER_H
+
+#include <glib.h>
+#include <sys/types.h>
+
+/**
+ * XRGProcReader - Low-overhead /proc traversal
+ *
+ * Keeps /proc open as a directory fd and enumerates PIDs with getdents64
+ * in large batches. Per-PID files are opened relative to a PID directory
+ * fd (openat), so no paths are formatted and no stdio is involved.
+ *
+ * Reads go into caller-owned XRGProcBuffer scratch space that grows as
+ * needed and is reused for every file. A reader may be shared between
+ * threads as long as each thread uses its own buffer.
+ */
+
+typedef struct _XRGProcReader XRGProcReader;
+
+/* Reusable, growable read buffer; one per thread */
+typedef struct {
+    gchar *data;
+    gsize size;
+} XRGProcBuffer;
+
+/* Lifecycle */
+XRGProcReader* xrg_proc_reader_new(void);
+void xrg_proc_reader_free(XRGProcReader *reader);
+
+/* Enumerate numeric /proc entries into pids (a GArray of pid_t, cleared first) */
+gboolean xrg_proc_reader_list_pids(XRGProcReader *reader, GArray *pids);
+
+/* Same for any held /proc directory fd, e.g. /proc/[pid]/task for TIDs */
+gboolean xrg_proc_reader_list_dir(XRGProcReader *reader, gint dir_fd, GArray *ids);
+
+/* Open /proc/[pid] as a directory fd; -1 if the process is gone */
+gint xrg_proc_reader_open_pid(XRGProcReader *reader, pid_t pid);
+
+/*
+ * Read up to max_len bytes of a file relative to dir_fd into buf,
+ * NUL-terminated. Returns the byte count, or -1 on error.
+ */
+gssize xrg_proc_read_at(gint dir_fd, const gchar *name, XRGProcBuffer *buf, gsize max_len);
+
+/* Scratch buffers */
+void xrg_proc_buffer_init(XRGProcBuffer *buf);
+void xrg_proc_buffer_clear(XRGProcBuffer *buf);
+
+#endif /* XRG_PROC_READER_H */
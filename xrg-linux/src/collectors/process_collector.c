@@ -5,22 +5,192 @@
  */
 
 #include "process_collector.h"
+#include "proc_reader.h"
+#include "proc_events.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <dirent.h>
 #include <pwd.h>
 #include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
 #include <sys/types.h>
-#include <ctype.h>
+#include <sys/stat.h>
+
+/* Fields of /proc/[pid]/stat following "pid (comm) state", numbered as in proc(5) */
+#define STAT_FIRST_FIELD    4       /* ppid */
+#define STAT_UTIME          14
+#define STAT_STIME          15
+#define STAT_NICE           19
+#define STAT_NUM_THREADS    20
+#define STAT_STARTTIME      22
+#define STAT_VSIZE          23
+#define STAT_RSS            24
+#define STAT_FIELD(values, n) ((values)[(n) - STAT_FIRST_FIELD])
+
+/* PIDs handed to a scan worker at a time */
+#define SCAN_CHUNK_SIZE         256
+/* Below this many PIDs one thread beats waking the pool */
+#define PARALLEL_SCAN_MIN_PIDS  2048
+#define MAX_SCAN_THREADS        64
+
+#define PROCESS_TABLE_INITIAL_SIZE  1024    /* Slots; always a power of two */
+
+/* When sorting by I/O, this many times max_processes are ranked by CPU, then by I/O */
+#define IO_CANDIDATE_FACTOR     4
+
+/* Memory probes (smaps_rollup) */
+#define DEFAULT_PROBE_BUDGET_US 2000    /* Thread CPU time per update */
+#define PROBE_COST_INITIAL_US   1000    /* Cost assumed before any probe was measured */
+#define PROBE_OVER_BUDGET_EVERY 10      /* Updates between probes of a process over the budget */
+
+/* History rings for sparklines: a fixed pool, this many per listed process */
+#define HISTORY_POOL_FACTOR     4
+
+/* With event tracking, walk all of /proc only every this many updates */
+#define RECONCILE_INTERVAL      30
+
+/* Event-derived PID states for the incremental PID list */
+#define PID_FORKED  1
+#define PID_EXITED  2
+
+/**
+ * Per-process data that does not change while the process lives.
+ * Keyed by (pid, start_time), which identifies one incarnation of a
+ * process, so a reused PID never inherits a previous owner's data.
+ */
+typedef struct _ProcessCacheEntry ProcessCacheEntry;
+struct _ProcessCacheEntry {
+    pid_t pid;
+    guint64 start_time;             /* Jiffies since boot (from stat) */
+    gchar *name;                    /* comm (from stat) */
+    gchar *cmdline;                 /* Command line (truncated), loaded on demand */
+    gboolean cmdline_loaded;        /* cmdline has been read (it may be NULL) */
+    uid_t uid;                      /* Owner of /proc/[pid] */
+    const gchar *username;          /* Owned by user_names */
+    guint64 prev_cpu_total;         /* utime + stime at the previous update */
+    gboolean have_sample;           /* prev_cpu_total is from a previous update */
+    guint generation;               /* Last update this process was seen */
+    guint filter_generation;        /* Filter the verdict below belongs to */
+    gboolean filter_match;          /* Cached name filter verdict */
+
+    /* I/O and context-switch counters, sampled only while the process is listed */
+    guint io_generation;            /* Update of the last sample, 0 = never */
+    guint64 prev_read_bytes;
+    guint64 prev_write_bytes;
+    guint64 prev_voluntary_ctxt;
+    guint64 prev_nonvoluntary_ctxt;
+
+    /* smaps_rollup probe results */
+    guint64 pss_bytes;
+    guint64 uss_bytes;
+    gint64 memory_sampled_at;       /* Monotonic time of the last probe, 0 = never */
+    gint64 probe_cost_us;           /* CPU time the last probe took */
+    gboolean probe_failed;          /* smaps_rollup unreadable (not ours, or a kernel thread) */
+
+    gint history_slot;              /* Index into the history pool, -1 = none (valid while owned) */
+
+    /* Table bookkeeping */
+    ProcessCacheEntry *lru_prev;    /* Seen-order list, least recently seen first */
+    ProcessCacheEntry *lru_next;
+    ProcessCacheEntry *seen_next;   /* Worker-local chain of entries seen in a chunk */
+};
+
+/* Open-addressing slot; the key is kept inline so probes do not chase pointers */
+typedef struct {
+    pid_t pid;
+    guint64 start_time;
+    ProcessCacheEntry *entry;       /* NULL if the slot is empty */
+} ProcessTableSlot;
+
+/*
+ * Linear-probing table of every live process. Entries are also kept on a
+ * list ordered by the update that last saw them, so exited processes
+ * collect at the head and are swept without visiting live ones.
+ */
+typedef struct {
+    ProcessTableSlot *slots;
+    guint mask;                     /* Slot count - 1 */
+    guint count;
+    ProcessCacheEntry *lru_head;    /* Least recently seen */
+    ProcessCacheEntry *lru_tail;    /* Seen this update */
+    GMutex lru_lock;                /* Guards the list while workers scan */
+} ProcessTable;
+
+/* One parsed /proc/[pid]/stat */
+typedef struct {
+    pid_t pid;
+    uid_t uid;                      /* Only valid for pending samples */
+    gchar state;
+    gint64 values[STAT_RSS - STAT_FIRST_FIELD + 1];
+    gchar comm[64];
+    gsize comm_len;
+} ProcessSample;
+
+/* Top-N selection heap, worst kept process at the root */
+typedef struct {
+    XRGProcessInfo *items;          /* max_processes * IO_CANDIDATE_FACTOR slots */
+    gint count;                     /* Slots in use */
+} ProcessHeap;
+
+/*
+ * One history ring in the fixed pool. A slot belongs to one process
+ * incarnation until it is evicted; entries holding a stale index notice
+ * the owner changed.
+ */
+typedef struct {
+    pid_t pid;                      /* Owner, 0 = free */
+    guint64 start_time;
+    guint last_listed;              /* Update the owner was last listed (LRU key) */
+    guint last_pushed;              /* Update of the newest sample */
+    gint head;                      /* Next write position */
+    gint count;                     /* Valid samples */
+    gfloat cpu[XRG_PROCESS_HISTORY_LENGTH];
+    gfloat mem[XRG_PROCESS_HISTORY_LENGTH];
+} ProcessHistory;
+
+/* One thread of the drill-down process */
+typedef struct {
+    pid_t tid;
+    guint64 start_time;             /* Tells a reused tid from the thread that had it */
+    guint64 prev_cpu_total;         /* utime + stime at the previous thread update */
+    gboolean have_sample;           /* prev_cpu_total is from a previous update */
+    guint generation;               /* Last thread update that listed it */
+} ThreadCacheEntry;
+
+/* Processes of one name that exited since the previous update */
+typedef struct {
+    gchar name[64];
+    uid_t uid;
+    pid_t last_pid;
+    gint count;
+    guint64 cpu_ticks;              /* CPU used since they were last sampled */
+} ExitedProcessGroup;
+
+/* Per-thread scan state, reused across updates */
+typedef struct {
+    XRGProcessCollector *collector;
+    XRGProcBuffer scratch;          /* Read buffer for this thread */
+    ProcessHeap heap;               /* This worker's top N */
+    GArray *pending;                /* ProcessSample: PIDs that need a new cache entry */
+    ProcessCacheEntry *seen;        /* Entries seen in the current chunk (seen_next chain) */
+    gint total_processes;
+    gint running_processes;
+} ProcessScanWorker;
 
 struct _XRGProcessCollector {
-    GList *processes;               /* List of XRGProcessInfo */
+    ProcessHeap top;                /* Top processes, best first after an update */
     gint max_processes;             /* Maximum processes to track */
+    gint heap_capacity;             /* Processes kept by the scan (more when ranking by I/O) */
     XRGProcessSortBy sort_by;       /* Current sort criteria */
+    XRGProcessSortBy rank_by;       /* Order the heaps use: sort_by, or CPU while picking I/O candidates */
+    XRGProcessInfo *candidates;     /* Scratch for re-ranking the candidates by I/O */
     gboolean sort_descending;       /* Sort order */
     gboolean show_all_users;        /* Show processes from all users */
-    gchar *filter;                  /* Name filter */
+    gchar *filter;                  /* Name filter, as set */
+    gchar *filter_lower;            /* Compiled: lowercased needle, NULL if no filter */
+    gsize filter_len;               /* strlen(filter_lower) */
+    guint filter_generation;        /* Bumped whenever the filter changes */
     uid_t current_uid;              /* Current user's UID */
 
     /* System info */
@@ -30,70 +200,338 @@ struct _XRGProcessCollector {
     guint64 page_size;              /* System page size */
     guint64 clock_ticks;            /* Clock ticks per second */
     gdouble uptime_seconds;         /* System uptime */
+    gint64 last_update_time;        /* Monotonic, microseconds */
+    gdouble time_delta;             /* Seconds since the previous update */
+
+    /* Memory probe scheduling */
+    gint probe_budget_us;           /* Thread CPU time allowed per update, 0 = no probes */
+    gint64 probe_cost_avg_us;       /* Moving average of probe cost */
+    pid_t probe_pid;                /* Probed first (hovered process), 0 = none */
+    guint probe_updates;            /* Updates with probes on, to pace over-budget probes */
 
-    /* Previous CPU times for delta calculation */
+    /* Sparkline history, max_processes * HISTORY_POOL_FACTOR slots */
+    ProcessHistory *history;
+    gint history_slots;
+
+    /* Previous CPU time for delta calculation (per-process times live in the cache) */
     guint64 prev_total_cpu;         /* Previous total CPU time */
-    GHashTable *prev_cpu_times;     /* pid -> prev total time */
+    guint64 cpu_delta;              /* Total CPU time since the previous update */
+
+    /* /proc traversal */
+    XRGProcReader *reader;          /* Held /proc dirfd */
+    GArray *pids;                   /* PIDs listed this update */
+
+    /* Sharded scan */
+    ProcessScanWorker *workers;     /* workers[0] runs on the updating thread */
+    gint num_workers;               /* Workers allocated so far */
+    gint max_threads;               /* Scan thread cap, 0 = one per CPU */
+    GThreadPool *scan_pool;         /* Runs workers[1..] */
+    gint next_chunk;                /* Next unclaimed index into pids (atomic) */
+    gint workers_running;           /* Pool workers not yet finished */
+    GMutex scan_lock;
+    GCond scan_done;
+
+    /* Static per-process data, reused until the process exits */
+    ProcessTable process_table;     /* (pid, start_time) -> ProcessCacheEntry */
+    GHashTable *user_names;         /* uid -> username */
+    guint generation;               /* Incremented every update */
+
+    /* Event tracking (NULL events = poll /proc every update) */
+    XRGProcEvents *events;
+    GArray *event_buf;              /* XRGProcEvent drained this update */
+    GHashTable *event_pids;         /* pid -> PID_FORKED / PID_EXITED, this update */
+    GArray *exited_groups;          /* ExitedProcessGroup, this update */
+    gint updates_since_reconcile;
+    gint forks, execs, exits;       /* Event counts for the last update */
+
+    /* Thread drill-down (thread_pid 0 = off) */
+    pid_t thread_pid;
+    gint task_fd;                   /* /proc/[thread_pid]/task, -1 when off */
+    GHashTable *thread_cache;       /* tid -> ThreadCacheEntry */
+    GArray *tids;                   /* TIDs listed this thread update */
+    GArray *threads;                /* XRGThreadInfo, busiest first */
+    XRGProcBuffer thread_buf;
+    guint thread_generation;
+    gint64 last_thread_update;      /* Monotonic, microseconds, 0 = no previous sample */
 };
 
 /*============================================================================
  * Helper Functions
  *============================================================================*/
 
-static gchar* read_file_contents(const gchar *path, gsize max_len, gsize *bytes_read) {
-    FILE *f = fopen(path, "r");
-    if (!f) return NULL;
+static gchar* read_cmdline(gint pid_fd, XRGProcBuffer *buf) {
+    gssize bytes_read = xrg_proc_read_at(pid_fd, "cmdline", buf, 256);
+    if (bytes_read <= 0) {
+        return NULL;
+    }
 
-    gchar *buffer = g_malloc(max_len + 1);
-    gsize len = fread(buffer, 1, max_len, f);
-    fclose(f);
+    /* Replace null bytes with spaces (cmdline has null-separated args) */
+    for (gssize i = 0; i < bytes_read - 1; i++) {  /* -1 to keep final null */
+        if (buf->data[i] == '\0') {
+            buf->data[i] = ' ';
+        }
+    }
 
-    buffer[len] = '\0';
-    if (bytes_read) *bytes_read = len;
-    return buffer;
+    /* Trim trailing whitespace */
+    return g_strchomp(g_strndup(buf->data, bytes_read));
 }
 
-static gchar* read_cmdline(pid_t pid) {
-    gchar path[64];
-    g_snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+static gchar* get_username(uid_t uid) {
+    struct passwd *pw = getpwuid(uid);
+    if (pw) {
+        return g_strdup(pw->pw_name);
+    }
+    return g_strdup_printf("%d", uid);
+}
 
-    gsize bytes_read = 0;
-    gchar *cmdline = read_file_contents(path, 256, &bytes_read);
-    if (!cmdline || bytes_read == 0) {
-        g_free(cmdline);
-        return NULL;
+/* getpwuid() may hit NSS (files, LDAP, ...); resolve each UID only once */
+static const gchar* lookup_username(XRGProcessCollector *collector, uid_t uid) {
+    gchar *name = g_hash_table_lookup(collector->user_names, GUINT_TO_POINTER(uid));
+    if (!name) {
+        name = get_username(uid);
+        g_hash_table_insert(collector->user_names, GUINT_TO_POINTER(uid), name);
     }
+    return name;
+}
 
-    /* Replace null bytes with spaces (cmdline has null-separated args) */
-    for (gsize i = 0; i < bytes_read - 1; i++) {  /* -1 to keep final null */
-        if (cmdline[i] == '\0') {
-            cmdline[i] = ' ';
+/* The owner of /proc/[pid] is the process UID: one fstat, no file to read or parse */
+static gboolean read_uid(gint pid_fd, uid_t *uid) {
+    struct stat st;
+    if (fstat(pid_fd, &st) != 0) return FALSE;
+
+    *uid = st.st_uid;
+    return TRUE;
+}
+
+/* Case-insensitive substring test against an already lowercased needle */
+static gboolean text_matches_filter(const gchar *text, gsize text_len,
+                                    const gchar *needle, gsize needle_len) {
+    if (!text || needle_len > text_len) return FALSE;
+
+    for (gsize i = 0; i + needle_len <= text_len; i++) {
+        gsize j = 0;
+        while (j < needle_len && g_ascii_tolower(text[i + j]) == needle[j]) {
+            j++;
         }
+        if (j == needle_len) return TRUE;
     }
+    return FALSE;
+}
 
-    /* Trim trailing whitespace */
-    g_strchomp(cmdline);
 
-    return cmdline;
+static void process_cache_entry_free(ProcessCacheEntry *entry) {
+    if (!entry) return;
+    g_free(entry->name);
+    g_free(entry->cmdline);
+    g_free(entry);
+}
+
+/*============================================================================
+ * Process Table
+ *============================================================================*/
+
+static guint process_table_hash(pid_t pid, guint64 start_time) {
+    guint64 h = ((guint64)(guint)pid << 32) ^ start_time;
+    h ^= h >> 33;
+    h *= G_GUINT64_CONSTANT(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    return (guint)h;
 }
 
-static gchar* read_comm(pid_t pid) {
-    gchar path[64];
-    g_snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+static void process_table_init(ProcessTable *table) {
+    table->slots = g_new0(ProcessTableSlot, PROCESS_TABLE_INITIAL_SIZE);
+    table->mask = PROCESS_TABLE_INITIAL_SIZE - 1;
+    table->count = 0;
+    table->lru_head = table->lru_tail = NULL;
+    g_mutex_init(&table->lru_lock);
+}
 
-    gchar *comm = read_file_contents(path, 64, NULL);
-    if (comm) {
-        g_strchomp(comm);
+static void process_table_clear(ProcessTable *table) {
+    ProcessCacheEntry *entry = table->lru_head;
+    while (entry) {
+        ProcessCacheEntry *next = entry->lru_next;
+        process_cache_entry_free(entry);
+        entry = next;
     }
-    return comm;
+    g_free(table->slots);
+    g_mutex_clear(&table->lru_lock);
 }
 
-static gchar* get_username(uid_t uid) {
-    struct passwd *pw = getpwuid(uid);
-    if (pw) {
-        return g_strdup(pw->pw_name);
+/* Read-only; safe from any worker while nothing is inserted or removed */
+static ProcessCacheEntry* process_table_lookup(ProcessTable *table, pid_t pid, guint64 start_time) {
+    guint i = process_table_hash(pid, start_time) & table->mask;
+
+    while (table->slots[i].entry) {
+        if (table->slots[i].pid == pid && table->slots[i].start_time == start_time) {
+            return table->slots[i].entry;
+        }
+        i = (i + 1) & table->mask;
     }
-    return g_strdup_printf("%d", uid);
+    return NULL;
+}
+
+static void process_table_place(ProcessTable *table, ProcessCacheEntry *entry) {
+    guint i = process_table_hash(entry->pid, entry->start_time) & table->mask;
+
+    while (table->slots[i].entry) {
+        i = (i + 1) & table->mask;
+    }
+    table->slots[i].pid = entry->pid;
+    table->slots[i].start_time = entry->start_time;
+    table->slots[i].entry = entry;
+}
+
+static void lru_unlink(ProcessTable *table, ProcessCacheEntry *entry) {
+    if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else table->lru_head = entry->lru_next;
+    if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else table->lru_tail = entry->lru_prev;
+    entry->lru_prev = entry->lru_next = NULL;
+}
+
+static void lru_append(ProcessTable *table, ProcessCacheEntry *entry) {
+    entry->lru_prev = table->lru_tail;
+    entry->lru_next = NULL;
+    if (table->lru_tail) table->lru_tail->lru_next = entry;
+    else table->lru_head = entry;
+    table->lru_tail = entry;
+}
+
+/* Serial only: add a new entry, growing the table to stay under 50% load */
+static void process_table_insert(ProcessTable *table, ProcessCacheEntry *entry) {
+    if ((table->count + 1) * 2 > table->mask + 1) {
+        ProcessTableSlot *old_slots = table->slots;
+        guint old_size = table->mask + 1;
+
+        table->slots = g_new0(ProcessTableSlot, old_size * 2);
+        table->mask = old_size * 2 - 1;
+        for (guint i = 0; i < old_size; i++) {
+            if (old_slots[i].entry) {
+                process_table_place(table, old_slots[i].entry);
+            }
+        }
+        g_free(old_slots);
+    }
+
+    process_table_place(table, entry);
+    lru_append(table, entry);
+    table->count++;
+}
+
+/* Serial only: remove by backward-shift deletion, so no tombstones build up */
+static void process_table_remove(ProcessTable *table, ProcessCacheEntry *entry) {
+    guint i = process_table_hash(entry->pid, entry->start_time) & table->mask;
+    while (table->slots[i].entry != entry) {
+        i = (i + 1) & table->mask;
+    }
+
+    guint j = i;
+    for (;;) {
+        table->slots[i].entry = NULL;
+        for (;;) {
+            j = (j + 1) & table->mask;
+            if (!table->slots[j].entry) goto done;
+
+            /* Move j back to the hole unless its home slot lies in (i, j] */
+            guint home = process_table_hash(table->slots[j].pid, table->slots[j].start_time) & table->mask;
+            if (((j - home) & table->mask) >= ((j - i) & table->mask)) break;
+        }
+        table->slots[i] = table->slots[j];
+        i = j;
+    }
+
+done:
+    lru_unlink(table, entry);
+    table->count--;
+}
+
+/* Move a worker's chain of just-seen entries to the tail, one lock per chunk */
+static void process_table_touch(ProcessTable *table, ProcessCacheEntry *seen) {
+    if (!seen) return;
+
+    g_mutex_lock(&table->lru_lock);
+    while (seen) {
+        ProcessCacheEntry *next = seen->seen_next;
+        lru_unlink(table, seen);
+        lru_append(table, seen);
+        seen->seen_next = NULL;
+        seen = next;
+    }
+    g_mutex_unlock(&table->lru_lock);
+}
+
+/* Drop entries not seen this update; they sit at the head, so this is O(dead) */
+static void process_table_sweep(ProcessTable *table, guint generation) {
+    while (table->lru_head && table->lru_head->generation != generation) {
+        ProcessCacheEntry *entry = table->lru_head;
+        process_table_remove(table, entry);
+        process_cache_entry_free(entry);
+    }
+}
+
+/* Forget the name-derived data of an entry (new process or exec) */
+static void reset_cache_entry_image(ProcessCacheEntry *entry, const gchar *comm, gsize comm_len) {
+    g_free(entry->name);
+    g_free(entry->cmdline);
+    entry->name = g_strndup(comm, comm_len);
+    entry->cmdline = NULL;
+    entry->cmdline_loaded = FALSE;
+    entry->filter_generation = 0;
+}
+
+/* pid_fd may be -1 when the caller has no /proc/[pid] fd open */
+static const gchar* get_cache_entry_cmdline(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                                            gint pid_fd, XRGProcBuffer *buf) {
+    if (!entry->cmdline_loaded) {
+        gint fd = pid_fd >= 0 ? pid_fd : xrg_proc_reader_open_pid(collector->reader, entry->pid);
+        if (fd >= 0) {
+            entry->cmdline = read_cmdline(fd, buf);
+            if (fd != pid_fd) close(fd);
+        }
+        entry->cmdline_loaded = TRUE;
+    }
+    return entry->cmdline;
+}
+
+/*
+ * Create the cache entry for a process seen for the first time. A reused
+ * PID gets a fresh entry; its predecessor's is swept as unseen. Inserts
+ * into process_table, so only call this while no scan workers are running.
+ */
+static ProcessCacheEntry* create_cache_entry(XRGProcessCollector *collector, const ProcessSample *sample) {
+    ProcessCacheEntry *entry = g_new0(ProcessCacheEntry, 1);
+
+    entry->pid = sample->pid;
+    entry->start_time = STAT_FIELD(sample->values, STAT_STARTTIME);
+    entry->uid = sample->uid;
+    entry->username = lookup_username(collector, entry->uid);
+    entry->generation = collector->generation;
+    entry->history_slot = -1;
+    reset_cache_entry_image(entry, sample->comm, sample->comm_len);
+
+    process_table_insert(&collector->process_table, entry);
+    return entry;
+}
+
+/* Name filter verdict, evaluated once per process image and filter */
+static gboolean cache_entry_matches_filter(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                                           gint pid_fd, XRGProcBuffer *buf) {
+    if (!collector->filter_lower) return TRUE;
+
+    if (entry->filter_generation != collector->filter_generation) {
+        entry->filter_match =
+            text_matches_filter(entry->name, strlen(entry->name),
+                                collector->filter_lower, collector->filter_len);
+        if (!entry->filter_match) {
+            /* Command line is only read when the cheap comm check fails */
+            const gchar *cmdline = get_cache_entry_cmdline(collector, entry, pid_fd, buf);
+            entry->filter_match =
+                cmdline && text_matches_filter(cmdline, strlen(cmdline),
+                                               collector->filter_lower, collector->filter_len);
+        }
+        entry->filter_generation = collector->filter_generation;
+    }
+    return entry->filter_match;
 }
 
 static guint64 get_total_cpu_time(void) {
@@ -143,110 +581,6 @@ static guint64 get_total_memory(void) {
     return total;
 }
 
-/*============================================================================
- * Process Parsing
- *============================================================================*/
-
-static XRGProcessInfo* parse_process(XRGProcessCollector *collector, pid_t pid) {
-    gchar path[64];
-
-    /* Read /proc/[pid]/stat */
-    g_snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    gchar *stat_contents = read_file_contents(path, 1024, NULL);
-    if (!stat_contents) return NULL;
-
-    /* Parse stat file - format is complex due to comm field possibly containing spaces/parens */
-    /* Find the last ')' to locate end of comm field */
-    gchar *comm_end = strrchr(stat_contents, ')');
-    if (!comm_end) {
-        g_free(stat_contents);
-        return NULL;
-    }
-
-    /* Fields after comm: state, ppid, pgrp, session, tty_nr, tpgid, flags, minflt, ... */
-    gchar state;
-    gint ppid, pgrp, session, tty_nr, tpgid;
-    guint flags;
-    guint64 minflt, cminflt, majflt, cmajflt, utime, stime, cutime, cstime;
-    gint priority, nice_val, num_threads;
-    guint64 itrealvalue, starttime, vsize;
-    guint64 rss;
-
-    gint fields = sscanf(comm_end + 2,
-        "%c %d %d %d %d %d %u "
-        "%lu %lu %lu %lu %lu %lu %lu %lu "
-        "%d %d %d "
-        "%lu %lu %lu "
-        "%lu",
-        &state, &ppid, &pgrp, &session, &tty_nr, &tpgid, &flags,
-        &minflt, &cminflt, &majflt, &cmajflt, &utime, &stime, &cutime, &cstime,
-        &priority, &nice_val, &num_threads,
-        &itrealvalue, &starttime, &vsize,
-        &rss);
-
-    g_free(stat_contents);
-
-    if (fields < 22) return NULL;
-
-    /* Read UID from /proc/[pid]/status */
-    g_snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    gchar *status_contents = read_file_contents(path, 2048, NULL);
-    uid_t uid = 0;
-
-    if (status_contents) {
-        gchar *uid_line = strstr(status_contents, "\nUid:");
-        if (uid_line) {
-            sscanf(uid_line + 5, "%u", &uid);
-        }
-        g_free(status_contents);
-    }
-
-    /* Filter by user if needed */
-    if (!collector->show_all_users && uid != collector->current_uid) {
-        return NULL;
-    }
-
-    /* Create process info */
-    XRGProcessInfo *info = g_new0(XRGProcessInfo, 1);
-    info->pid = pid;
-    info->name = read_comm(pid);
-    info->cmdline = read_cmdline(pid);
-    info->state = state;
-    info->uid = uid;
-    info->username = get_username(uid);
-    info->utime = utime;
-    info->stime = stime;
-    info->start_time = starttime;
-    info->nice = nice_val;
-    info->threads = num_threads;
-    info->mem_vsize = vsize;
-    info->mem_rss = rss * collector->page_size;
-
-    /* Calculate memory percentage */
-    if (collector->total_memory > 0) {
-        info->mem_percent = (gdouble)info->mem_rss / collector->total_memory * 100.0;
-    }
-
-    /* CPU percentage will be calculated after we have delta times */
-    info->cpu_percent = 0.0;
-
-    /* Apply name filter if set */
-    if (collector->filter && collector->filter[0] != '\0') {
-        gboolean matches = FALSE;
-        if (info->name && strcasestr(info->name, collector->filter)) {
-            matches = TRUE;
-        } else if (info->cmdline && strcasestr(info->cmdline, collector->filter)) {
-            matches = TRUE;
-        }
-        if (!matches) {
-            xrg_process_info_free(info);
-            return NULL;
-        }
-    }
-
-    return info;
-}
-
 /*============================================================================
  * Sorting
  *============================================================================*/
@@ -258,7 +592,7 @@ static gint compare_processes(gconstpointer a, gconstpointer b, gpointer user_da
 
     gint result = 0;
 
-    switch (collector->sort_by) {
+    switch (collector->rank_by) {
         case XRG_PROCESS_SORT_CPU:
             if (pa->cpu_percent > pb->cpu_percent) result = -1;
             else if (pa->cpu_percent < pb->cpu_percent) result = 1;
@@ -278,6 +612,14 @@ static gint compare_processes(gconstpointer a, gconstpointer b, gpointer user_da
                 result = g_ascii_strcasecmp(pa->name, pb->name);
             }
             break;
+
+        case XRG_PROCESS_SORT_IO: {
+            gdouble io_a = pa->read_rate + pa->write_rate;
+            gdouble io_b = pb->read_rate + pb->write_rate;
+            if (io_a > io_b) result = -1;
+            else if (io_a < io_b) result = 1;
+            break;
+        }
     }
 
     if (!collector->sort_descending) {
@@ -287,6 +629,740 @@ static gint compare_processes(gconstpointer a, gconstpointer b, gpointer user_da
     return result;
 }
 
+/*
+ * Top-N selection. Each heap keeps the worst-ranked process it holds at
+ * the root, so a candidate costs one comparison unless it beats the root
+ * (O(n log k) overall, no allocation).
+ */
+static void heap_sift_down(XRGProcessCollector *collector, ProcessHeap *heap, gint start, gint count) {
+    XRGProcessInfo *items = heap->items;
+    gint i = start;
+
+    for (;;) {
+        gint worst = i;
+        gint left = 2 * i + 1;
+        gint right = left + 1;
+
+        if (left < count && compare_processes(&items[left], &items[worst], collector) > 0)
+            worst = left;
+        if (right < count && compare_processes(&items[right], &items[worst], collector) > 0)
+            worst = right;
+        if (worst == i)
+            break;
+
+        XRGProcessInfo tmp = items[i];
+        items[i] = items[worst];
+        items[worst] = tmp;
+        i = worst;
+    }
+}
+
+static void heap_sift_up(XRGProcessCollector *collector, ProcessHeap *heap, gint i) {
+    XRGProcessInfo *items = heap->items;
+
+    while (i > 0) {
+        gint parent = (i - 1) / 2;
+        if (compare_processes(&items[i], &items[parent], collector) <= 0)
+            break;
+
+        XRGProcessInfo tmp = items[i];
+        items[i] = items[parent];
+        items[parent] = tmp;
+        i = parent;
+    }
+}
+
+static void offer_process(XRGProcessCollector *collector, ProcessHeap *heap, const XRGProcessInfo *info) {
+    if (heap->count < collector->heap_capacity) {
+        heap->items[heap->count] = *info;
+        heap_sift_up(collector, heap, heap->count++);
+    } else if (compare_processes(info, &heap->items[0], collector) < 0) {
+        heap->items[0] = *info;
+        heap_sift_down(collector, heap, 0, heap->count);
+    }
+}
+
+/* Heapsort in place: repeatedly moving the worst entry to the end leaves the array best-first */
+static void sort_heap(XRGProcessCollector *collector, ProcessHeap *heap) {
+    XRGProcessInfo *items = heap->items;
+
+    for (gint end = heap->count - 1; end > 0; end--) {
+        XRGProcessInfo tmp = items[0];
+        items[0] = items[end];
+        items[end] = tmp;
+        heap_sift_down(collector, heap, 0, end);
+    }
+}
+
+/*============================================================================
+ * History
+ *
+ * Slots are handed out on the updating thread to processes that make the
+ * list and evicted least recently listed first, so memory stays fixed as
+ * processes come and go. Once a process holds a slot it gets a sample on
+ * every update it is scanned, listed or not, so a process that spikes now
+ * and then shows its pattern when it returns to the list.
+ *============================================================================*/
+
+static ProcessHistory* history_for_entry(XRGProcessCollector *collector, ProcessCacheEntry *entry) {
+    if (entry->history_slot < 0) return NULL;
+
+    ProcessHistory *history = &collector->history[entry->history_slot];
+    if (history->pid != entry->pid || history->start_time != entry->start_time) {
+        return NULL;    /* Evicted and reused */
+    }
+    return history;
+}
+
+/* Append one sample; runs on scan workers, each entry is visited by one of them */
+static void history_push(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                         gdouble cpu_percent, gdouble mem_percent) {
+    ProcessHistory *history = history_for_entry(collector, entry);
+    if (!history || history->last_pushed == collector->generation) return;
+
+    history->cpu[history->head] = (gfloat)cpu_percent;
+    history->mem[history->head] = (gfloat)mem_percent;
+    history->head = (history->head + 1) % XRG_PROCESS_HISTORY_LENGTH;
+    history->count = MIN(history->count + 1, XRG_PROCESS_HISTORY_LENGTH);
+    history->last_pushed = collector->generation;
+}
+
+/* Give every listed process a slot, evicting the least recently listed */
+static void assign_history_slots(XRGProcessCollector *collector) {
+    for (gint i = 0; i < collector->top.count; i++) {
+        XRGProcessInfo *kept = &collector->top.items[i];
+        if (kept->exited_count > 0) continue;
+
+        ProcessCacheEntry *cached = process_table_lookup(&collector->process_table,
+                                                         kept->pid, kept->start_time);
+        if (!cached) continue;
+
+        ProcessHistory *history = history_for_entry(collector, cached);
+        if (!history) {
+            gint victim = 0;
+            for (gint slot = 1; slot < collector->history_slots && collector->history[victim].pid != 0; slot++) {
+                if (collector->history[slot].pid == 0 ||
+                    collector->history[slot].last_listed < collector->history[victim].last_listed) {
+                    victim = slot;
+                }
+            }
+
+            history = &collector->history[victim];
+            memset(history, 0, sizeof(*history));
+            history->pid = cached->pid;
+            history->start_time = cached->start_time;
+            cached->history_slot = victim;
+
+            /* The scan already ran; this update's sample comes from the record */
+            history_push(collector, cached, kept->cpu_percent, kept->mem_percent);
+        }
+        history->last_listed = collector->generation;
+    }
+}
+
+/*============================================================================
+ * Process Scanning
+ *
+ * The PID list is split into chunks that workers claim with an atomic
+ * counter, so faster workers take more chunks. While workers run,
+ * process_table is only read; entries are written solely by the worker
+ * that owns their PID. PIDs needing a new cache entry are queued per
+ * worker and committed on the updating thread once the scan is done.
+ *============================================================================*/
+
+/* Parse /proc/[pid]/stat text into a sample; copies comm out of the buffer */
+static gboolean parse_stat(const gchar *stat_contents, ProcessSample *sample) {
+    /* Parse stat file - format is complex due to comm field possibly containing spaces/parens */
+    /* Find the last ')' to locate end of comm field */
+    const gchar *comm_start = strchr(stat_contents, '(');
+    const gchar *comm_end = strrchr(stat_contents, ')');
+    if (!comm_start || !comm_end || comm_end < comm_start || comm_end[1] == '\0') return FALSE;
+
+    sample->comm_len = MIN((gsize)(comm_end - comm_start - 1), sizeof(sample->comm) - 1);
+    memcpy(sample->comm, comm_start + 1, sample->comm_len);
+    sample->comm[sample->comm_len] = '\0';
+
+    /* Fields after comm: state, then numbers from ppid through rss */
+    sample->state = comm_end[2];
+    const gchar *p = comm_end + 3;
+    gint fields = 0;
+
+    while (fields < (gint)G_N_ELEMENTS(sample->values)) {
+        gchar *next;
+        sample->values[fields] = strtoll(p, &next, 10);
+        if (next == p) break;
+        p = next;
+        fields++;
+    }
+    return fields == (gint)G_N_ELEMENTS(sample->values);
+}
+
+/*
+ * Turn a sample into a process record and offer it to the worker's heap.
+ * Strings are borrowed from the cache entry; nothing is allocated.
+ */
+static void account_process(ProcessScanWorker *worker, ProcessCacheEntry *entry,
+                            const ProcessSample *sample) {
+    XRGProcessCollector *collector = worker->collector;
+    XRGProcessInfo info = { 0 };
+
+    info.pid = sample->pid;
+    info.name = entry->name;
+    info.cmdline = entry->cmdline;     /* Filled in for the kept processes only */
+    info.state = sample->state;
+    info.uid = entry->uid;
+    info.username = (gchar *)entry->username;
+    info.utime = STAT_FIELD(sample->values, STAT_UTIME);
+    info.stime = STAT_FIELD(sample->values, STAT_STIME);
+    info.start_time = entry->start_time;
+    info.nice = STAT_FIELD(sample->values, STAT_NICE);
+    info.threads = STAT_FIELD(sample->values, STAT_NUM_THREADS);
+    info.mem_vsize = STAT_FIELD(sample->values, STAT_VSIZE);
+    info.mem_rss = STAT_FIELD(sample->values, STAT_RSS) * collector->page_size;
+
+    /* Calculate memory percentage: PSS once it has been probed, RSS until then */
+    if (collector->total_memory > 0) {
+        guint64 mem_bytes = entry->memory_sampled_at ? entry->pss_bytes : info.mem_rss;
+        info.mem_percent = (gdouble)mem_bytes / collector->total_memory * 100.0;
+    }
+
+    /* Calculate CPU percentage using delta from previous update */
+    guint64 proc_total = info.utime + info.stime;
+    if (collector->cpu_delta > 0 && entry->have_sample) {
+        guint64 proc_delta = proc_total - entry->prev_cpu_total;
+        info.cpu_percent = (gdouble)proc_delta / collector->cpu_delta * 100.0;
+    }
+    entry->prev_cpu_total = proc_total;
+    entry->have_sample = TRUE;
+
+    history_push(collector, entry, info.cpu_percent, info.mem_percent);
+
+    worker->total_processes++;
+    if (info.state == 'R') {
+        worker->running_processes++;
+    }
+
+    offer_process(collector, &worker->heap, &info);
+}
+
+/* Scan one PID; runs on any worker thread */
+static void scan_process(ProcessScanWorker *worker, pid_t pid) {
+    XRGProcessCollector *collector = worker->collector;
+
+    gint pid_fd = xrg_proc_reader_open_pid(collector->reader, pid);
+    if (pid_fd < 0) return;
+
+    ProcessSample sample;
+    sample.pid = pid;
+
+    /* User filter first: the owner of /proc/[pid] rejects other users' processes */
+    gboolean have_uid = FALSE;
+    if (!collector->show_all_users) {
+        if (!read_uid(pid_fd, &sample.uid) || sample.uid != collector->current_uid) goto out;
+        have_uid = TRUE;
+    }
+
+    /* Read /proc/[pid]/stat into this worker's buffer */
+    if (xrg_proc_read_at(pid_fd, "stat", &worker->scratch, G_MAXSIZE) <= 0) goto out;
+    if (!parse_stat(worker->scratch.data, &sample)) goto out;
+
+    ProcessCacheEntry *entry = process_table_lookup(&collector->process_table, pid,
+                                                    STAT_FIELD(sample.values, STAT_STARTTIME));
+    if (!entry) {
+        /* New process (or reused PID): the insert waits for the serial commit */
+        if (have_uid || read_uid(pid_fd, &sample.uid)) {
+            g_array_append_val(worker->pending, sample);
+        }
+        goto out;
+    }
+
+    /* Same process, new image: only the name and command line change */
+    if (strlen(entry->name) != sample.comm_len || strcmp(entry->name, sample.comm) != 0) {
+        reset_cache_entry_image(entry, sample.comm, sample.comm_len);
+    }
+    entry->generation = collector->generation;
+    entry->seen_next = worker->seen;
+    worker->seen = entry;
+
+    if (cache_entry_matches_filter(collector, entry, pid_fd, &worker->scratch)) {
+        account_process(worker, entry, &sample);
+    }
+
+out:
+    close(pid_fd);
+}
+
+static void scan_worker_run(ProcessScanWorker *worker) {
+    XRGProcessCollector *collector = worker->collector;
+    gint num_pids = collector->pids->len;
+
+    for (;;) {
+        gint start = g_atomic_int_add(&collector->next_chunk, SCAN_CHUNK_SIZE);
+        if (start >= num_pids) break;
+
+        gint end = MIN(start + SCAN_CHUNK_SIZE, num_pids);
+        for (gint i = start; i < end; i++) {
+            scan_process(worker, g_array_index(collector->pids, pid_t, i));
+        }
+
+        process_table_touch(&collector->process_table, worker->seen);
+        worker->seen = NULL;
+    }
+}
+
+static void scan_pool_func(gpointer data, gpointer user_data) {
+    XRGProcessCollector *collector = user_data;
+
+    scan_worker_run(data);
+
+    g_mutex_lock(&collector->scan_lock);
+    if (--collector->workers_running == 0) {
+        g_cond_signal(&collector->scan_done);
+    }
+    g_mutex_unlock(&collector->scan_lock);
+}
+
+/* Number of workers for this scan, growing the worker array if needed */
+static gint prepare_scan_workers(XRGProcessCollector *collector) {
+    gint num_pids = collector->pids->len;
+    gint threads = 1;
+
+    if (num_pids >= PARALLEL_SCAN_MIN_PIDS) {
+        threads = collector->max_threads > 0 ? collector->max_threads : (gint)g_get_num_processors();
+        gint chunks = (num_pids + SCAN_CHUNK_SIZE - 1) / SCAN_CHUNK_SIZE;
+        threads = CLAMP(threads, 1, MIN(chunks, MAX_SCAN_THREADS));
+    }
+
+    if (threads > collector->num_workers) {
+        collector->workers = g_renew(ProcessScanWorker, collector->workers, threads);
+        for (gint i = collector->num_workers; i < threads; i++) {
+            ProcessScanWorker *worker = &collector->workers[i];
+            worker->collector = collector;
+            xrg_proc_buffer_init(&worker->scratch);
+            worker->heap.items = g_new0(XRGProcessInfo, collector->max_processes * IO_CANDIDATE_FACTOR);
+            worker->pending = g_array_new(FALSE, FALSE, sizeof(ProcessSample));
+        }
+        collector->num_workers = threads;
+    }
+
+    for (gint i = 0; i < threads; i++) {
+        ProcessScanWorker *worker = &collector->workers[i];
+        worker->heap.count = 0;
+        worker->seen = NULL;
+        worker->total_processes = 0;
+        worker->running_processes = 0;
+        g_array_set_size(worker->pending, 0);
+    }
+
+    return threads;
+}
+
+/* Shard the PID list across the pool; the calling thread works as workers[0] */
+static void run_scan(XRGProcessCollector *collector, gint threads) {
+    g_atomic_int_set(&collector->next_chunk, 0);
+
+    if (threads > 1 && !collector->scan_pool) {
+        collector->scan_pool = g_thread_pool_new(scan_pool_func, collector, -1, FALSE, NULL);
+    }
+    if (threads == 1 || !collector->scan_pool) {
+        scan_worker_run(&collector->workers[0]);
+        return;
+    }
+
+    collector->workers_running = threads - 1;
+    for (gint i = 1; i < threads; i++) {
+        g_thread_pool_push(collector->scan_pool, &collector->workers[i], NULL);
+    }
+
+    scan_worker_run(&collector->workers[0]);
+
+    g_mutex_lock(&collector->scan_lock);
+    while (collector->workers_running > 0) {
+        g_cond_wait(&collector->scan_done, &collector->scan_lock);
+    }
+    g_mutex_unlock(&collector->scan_lock);
+}
+
+/* Serial phase: create cache entries for new PIDs, then fold the worker into the totals */
+static void merge_scan_worker(XRGProcessCollector *collector, ProcessScanWorker *worker) {
+    for (guint i = 0; i < worker->pending->len; i++) {
+        ProcessSample *sample = &g_array_index(worker->pending, ProcessSample, i);
+        ProcessCacheEntry *entry = create_cache_entry(collector, sample);
+
+        if (cache_entry_matches_filter(collector, entry, -1, &worker->scratch)) {
+            account_process(worker, entry, sample);
+        }
+    }
+
+    collector->total_processes += worker->total_processes;
+    collector->running_processes += worker->running_processes;
+
+    for (gint i = 0; i < worker->heap.count; i++) {
+        offer_process(collector, &collector->top, &worker->heap.items[i]);
+    }
+}
+
+/*============================================================================
+ * I/O Sampling
+ *
+ * /proc/[pid]/io and status cost two more opens per process, so they are
+ * only read for the processes that survived the scan, after it.
+ *============================================================================*/
+
+/* Helper: Value of a "Key:   N" line in a /proc key-value file */
+static gboolean parse_proc_field(const gchar *text, const gchar *key, guint64 *value) {
+    gsize key_len = strlen(key);
+
+    for (const gchar *line = text; line; line = strchr(line, '\n')) {
+        if (*line == '\n') line++;
+        if (strncmp(line, key, key_len) == 0) {
+            *value = strtoull(line + key_len, NULL, 10);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/* Fill a kept record's I/O and context-switch rates from its counters */
+static void sample_process_io(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                              XRGProcessInfo *info, XRGProcBuffer *buf) {
+    gint pid_fd = xrg_proc_reader_open_pid(collector->reader, entry->pid);
+    if (pid_fd < 0) return;
+
+    guint64 read_bytes = 0, write_bytes = 0, voluntary = 0, nonvoluntary = 0;
+
+    /* io needs ptrace access: other users' processes fail unless we are root */
+    info->has_io = xrg_proc_read_at(pid_fd, "io", buf, G_MAXSIZE) > 0 &&
+                   parse_proc_field(buf->data, "read_bytes:", &read_bytes) &&
+                   parse_proc_field(buf->data, "write_bytes:", &write_bytes);
+
+    gboolean have_ctxt = xrg_proc_read_at(pid_fd, "status", buf, G_MAXSIZE) > 0 &&
+                         parse_proc_field(buf->data, "voluntary_ctxt_switches:", &voluntary) &&
+                         parse_proc_field(buf->data, "nonvoluntary_ctxt_switches:", &nonvoluntary);
+    close(pid_fd);
+
+    /* Rates only against a sample from the previous update */
+    gboolean have_baseline = entry->io_generation != 0 &&
+                             entry->io_generation == collector->generation - 1 &&
+                             collector->time_delta > 0;
+
+    if (have_baseline && info->has_io) {
+        info->read_rate = (read_bytes - entry->prev_read_bytes) / collector->time_delta;
+        info->write_rate = (write_bytes - entry->prev_write_bytes) / collector->time_delta;
+    }
+    if (have_baseline && have_ctxt) {
+        info->voluntary_ctxt_rate = (voluntary - entry->prev_voluntary_ctxt) / collector->time_delta;
+        info->nonvoluntary_ctxt_rate = (nonvoluntary - entry->prev_nonvoluntary_ctxt) / collector->time_delta;
+    }
+
+    entry->prev_read_bytes = read_bytes;
+    entry->prev_write_bytes = write_bytes;
+    entry->prev_voluntary_ctxt = voluntary;
+    entry->prev_nonvoluntary_ctxt = nonvoluntary;
+    entry->io_generation = collector->generation;
+}
+
+/* Second pass over the kept processes; when sorting by I/O, re-rank them by it */
+static void sample_top_processes_io(XRGProcessCollector *collector) {
+    XRGProcBuffer *buf = &collector->workers[0].scratch;
+
+    for (gint i = 0; i < collector->top.count; i++) {
+        XRGProcessInfo *kept = &collector->top.items[i];
+        if (kept->exited_count > 0) continue;
+
+        ProcessCacheEntry *cached = process_table_lookup(&collector->process_table,
+                                                         kept->pid, kept->start_time);
+        if (cached) {
+            sample_process_io(collector, cached, kept, buf);
+        }
+    }
+
+    if (collector->sort_by != XRG_PROCESS_SORT_IO) return;
+
+    gint count = collector->top.count;
+    memcpy(collector->candidates, collector->top.items, count * sizeof(XRGProcessInfo));
+
+    collector->rank_by = XRG_PROCESS_SORT_IO;
+    collector->heap_capacity = collector->max_processes;
+    collector->top.count = 0;
+    for (gint i = 0; i < count; i++) {
+        offer_process(collector, &collector->top, &collector->candidates[i]);
+    }
+}
+
+/*============================================================================
+ * Memory Probes
+ *
+ * The only cost that counts against the budget is CPU time of the
+ * updating thread, which includes the kernel's page table walk for
+ * smaps_rollup. A probe runs only if its predicted cost (its own last
+ * cost, or the running average for a process never probed) fits what is
+ * left. The hovered process is probed regardless, and every
+ * PROBE_OVER_BUDGET_EVERY updates the stalest skipped process is too, so
+ * a process that once cost more than the budget does not keep its first
+ * PSS forever.
+ *============================================================================*/
+
+static gint64 thread_cpu_time_us(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return (gint64)ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000;
+}
+
+static void probe_process_memory(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                                 XRGProcBuffer *buf) {
+    gint pid_fd = xrg_proc_reader_open_pid(collector->reader, entry->pid);
+    if (pid_fd < 0) return;
+
+    guint64 pss_kb = 0, private_clean_kb = 0, private_dirty_kb = 0;
+    if (xrg_proc_read_at(pid_fd, "smaps_rollup", buf, G_MAXSIZE) > 0 &&
+        parse_proc_field(buf->data, "Pss:", &pss_kb) &&
+        parse_proc_field(buf->data, "Private_Clean:", &private_clean_kb) &&
+        parse_proc_field(buf->data, "Private_Dirty:", &private_dirty_kb)) {
+        entry->pss_bytes = pss_kb * 1024;
+        entry->uss_bytes = (private_clean_kb + private_dirty_kb) * 1024;
+        entry->memory_sampled_at = g_get_monotonic_time();
+    } else {
+        entry->probe_failed = TRUE;
+    }
+    close(pid_fd);
+}
+
+/* Probe one entry if it fits the budget left, or if forced; FALSE if it was skipped for cost */
+static gboolean run_memory_probe(XRGProcessCollector *collector, ProcessCacheEntry *entry,
+                                 gint64 budget_start, gboolean force, XRGProcBuffer *buf) {
+    gint64 predicted = entry->probe_cost_us > 0 ? entry->probe_cost_us : collector->probe_cost_avg_us;
+    gint64 t0 = thread_cpu_time_us();
+    if (!force && t0 - budget_start + predicted > collector->probe_budget_us) return FALSE;
+
+    probe_process_memory(collector, entry, buf);
+
+    entry->probe_cost_us = MAX(thread_cpu_time_us() - t0, 1);
+    collector->probe_cost_avg_us = (collector->probe_cost_avg_us * 7 + entry->probe_cost_us) / 8;
+    return TRUE;
+}
+
+/* Refresh PSS/USS for the listed processes, stalest first, then copy them into the records */
+static void probe_top_processes_memory(XRGProcessCollector *collector) {
+    if (collector->top.count == 0) return;
+
+    XRGProcBuffer *buf = &collector->workers[0].scratch;
+    ProcessCacheEntry **listed = g_new(ProcessCacheEntry *, collector->top.count);
+    gint num_listed = 0;
+
+    for (gint i = 0; i < collector->top.count; i++) {
+        XRGProcessInfo *kept = &collector->top.items[i];
+        ProcessCacheEntry *cached = kept->exited_count > 0 ? NULL :
+            process_table_lookup(&collector->process_table, kept->pid, kept->start_time);
+        if (cached && !cached->probe_failed) {
+            listed[num_listed++] = cached;
+        }
+    }
+
+    if (collector->probe_budget_us > 0) {
+        gint64 budget_start = thread_cpu_time_us();
+        gboolean allow_over_budget = ++collector->probe_updates % PROBE_OVER_BUDGET_EVERY == 0;
+
+        /* Selection by age, so skipped processes come first next time */
+        for (gint done = 0; done < num_listed; done++) {
+            gint pick = done;
+            for (gint i = done + 1; i < num_listed; i++) {
+                gboolean i_hovered = listed[i]->pid == collector->probe_pid;
+                gboolean pick_hovered = listed[pick]->pid == collector->probe_pid;
+                if (i_hovered != pick_hovered ? i_hovered
+                                              : listed[i]->memory_sampled_at < listed[pick]->memory_sampled_at) {
+                    pick = i;
+                }
+            }
+            ProcessCacheEntry *tmp = listed[done];
+            listed[done] = listed[pick];
+            listed[pick] = tmp;
+
+            /* Stalest first, so the skipped process let through rotates */
+            gboolean hovered = listed[done]->pid == collector->probe_pid;
+            if (!run_memory_probe(collector, listed[done], budget_start, hovered, buf) && allow_over_budget) {
+                run_memory_probe(collector, listed[done], budget_start, TRUE, buf);
+                allow_over_budget = FALSE;
+            }
+        }
+    }
+    g_free(listed);
+
+    gint64 now = g_get_monotonic_time();
+    for (gint i = 0; i < collector->top.count; i++) {
+        XRGProcessInfo *kept = &collector->top.items[i];
+        ProcessCacheEntry *cached = kept->exited_count > 0 ? NULL :
+            process_table_lookup(&collector->process_table, kept->pid, kept->start_time);
+
+        if (cached && cached->memory_sampled_at) {
+            kept->mem_pss = cached->pss_bytes;
+            kept->mem_uss = cached->uss_bytes;
+            kept->mem_sample_age = (now - cached->memory_sampled_at) / (gdouble)G_USEC_PER_SEC;
+            if (collector->total_memory > 0) {
+                kept->mem_percent = (gdouble)cached->pss_bytes / collector->total_memory * 100.0;
+            }
+        } else {
+            kept->mem_sample_age = -1.0;
+        }
+    }
+
+    /* Fresh PSS can reorder a list ranked by memory */
+    if (collector->rank_by == XRG_PROCESS_SORT_MEMORY) {
+        for (gint i = collector->top.count / 2 - 1; i >= 0; i--) {
+            heap_sift_down(collector, &collector->top, i, collector->top.count);
+        }
+        sort_heap(collector, &collector->top);
+    }
+}
+
+/*============================================================================
+ * Event Tracking
+ *
+ * Between reconciliation scans the PID list is rebuilt from the process
+ * table plus this update's fork and exit events, so /proc itself is not
+ * listed. Exit events carry the final CPU time read from the zombie,
+ * which is what makes processes that live less than an update visible.
+ *============================================================================*/
+
+/* Drain events and record what happened to each PID; FALSE if events were lost */
+static gboolean drain_process_events(XRGProcessCollector *collector) {
+    gboolean complete = xrg_proc_events_drain(collector->events, collector->event_buf);
+
+    collector->forks = collector->execs = collector->exits = 0;
+    g_hash_table_remove_all(collector->event_pids);
+
+    /* In order, so a PID that exits and is reused within one update ends up forked */
+    for (guint i = 0; i < collector->event_buf->len; i++) {
+        XRGProcEvent *event = &g_array_index(collector->event_buf, XRGProcEvent, i);
+        switch (event->type) {
+            case XRG_PROC_EVENT_FORK:
+                collector->forks++;
+                g_hash_table_insert(collector->event_pids, GINT_TO_POINTER(event->pid),
+                                    GINT_TO_POINTER(PID_FORKED));
+                break;
+            case XRG_PROC_EVENT_EXEC:
+                collector->execs++;     /* The scan notices the new comm */
+                break;
+            case XRG_PROC_EVENT_EXIT:
+                collector->exits++;
+                g_hash_table_insert(collector->event_pids, GINT_TO_POINTER(event->pid),
+                                    GINT_TO_POINTER(PID_EXITED));
+                break;
+        }
+    }
+    return complete;
+}
+
+/* Known processes that have not exited, plus the ones forked since the last update */
+static void list_pids_from_events(XRGProcessCollector *collector) {
+    g_array_set_size(collector->pids, 0);
+
+    for (ProcessCacheEntry *entry = collector->process_table.lru_head; entry; entry = entry->lru_next) {
+        if (!g_hash_table_contains(collector->event_pids, GINT_TO_POINTER(entry->pid))) {
+            g_array_append_val(collector->pids, entry->pid);
+        }
+    }
+
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, collector->event_pids);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (GPOINTER_TO_INT(value) == PID_FORKED) {
+            pid_t pid = GPOINTER_TO_INT(key);
+            g_array_append_val(collector->pids, pid);
+        }
+    }
+}
+
+/*
+ * Fold this update's exits into one record per name and offer those to the
+ * top list. CPU is charged from the cache entry's last sample, so nothing is
+ * counted twice; must run before the sweep drops the exited entries.
+ */
+static void account_exited_processes(XRGProcessCollector *collector) {
+    g_array_set_size(collector->exited_groups, 0);
+
+    for (guint i = 0; i < collector->event_buf->len; i++) {
+        XRGProcEvent *event = &g_array_index(collector->event_buf, XRGProcEvent, i);
+        if (event->type != XRG_PROC_EVENT_EXIT || !event->captured) continue;
+        if (!collector->show_all_users && event->uid != collector->current_uid) continue;
+        if (collector->filter_lower &&
+            !text_matches_filter(event->comm, strlen(event->comm),
+                                 collector->filter_lower, collector->filter_len)) continue;
+
+        ProcessCacheEntry *entry = process_table_lookup(&collector->process_table,
+                                                        event->pid, event->start_time);
+        guint64 baseline = entry ? entry->prev_cpu_total : 0;
+        guint64 ticks = event->cpu_total > baseline ? event->cpu_total - baseline : 0;
+
+        ExitedProcessGroup *group = NULL;
+        for (guint j = 0; j < collector->exited_groups->len; j++) {
+            ExitedProcessGroup *candidate = &g_array_index(collector->exited_groups, ExitedProcessGroup, j);
+            if (candidate->uid == event->uid && strcmp(candidate->name, event->comm) == 0) {
+                group = candidate;
+                break;
+            }
+        }
+        if (!group) {
+            g_array_set_size(collector->exited_groups, collector->exited_groups->len + 1);
+            group = &g_array_index(collector->exited_groups, ExitedProcessGroup,
+                                   collector->exited_groups->len - 1);
+            memset(group, 0, sizeof(*group));
+            g_strlcpy(group->name, event->comm, sizeof(group->name));
+            group->uid = event->uid;
+        }
+        group->last_pid = event->pid;
+        group->count++;
+        group->cpu_ticks += ticks;
+    }
+
+    for (guint i = 0; i < collector->exited_groups->len; i++) {
+        ExitedProcessGroup *group = &g_array_index(collector->exited_groups, ExitedProcessGroup, i);
+        if (group->cpu_ticks == 0 || collector->cpu_delta == 0) continue;
+
+        XRGProcessInfo info = { 0 };
+        info.pid = group->last_pid;
+        info.name = group->name;
+        info.state = 'X';
+        info.uid = group->uid;
+        info.username = (gchar *)lookup_username(collector, group->uid);
+        info.cpu_percent = (gdouble)group->cpu_ticks / collector->cpu_delta * 100.0;
+        info.exited_count = group->count;
+        offer_process(collector, &collector->top, &info);
+    }
+}
+
+/*============================================================================
+ * Thread Drill-Down
+ *
+ * Runs on the updating thread, independently of the full update. The task
+ * directory and every thread's directory stay open, so an update is one
+ * getdents64 pass plus one openat/read per thread.
+ *============================================================================*/
+
+static gboolean thread_cache_entry_is_stale(gpointer key, gpointer value, gpointer user_data) {
+    (void)key;
+    ThreadCacheEntry *thread = value;
+    return thread->generation != GPOINTER_TO_UINT(user_data);
+}
+
+static gint compare_threads(gconstpointer a, gconstpointer b) {
+    const XRGThreadInfo *ta = a, *tb = b;
+    if (ta->cpu_percent != tb->cpu_percent) return ta->cpu_percent < tb->cpu_percent ? 1 : -1;
+    return ta->tid - tb->tid;
+}
+
+static void clear_thread_view(XRGProcessCollector *collector) {
+    if (collector->task_fd >= 0) {
+        close(collector->task_fd);
+        collector->task_fd = -1;
+    }
+    collector->thread_pid = 0;
+    collector->last_thread_update = 0;
+    g_hash_table_remove_all(collector->thread_cache);
+    g_array_set_size(collector->threads, 0);
+}
+
 /*============================================================================
  * Public API
  *============================================================================*/
@@ -295,14 +1371,35 @@ XRGProcessCollector* xrg_process_collector_new(gint max_processes) {
     XRGProcessCollector *collector = g_new0(XRGProcessCollector, 1);
 
     collector->max_processes = max_processes > 0 ? max_processes : 10;
+    collector->top.items = g_new0(XRGProcessInfo, collector->max_processes * IO_CANDIDATE_FACTOR);
+    collector->candidates = g_new0(XRGProcessInfo, collector->max_processes * IO_CANDIDATE_FACTOR);
+    collector->history_slots = collector->max_processes * HISTORY_POOL_FACTOR;
+    collector->history = g_new0(ProcessHistory, collector->history_slots);
     collector->sort_by = XRG_PROCESS_SORT_CPU;
+    collector->rank_by = XRG_PROCESS_SORT_CPU;
+    collector->heap_capacity = collector->max_processes;
+    collector->probe_budget_us = DEFAULT_PROBE_BUDGET_US;
+    collector->probe_cost_avg_us = PROBE_COST_INITIAL_US;
     collector->sort_descending = TRUE;
     collector->show_all_users = TRUE;
     collector->current_uid = getuid();
     collector->page_size = sysconf(_SC_PAGESIZE);
     collector->clock_ticks = sysconf(_SC_CLK_TCK);
     collector->total_memory = get_total_memory();
-    collector->prev_cpu_times = g_hash_table_new(g_direct_hash, g_direct_equal);
+    process_table_init(&collector->process_table);
+    collector->user_names = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    collector->reader = xrg_proc_reader_new();
+    collector->pids = g_array_new(FALSE, FALSE, sizeof(pid_t));
+    g_mutex_init(&collector->scan_lock);
+    g_cond_init(&collector->scan_done);
+    collector->event_buf = g_array_new(FALSE, FALSE, sizeof(XRGProcEvent));
+    collector->event_pids = g_hash_table_new(g_direct_hash, g_direct_equal);
+    collector->exited_groups = g_array_new(FALSE, FALSE, sizeof(ExitedProcessGroup));
+    collector->task_fd = -1;
+    collector->thread_cache = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    collector->tids = g_array_new(FALSE, FALSE, sizeof(pid_t));
+    collector->threads = g_array_new(FALSE, FALSE, sizeof(XRGThreadInfo));
+    xrg_proc_buffer_init(&collector->thread_buf);
 
     return collector;
 }
@@ -310,12 +1407,42 @@ XRGProcessCollector* xrg_process_collector_new(gint max_processes) {
 void xrg_process_collector_free(XRGProcessCollector *collector) {
     if (!collector) return;
 
-    /* Free process list */
-    g_list_free_full(collector->processes, (GDestroyNotify)xrg_process_info_free);
+    xrg_proc_events_free(collector->events);
+    g_array_free(collector->event_buf, TRUE);
+    g_hash_table_destroy(collector->event_pids);
+    g_array_free(collector->exited_groups, TRUE);
+
+    clear_thread_view(collector);
+    g_hash_table_destroy(collector->thread_cache);
+    g_array_free(collector->tids, TRUE);
+    g_array_free(collector->threads, TRUE);
+    xrg_proc_buffer_clear(&collector->thread_buf);
+
+    /* Wait for idle pool threads to exit before tearing down their workers */
+    if (collector->scan_pool) {
+        g_thread_pool_free(collector->scan_pool, FALSE, TRUE);
+    }
+    for (gint i = 0; i < collector->num_workers; i++) {
+        xrg_proc_buffer_clear(&collector->workers[i].scratch);
+        g_free(collector->workers[i].heap.items);
+        g_array_free(collector->workers[i].pending, TRUE);
+    }
+    g_free(collector->workers);
+    g_mutex_clear(&collector->scan_lock);
+    g_cond_clear(&collector->scan_done);
+
+    /* Process records borrow their strings from process_table */
+    g_free(collector->top.items);
+    g_free(collector->candidates);
+    g_free(collector->history);
 
     /* Free other resources */
     g_free(collector->filter);
-    g_hash_table_destroy(collector->prev_cpu_times);
+    g_free(collector->filter_lower);
+    process_table_clear(&collector->process_table);
+    g_hash_table_destroy(collector->user_names);
+    xrg_proc_reader_free(collector->reader);
+    g_array_free(collector->pids, TRUE);
 
     g_free(collector);
 }
@@ -325,109 +1452,127 @@ void xrg_process_collector_update(XRGProcessCollector *collector) {
 
     /* Get current system state */
     guint64 total_cpu = get_total_cpu_time();
-    guint64 cpu_delta = total_cpu - collector->prev_total_cpu;
+    collector->cpu_delta = total_cpu - collector->prev_total_cpu;
     collector->prev_total_cpu = total_cpu;
     collector->uptime_seconds = get_uptime();
+    collector->generation++;
 
-    /* Free old process list */
-    g_list_free_full(collector->processes, (GDestroyNotify)xrg_process_info_free);
-    collector->processes = NULL;
+    gint64 now = g_get_monotonic_time();
+    collector->time_delta = collector->last_update_time ? (now - collector->last_update_time) / 1000000.0 : 0.0;
+    collector->last_update_time = now;
 
-    /* Read /proc directory */
-    DIR *dir = opendir("/proc");
-    if (!dir) return;
-
-    collector->total_processes = 0;
-    collector->running_processes = 0;
+    if (!collector->reader) return;
 
-    GList *all_processes = NULL;
-    struct dirent *entry;
-
-    while ((entry = readdir(dir)) != NULL) {
-        /* Skip non-numeric entries */
-        if (!isdigit(entry->d_name[0])) continue;
-
-        pid_t pid = atoi(entry->d_name);
-        if (pid <= 0) continue;
+    /* With complete events, only periodically list /proc (getdents64 over the held dirfd) */
+    gboolean incremental = FALSE;
+    if (collector->events) {
+        gboolean complete = drain_process_events(collector);
+        if (complete && ++collector->updates_since_reconcile < RECONCILE_INTERVAL) {
+            incremental = TRUE;
+        } else {
+            collector->updates_since_reconcile = 0;
+        }
+    }
 
-        XRGProcessInfo *info = parse_process(collector, pid);
-        if (!info) continue;
+    if (incremental) {
+        list_pids_from_events(collector);
+    } else if (!xrg_proc_reader_list_pids(collector->reader, collector->pids)) {
+        return;
+    }
 
-        collector->total_processes++;
-        if (info->state == 'R') {
-            collector->running_processes++;
-        }
+    collector->top.count = 0;
+    collector->total_processes = 0;
+    collector->running_processes = 0;
 
-        /* Calculate CPU percentage using delta from previous update */
-        guint64 proc_total = info->utime + info->stime;
-        guint64 prev_total = GPOINTER_TO_SIZE(
-            g_hash_table_lookup(collector->prev_cpu_times, GINT_TO_POINTER(pid)));
+    /* Ranking by I/O needs counters the scan does not read: keep extra candidates by CPU */
+    if (collector->sort_by == XRG_PROCESS_SORT_IO) {
+        collector->rank_by = XRG_PROCESS_SORT_CPU;
+        collector->heap_capacity = collector->max_processes * IO_CANDIDATE_FACTOR;
+    } else {
+        collector->rank_by = collector->sort_by;
+        collector->heap_capacity = collector->max_processes;
+    }
 
-        if (cpu_delta > 0 && prev_total > 0) {
-            guint64 proc_delta = proc_total - prev_total;
-            info->cpu_percent = (gdouble)proc_delta / cpu_delta * 100.0;
-        }
+    gint threads = prepare_scan_workers(collector);
+    run_scan(collector, threads);
 
-        /* Store for next update */
-        g_hash_table_insert(collector->prev_cpu_times,
-                           GINT_TO_POINTER(pid),
-                           GSIZE_TO_POINTER(proc_total));
+    for (gint i = 0; i < threads; i++) {
+        merge_scan_worker(collector, &collector->workers[i]);
+    }
 
-        all_processes = g_list_prepend(all_processes, info);
+    if (collector->events) {
+        account_exited_processes(collector);
     }
-    closedir(dir);
 
-    /* Sort processes */
-    all_processes = g_list_sort_with_data(all_processes, compare_processes, collector);
+    sample_top_processes_io(collector);
 
-    /* Keep only top N processes, free the rest */
-    gint count = 0;
-    GList *l = all_processes;
-    while (l != NULL) {
-        GList *next = l->next;  /* Save next pointer before any modifications */
-        XRGProcessInfo *info = l->data;
+    /* Drop cached data for processes that have exited */
+    process_table_sweep(&collector->process_table, collector->generation);
 
-        if (count < collector->max_processes) {
-            /* Keep this process */
-            collector->processes = g_list_append(collector->processes, info);
-            count++;
-        } else {
-            /* Free this process (over the limit) */
-            xrg_process_info_free(info);
+    sort_heap(collector, &collector->top);
+
+    /* Command lines are only needed for the processes actually shown */
+    for (gint i = 0; i < collector->top.count; i++) {
+        XRGProcessInfo *kept = &collector->top.items[i];
+        ProcessCacheEntry *cached = process_table_lookup(&collector->process_table,
+                                                         kept->pid, kept->start_time);
+        if (cached) {
+            kept->cmdline = (gchar *)get_cache_entry_cmdline(collector, cached, -1,
+                                                             &collector->workers[0].scratch);
         }
-        l = next;
     }
 
-    /* Free the GList nodes (data already handled above) */
-    g_list_free(all_processes);
-
-    /* Clean up stale entries from prev_cpu_times */
-    /* (This is a simplification - could be optimized) */
+    assign_history_slots(collector);
+    probe_top_processes_memory(collector);
 }
 
-GList* xrg_process_collector_get_processes(XRGProcessCollector *collector) {
-    return collector ? collector->processes : NULL;
+const XRGProcessInfo* xrg_process_collector_get_processes(XRGProcessCollector *collector) {
+    return collector ? collector->top.items : NULL;
 }
 
 gint xrg_process_collector_get_process_count(XRGProcessCollector *collector) {
-    return collector ? g_list_length(collector->processes) : 0;
+    return collector ? collector->top.count : 0;
 }
 
-XRGProcessInfo* xrg_process_collector_get_process(XRGProcessCollector *collector, pid_t pid) {
+const XRGProcessInfo* xrg_process_collector_get_process_at(XRGProcessCollector *collector, gint index) {
+    if (!collector || index < 0 || index >= collector->top.count) return NULL;
+    return &collector->top.items[index];
+}
+
+const XRGProcessInfo* xrg_process_collector_get_process(XRGProcessCollector *collector, pid_t pid) {
     if (!collector) return NULL;
 
-    for (GList *l = collector->processes; l != NULL; l = l->next) {
-        XRGProcessInfo *info = l->data;
-        if (info->pid == pid) {
-            return info;
+    for (gint i = 0; i < collector->top.count; i++) {
+        if (collector->top.items[i].pid == pid) {
+            return &collector->top.items[i];
         }
     }
     return NULL;
 }
 
+gint xrg_process_collector_get_history(XRGProcessCollector *collector, const XRGProcessInfo *proc,
+                                       gfloat *cpu, gfloat *mem, gint max) {
+    if (!collector || !proc || proc->exited_count > 0) return 0;
+
+    ProcessCacheEntry *cached = process_table_lookup(&collector->process_table, proc->pid, proc->start_time);
+    ProcessHistory *history = cached ? history_for_entry(collector, cached) : NULL;
+    if (!history) return 0;
+
+    /* Newest max samples, oldest first */
+    gint count = MIN(history->count, MIN(max, XRG_PROCESS_HISTORY_LENGTH));
+    gint index = (history->head - count + XRG_PROCESS_HISTORY_LENGTH) % XRG_PROCESS_HISTORY_LENGTH;
+    for (gint i = 0; i < count; i++) {
+        if (cpu) cpu[i] = history->cpu[index];
+        if (mem) mem[i] = history->mem[index];
+        index = (index + 1) % XRG_PROCESS_HISTORY_LENGTH;
+    }
+    return count;
+}
+
 void xrg_process_collector_set_sort_by(XRGProcessCollector *collector, XRGProcessSortBy sort_by) {
     if (collector) {
         collector->sort_by = sort_by;
+        collector->rank_by = sort_by;
     }
 }
 
@@ -447,6 +1592,10 @@ gboolean xrg_process_collector_get_sort_descending(XRGProcessCollector *collecto
 
 void xrg_process_collector_set_show_all_users(XRGProcessCollector *collector, gboolean show_all) {
     if (collector) {
+        /* Processes of other users are not in the table: widening needs a full scan */
+        if (show_all && !collector->show_all_users) {
+            collector->updates_since_reconcile = RECONCILE_INTERVAL;
+        }
         collector->show_all_users = show_all;
     }
 }
@@ -458,7 +1607,13 @@ gboolean xrg_process_collector_get_show_all_users(XRGProcessCollector *collector
 void xrg_process_collector_set_filter(XRGProcessCollector *collector, const gchar *filter) {
     if (collector) {
         g_free(collector->filter);
+        g_free(collector->filter_lower);
         collector->filter = filter ? g_strdup(filter) : NULL;
+
+        /* Compile once: lowercase the needle, invalidate cached verdicts */
+        collector->filter_lower = (filter && filter[0] != '\0') ? g_ascii_strdown(filter, -1) : NULL;
+        collector->filter_len = collector->filter_lower ? strlen(collector->filter_lower) : 0;
+        collector->filter_generation++;
     }
 }
 
@@ -466,6 +1621,150 @@ const gchar* xrg_process_collector_get_filter(XRGProcessCollector *collector) {
     return collector ? collector->filter : NULL;
 }
 
+void xrg_process_collector_set_max_threads(XRGProcessCollector *collector, gint max_threads) {
+    if (collector) {
+        collector->max_threads = CLAMP(max_threads, 0, MAX_SCAN_THREADS);
+    }
+}
+
+gint xrg_process_collector_get_max_threads(XRGProcessCollector *collector) {
+    return collector ? collector->max_threads : 0;
+}
+
+void xrg_process_collector_set_probe_budget(XRGProcessCollector *collector, gint budget_us) {
+    if (collector) {
+        collector->probe_budget_us = MAX(budget_us, 0);
+    }
+}
+
+gint xrg_process_collector_get_probe_budget(XRGProcessCollector *collector) {
+    return collector ? collector->probe_budget_us : 0;
+}
+
+void xrg_process_collector_set_probe_pid(XRGProcessCollector *collector, pid_t pid) {
+    if (collector) {
+        collector->probe_pid = pid;
+    }
+}
+
+gboolean xrg_process_collector_set_thread_pid(XRGProcessCollector *collector, pid_t pid) {
+    if (!collector) return FALSE;
+    if (pid == collector->thread_pid) return pid == 0 || collector->task_fd >= 0;
+
+    clear_thread_view(collector);
+    if (pid <= 0) return TRUE;
+
+    gint pid_fd = xrg_proc_reader_open_pid(collector->reader, pid);
+    if (pid_fd < 0) return FALSE;
+    collector->task_fd = openat(pid_fd, "task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    close(pid_fd);
+    if (collector->task_fd < 0) return FALSE;
+
+    collector->thread_pid = pid;
+    return TRUE;
+}
+
+pid_t xrg_process_collector_get_thread_pid(XRGProcessCollector *collector) {
+    return collector ? collector->thread_pid : 0;
+}
+
+void xrg_process_collector_update_threads(XRGProcessCollector *collector) {
+    if (!collector || collector->task_fd < 0) return;
+
+    gint64 now = g_get_monotonic_time();
+    gdouble elapsed = collector->last_thread_update > 0 ?
+        (now - collector->last_thread_update) / (gdouble)G_USEC_PER_SEC : 0.0;
+    collector->last_thread_update = now;
+    collector->thread_generation++;
+
+    /* The held task directory lists nothing once the process is gone */
+    g_array_set_size(collector->threads, 0);
+    xrg_proc_reader_list_dir(collector->reader, collector->task_fd, collector->tids);
+
+    /*
+     * Each stat is opened relative to the held task directory, so a process
+     * with thousands of threads costs one fd rather than one per thread
+     */
+    for (guint i = 0; i < collector->tids->len; i++) {
+        pid_t tid = g_array_index(collector->tids, pid_t, i);
+        gchar name[32];
+        g_snprintf(name, sizeof(name), "%d/stat", tid);
+
+        ProcessSample sample;
+        if (xrg_proc_read_at(collector->task_fd, name, &collector->thread_buf, G_MAXSIZE) <= 0 ||
+            !parse_stat(collector->thread_buf.data, &sample)) {
+            continue;   /* Exited since the listing; swept next time */
+        }
+
+        guint64 start_time = STAT_FIELD(sample.values, STAT_STARTTIME);
+        ThreadCacheEntry *thread = g_hash_table_lookup(collector->thread_cache, GINT_TO_POINTER(tid));
+        if (!thread || thread->start_time != start_time) {
+            thread = g_new0(ThreadCacheEntry, 1);
+            thread->tid = tid;
+            thread->start_time = start_time;
+            g_hash_table_replace(collector->thread_cache, GINT_TO_POINTER(tid), thread);
+        }
+        thread->generation = collector->thread_generation;
+
+        XRGThreadInfo info = { 0 };
+        info.tid = tid;
+        g_strlcpy(info.name, sample.comm, sizeof(info.name));
+        info.state = sample.state;
+
+        guint64 cpu_total = STAT_FIELD(sample.values, STAT_UTIME) + STAT_FIELD(sample.values, STAT_STIME);
+        if (elapsed > 0 && thread->have_sample && cpu_total >= thread->prev_cpu_total) {
+            info.cpu_percent = (cpu_total - thread->prev_cpu_total) /
+                               (gdouble)collector->clock_ticks / elapsed * 100.0;
+        }
+        thread->prev_cpu_total = cpu_total;
+        thread->have_sample = TRUE;
+
+        g_array_append_val(collector->threads, info);
+    }
+
+    g_hash_table_foreach_remove(collector->thread_cache, thread_cache_entry_is_stale,
+                                GUINT_TO_POINTER(collector->thread_generation));
+    g_array_sort(collector->threads, compare_threads);
+}
+
+gint xrg_process_collector_get_thread_count(XRGProcessCollector *collector) {
+    return collector ? (gint)collector->threads->len : 0;
+}
+
+const XRGThreadInfo* xrg_process_collector_get_thread_at(XRGProcessCollector *collector, gint index) {
+    if (!collector || index < 0 || index >= (gint)collector->threads->len) return NULL;
+    return &g_array_index(collector->threads, XRGThreadInfo, index);
+}
+
+gboolean xrg_process_collector_set_event_tracking(XRGProcessCollector *collector, gboolean enabled) {
+    if (!collector) return FALSE;
+
+    if (enabled && !collector->events) {
+        collector->events = xrg_proc_events_new();
+        if (!collector->events) {
+            g_message("Process event tracking unavailable (needs CAP_NET_ADMIN); polling /proc");
+        }
+        /* Events only cover changes from now on: start from a full scan */
+        collector->updates_since_reconcile = RECONCILE_INTERVAL;
+    } else if (!enabled && collector->events) {
+        xrg_proc_events_free(collector->events);
+        collector->events = NULL;
+        collector->forks = collector->execs = collector->exits = 0;
+    }
+    return collector->events != NULL;
+}
+
+gboolean xrg_process_collector_get_event_tracking(XRGProcessCollector *collector) {
+    return collector ? collector->events != NULL : FALSE;
+}
+
+void xrg_process_collector_get_event_counts(XRGProcessCollector *collector,
+                                            gint *forks, gint *execs, gint *exits) {
+    if (forks) *forks = collector ? collector->forks : 0;
+    if (execs) *execs = collector ? collector->execs : 0;
+    if (exits) *exits = collector ? collector->exits : 0;
+}
+
 gint xrg_process_collector_get_total_processes(XRGProcessCollector *collector) {
     return collector ? collector->total_processes : 0;
 }
@@ -20,7 +20,7 @@ typedef struct {
     gchar *cmdline;         /* Command line (truncated) */
     gchar state;            /* Process state (R, S, D, Z, etc.) */
     gdouble cpu_percent;    /* CPU usage percentage */
-    gdouble mem_percent;    /* Memory usage percentage */
+    gdouble mem_percent;    /* Memory usage percentage: of PSS once probed, of RSS until then */
     guint64 mem_rss;        /* Resident set size in bytes */
     guint64 mem_vsize;      /* Virtual memory size in bytes */
     uid_t uid;              /* User ID */
@@ -30,8 +30,31 @@ typedef struct {
     guint64 start_time;     /* Start time (jiffies since boot) */
     gint nice;              /* Nice value */
     gint threads;           /* Number of threads */
+    gint exited_count;      /* > 0: processes named name that exited since the last update */
+
+    /* Sampled only for the listed processes; rates need two consecutive samples */
+    gboolean has_io;                 /* /proc/[pid]/io was readable (own processes or root) */
+    gdouble read_rate;               /* Bytes read from storage per second */
+    gdouble write_rate;              /* Bytes written to storage per second */
+    gdouble voluntary_ctxt_rate;     /* Context switches per second: blocked or yielded */
+    gdouble nonvoluntary_ctxt_rate;  /* Context switches per second: preempted */
+
+    /* From smaps_rollup, refreshed for listed processes within the probe budget */
+    guint64 mem_pss;        /* Bytes, shared pages split among the processes mapping them */
+    guint64 mem_uss;        /* Bytes private to this process */
+    gdouble mem_sample_age; /* Seconds since mem_pss/mem_uss were read, < 0 if never */
 } XRGProcessInfo;
 
+/**
+ * One thread of the drill-down process
+ */
+typedef struct {
+    pid_t tid;              /* Thread ID */
+    gchar name[16];         /* Thread name (comm, settable by the program) */
+    gchar state;            /* R, S, D, Z, T, etc. */
+    gdouble cpu_percent;    /* Of one CPU, since the previous thread update */
+} XRGThreadInfo;
+
 /**
  * Sort criteria for process list
  */
@@ -39,7 +62,8 @@ typedef enum {
     XRG_PROCESS_SORT_CPU,       /* Sort by CPU usage (default) */
     XRG_PROCESS_SORT_MEMORY,    /* Sort by memory usage */
     XRG_PROCESS_SORT_PID,       /* Sort by PID */
-    XRG_PROCESS_SORT_NAME       /* Sort by name */
+    XRG_PROCESS_SORT_NAME,      /* Sort by name */
+    XRG_PROCESS_SORT_IO         /* Sort by storage read + write rate */
 } XRGProcessSortBy;
 
 typedef struct _XRGProcessCollector XRGProcessCollector;
@@ -51,12 +75,26 @@ void xrg_process_collector_free(XRGProcessCollector *collector);
 /* Update process list */
 void xrg_process_collector_update(XRGProcessCollector *collector);
 
-/* Get process list */
-GList* xrg_process_collector_get_processes(XRGProcessCollector *collector);
+/*
+ * Get process list: an array of get_process_count() records in sort order.
+ * The array and its strings are owned by the collector and stay valid until
+ * the next update; use xrg_process_info_copy() to keep a record longer.
+ */
+const XRGProcessInfo* xrg_process_collector_get_processes(XRGProcessCollector *collector);
 gint xrg_process_collector_get_process_count(XRGProcessCollector *collector);
+const XRGProcessInfo* xrg_process_collector_get_process_at(XRGProcessCollector *collector, gint index);
+
+/*
+ * Recent CPU % and memory % of a listed process, oldest first, for
+ * sparklines. Copies up to max samples (XRG_PROCESS_HISTORY_LENGTH at
+ * most) and returns how many; 0 if the process has no history.
+ */
+#define XRG_PROCESS_HISTORY_LENGTH 60
+gint xrg_process_collector_get_history(XRGProcessCollector *collector, const XRGProcessInfo *proc,
+                                       gfloat *cpu, gfloat *mem, gint max);
 
 /* Get specific process info (returns NULL if not found) */
-XRGProcessInfo* xrg_process_collector_get_process(XRGProcessCollector *collector, pid_t pid);
+const XRGProcessInfo* xrg_process_collector_get_process(XRGProcessCollector *collector, pid_t pid);
 
 /* Sorting */
 void xrg_process_collector_set_sort_by(XRGProcessCollector *collector, XRGProcessSortBy sort_by);
@@ -70,13 +108,54 @@ gboolean xrg_process_collector_get_show_all_users(XRGProcessCollector *collector
 void xrg_process_collector_set_filter(XRGProcessCollector *collector, const gchar *filter);
 const gchar* xrg_process_collector_get_filter(XRGProcessCollector *collector);
 
+/* Scan parallelism: cap on threads walking /proc (0 = one per CPU) */
+void xrg_process_collector_set_max_threads(XRGProcessCollector *collector, gint max_threads);
+gint xrg_process_collector_get_max_threads(XRGProcessCollector *collector);
+
+/*
+ * Memory probes: smaps_rollup costs milliseconds per process, so PSS/USS
+ * are refreshed for the listed processes, least recently sampled first
+ * (the probe PID, e.g. the hovered row, before all others), only while
+ * the predicted cost fits a per-update budget of thread CPU time. The
+ * probe PID is probed even over budget, and so is the stalest skipped
+ * process every few updates.
+ */
+void xrg_process_collector_set_probe_budget(XRGProcessCollector *collector, gint budget_us);  /* 0 = off */
+gint xrg_process_collector_get_probe_budget(XRGProcessCollector *collector);
+void xrg_process_collector_set_probe_pid(XRGProcessCollector *collector, pid_t pid);  /* 0 = none */
+
+/*
+ * Event tracking: follow fork/exec/exit through the netlink proc connector
+ * and only rescan all of /proc periodically. Processes that exit between
+ * updates are reported as records with exited_count > 0. Returns whether
+ * tracking is active; it stays off (polling) without CAP_NET_ADMIN.
+ */
+gboolean xrg_process_collector_set_event_tracking(XRGProcessCollector *collector, gboolean enabled);
+gboolean xrg_process_collector_get_event_tracking(XRGProcessCollector *collector);
+/* Lifecycle events seen during the last update (all 0 unless tracking) */
+void xrg_process_collector_get_event_counts(XRGProcessCollector *collector,
+                                            gint *forks, gint *execs, gint *exits);
+
+/*
+ * Thread drill-down: watch the threads of one process through held
+ * /proc/[pid]/task fds. update_threads() only touches that process, so
+ * it can run more often than the full update. Threads are listed busiest
+ * first; the list is empty once the process has exited. Setting a PID
+ * returns FALSE if its task directory cannot be opened; 0 turns it off.
+ */
+gboolean xrg_process_collector_set_thread_pid(XRGProcessCollector *collector, pid_t pid);
+pid_t xrg_process_collector_get_thread_pid(XRGProcessCollector *collector);
+void xrg_process_collector_update_threads(XRGProcessCollector *collector);
+gint xrg_process_collector_get_thread_count(XRGProcessCollector *collector);
+const XRGThreadInfo* xrg_process_collector_get_thread_at(XRGProcessCollector *collector, gint index);
+
 /* System totals */
 gint xrg_process_collector_get_total_processes(XRGProcessCollector *collector);
 gint xrg_process_collector_get_running_processes(XRGProcessCollector *collector);
 guint64 xrg_process_collector_get_total_memory(XRGProcessCollector *collector);
 gdouble xrg_process_collector_get_uptime_seconds(XRGProcessCollector *collector);
 
-/* Process info helpers */
+/* Process info helpers (free is only for records made by copy) */
 void xrg_process_info_free(XRGProcessInfo *info);
 XRGProcessInfo* xrg_process_info_copy(const XRGProcessInfo *info);
 
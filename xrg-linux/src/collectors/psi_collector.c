@@ -0,0 +1,340 @@
+#include "psi_collector.h"
+#include "cgroup_collector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+
+#define PROC_PRESSURE "/proc/pressure"
+#define PSI_UNPRIVILEGED_WINDOW_US 2000000  /* Unprivileged windows must be a multiple of this */
+
+static const gchar *resource_names[XRG_PSI_NUM_RESOURCES] = { "cpu", "memory", "io" };
+
+struct _XRGPsiCollector {
+    gint dataset_capacity;
+    gchar *cgroup;                                  /* NULL for the whole system */
+
+    gint fds[XRG_PSI_NUM_RESOURCES];                /* Read with pread(); -1 if missing */
+    gint trigger_fds[XRG_PSI_NUM_RESOURCES];        /* Trigger registered; -1 if none */
+    XRGPsiInfo resources[XRG_PSI_NUM_RESOURCES];
+    gchar buf[512];
+
+    gint64 last_update_time;
+};
+
+/* Helper: Pressure file of a resource, system-wide or for the cgroup */
+static gchar* pressure_path(XRGPsiCollector *collector, XRGPsiResource resource) {
+    if (collector->cgroup == NULL)
+        return g_strdup_printf(PROC_PRESSURE "/%s", resource_names[resource]);
+    return g_strdup_printf(CGROUP_ROOT "/%s/%s.pressure", collector->cgroup, resource_names[resource]);
+}
+
+/*============================================================================
+ * Triggers
+ *============================================================================*/
+
+/* Helper: Open path and register "some <stall> <window>" on it; -1 on failure */
+static gint register_trigger(const gchar *path, gint window_us) {
+    gint fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    gchar spec[64];
+    g_snprintf(spec, sizeof(spec), "some %d %d", PSI_TRIGGER_STALL_US, window_us);
+    if (write(fd, spec, strlen(spec) + 1) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void open_trigger(XRGPsiCollector *collector, XRGPsiResource resource) {
+    XRGPsiInfo *info = &collector->resources[resource];
+    gchar *path = pressure_path(collector, resource);
+
+    /* The 2 s window is for kernels that only let root use shorter ones */
+    static const gint windows[] = { PSI_TRIGGER_WINDOW_US, PSI_UNPRIVILEGED_WINDOW_US };
+    for (gsize i = 0; i < G_N_ELEMENTS(windows); i++) {
+        collector->trigger_fds[resource] = register_trigger(path, windows[i]);
+        if (collector->trigger_fds[resource] >= 0) {
+            info->has_trigger = TRUE;
+            info->trigger_window_us = windows[i];
+            break;
+        }
+    }
+    g_free(path);
+}
+
+/* Count what a poll() of a trigger fd returned; TRUE if it was a stall */
+static gboolean record_trigger(XRGPsiCollector *collector, XRGPsiResource resource, gshort revents) {
+    XRGPsiInfo *info = &collector->resources[resource];
+    if (revents & (POLLERR | POLLNVAL)) {
+        /* The cgroup went away */
+        close(collector->trigger_fds[resource]);
+        collector->trigger_fds[resource] = -1;
+        info->has_trigger = FALSE;
+        return FALSE;
+    }
+    if (!(revents & POLLPRI))
+        return FALSE;
+
+    info->pending_events++;
+    info->last_event_time = g_get_monotonic_time();
+    return TRUE;
+}
+
+/* Count a pending trigger event; the kernel clears it on every poll() */
+static gboolean drain_trigger(XRGPsiCollector *collector, XRGPsiResource resource) {
+    gint fd = collector->trigger_fds[resource];
+    if (fd < 0)
+        return FALSE;
+
+    struct pollfd pfd = { .fd = fd, .events = POLLPRI };
+    if (poll(&pfd, 1, 0) <= 0)
+        return FALSE;
+    return record_trigger(collector, resource, pfd.revents);
+}
+
+/*============================================================================
+ * Pressure Files
+ *============================================================================*/
+
+static void close_files(XRGPsiCollector *collector) {
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        if (collector->fds[r] >= 0)
+            close(collector->fds[r]);
+        if (collector->trigger_fds[r] >= 0)
+            close(collector->trigger_fds[r]);
+        collector->fds[r] = -1;
+        collector->trigger_fds[r] = -1;
+    }
+}
+
+/* (Re)open every resource's files; histories start over */
+static void open_files(XRGPsiCollector *collector) {
+    close_files(collector);
+
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        XRGPsiInfo *info = &collector->resources[r];
+        info->available = FALSE;
+        info->has_full = FALSE;
+        info->has_trigger = FALSE;
+        info->trigger_window_us = 0;
+        info->have_sample = FALSE;
+        info->some_total = info->full_total = 0;
+        info->pending_events = 0;
+        info->last_event_time = 0;
+        info->some_avg10 = info->full_avg10 = info->some_stall = info->full_stall = 0.0;
+        xrg_dataset_clear(info->some_history);
+        xrg_dataset_clear(info->full_history);
+        xrg_dataset_clear(info->stall_history);
+        xrg_dataset_clear(info->event_history);
+
+        gchar *path = pressure_path(collector, r);
+        collector->fds[r] = open(path, O_RDONLY | O_CLOEXEC);
+        g_free(path);
+        if (collector->fds[r] >= 0)
+            open_trigger(collector, r);
+    }
+}
+
+/*
+ * Parse one line of a pressure file:
+ *   some avg10=5.62 avg60=4.08 avg300=3.69 total=205796953
+ */
+static gboolean parse_pressure_line(const gchar *line, gdouble *avg10, guint64 *total) {
+    const gchar *avg = strstr(line, "avg10=");
+    const gchar *tot = strstr(line, "total=");
+    if (avg == NULL || tot == NULL)
+        return FALSE;
+    *avg10 = g_ascii_strtod(avg + 6, NULL);
+    *total = g_ascii_strtoull(tot + 6, NULL, 10);
+    return TRUE;
+}
+
+static void read_resource(XRGPsiCollector *collector, XRGPsiResource resource, gdouble time_delta) {
+    XRGPsiInfo *info = &collector->resources[resource];
+    gint fd = collector->fds[resource];
+    if (fd < 0)
+        return;
+
+    ssize_t len = pread(fd, collector->buf, sizeof(collector->buf) - 1, 0);
+    if (len <= 0) {
+        info->available = FALSE;
+        return;
+    }
+    collector->buf[len] = '\0';
+
+    gdouble some_avg10 = 0.0, full_avg10 = 0.0;
+    guint64 some_total = 0, full_total = 0;
+    gboolean have_some = FALSE, have_full = FALSE;
+    for (gchar *line = collector->buf; line && *line; ) {
+        gchar *next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+
+        if (g_str_has_prefix(line, "some "))
+            have_some = parse_pressure_line(line, &some_avg10, &some_total);
+        else if (g_str_has_prefix(line, "full "))
+            have_full = parse_pressure_line(line, &full_avg10, &full_total);
+        line = next;
+    }
+    if (!have_some) {
+        info->available = FALSE;
+        return;
+    }
+
+    /* Stalled share of the interval from the microsecond totals */
+    gdouble interval_us = time_delta * G_USEC_PER_SEC;
+    if (info->have_sample && interval_us > 0) {
+        info->some_stall = some_total >= info->some_total
+                           ? MIN((some_total - info->some_total) / interval_us * 100.0, 100.0) : 0.0;
+        info->full_stall = have_full && full_total >= info->full_total
+                           ? MIN((full_total - info->full_total) / interval_us * 100.0, 100.0) : 0.0;
+    }
+
+    info->available = TRUE;
+    info->has_full = have_full;
+    info->some_avg10 = some_avg10;
+    info->full_avg10 = full_avg10;
+    info->some_total = some_total;
+    info->full_total = full_total;
+    info->have_sample = TRUE;
+}
+
+/**
+ * Create new PSI collector
+ */
+XRGPsiCollector* xrg_psi_collector_new(gint dataset_capacity) {
+    XRGPsiCollector *collector = g_new0(XRGPsiCollector, 1);
+
+    collector->dataset_capacity = dataset_capacity;
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        XRGPsiInfo *info = &collector->resources[r];
+        info->some_history = xrg_dataset_new(dataset_capacity);
+        info->full_history = xrg_dataset_new(dataset_capacity);
+        info->stall_history = xrg_dataset_new(dataset_capacity);
+        info->event_history = xrg_dataset_new(dataset_capacity);
+        collector->fds[r] = -1;
+        collector->trigger_fds[r] = -1;
+    }
+    open_files(collector);
+
+    /* Initialize */
+    collector->last_update_time = g_get_monotonic_time();
+
+    /* Do initial read */
+    xrg_psi_collector_update(collector);
+
+    return collector;
+}
+
+/**
+ * Free PSI collector
+ */
+void xrg_psi_collector_free(XRGPsiCollector *collector) {
+    if (collector == NULL)
+        return;
+
+    close_files(collector);
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        XRGPsiInfo *info = &collector->resources[r];
+        xrg_dataset_free(info->some_history);
+        xrg_dataset_free(info->full_history);
+        xrg_dataset_free(info->stall_history);
+        xrg_dataset_free(info->event_history);
+    }
+
+    g_free(collector->cgroup);
+    g_free(collector);
+}
+
+/**
+ * Update pressure for every resource
+ */
+void xrg_psi_collector_update(XRGPsiCollector *collector) {
+    g_return_if_fail(collector != NULL);
+
+    gint64 now = g_get_monotonic_time();
+    gdouble time_delta = (now - collector->last_update_time) / (gdouble)G_USEC_PER_SEC;
+
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        XRGPsiInfo *info = &collector->resources[r];
+
+        /* Events a main loop has not picked up yet */
+        while (drain_trigger(collector, r))
+            ;
+
+        read_resource(collector, r, time_delta);
+        xrg_dataset_add_value(info->some_history, info->some_avg10);
+        xrg_dataset_add_value(info->full_history, info->full_avg10);
+        xrg_dataset_add_value(info->stall_history, info->some_stall);
+        xrg_dataset_add_value(info->event_history, info->pending_events);
+        info->pending_events = 0;
+    }
+
+    collector->last_update_time = now;
+}
+
+gboolean xrg_psi_collector_set_cgroup(XRGPsiCollector *collector, const gchar *cgroup) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+
+    g_free(collector->cgroup);
+    collector->cgroup = (cgroup && cgroup[0]) ? g_strdup(cgroup) : NULL;
+    open_files(collector);
+    collector->last_update_time = g_get_monotonic_time();
+
+    return xrg_psi_collector_is_available(collector);
+}
+
+const gchar* xrg_psi_collector_get_cgroup(XRGPsiCollector *collector) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    return collector->cgroup;
+}
+
+/* Getters */
+
+gboolean xrg_psi_collector_is_available(XRGPsiCollector *collector) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        if (collector->fds[r] >= 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+const XRGPsiInfo* xrg_psi_collector_get_info(XRGPsiCollector *collector, XRGPsiResource resource) {
+    g_return_val_if_fail(collector != NULL, NULL);
+    g_return_val_if_fail(resource >= 0 && resource < XRG_PSI_NUM_RESOURCES, NULL);
+    return &collector->resources[resource];
+}
+
+const gchar* xrg_psi_resource_get_name(XRGPsiResource resource) {
+    g_return_val_if_fail(resource >= 0 && resource < XRG_PSI_NUM_RESOURCES, NULL);
+    return resource_names[resource];
+}
+
+gint xrg_psi_collector_get_trigger_fd(XRGPsiCollector *collector, XRGPsiResource resource) {
+    g_return_val_if_fail(collector != NULL, -1);
+    g_return_val_if_fail(resource >= 0 && resource < XRG_PSI_NUM_RESOURCES, -1);
+    return collector->trigger_fds[resource];
+}
+
+gboolean xrg_psi_collector_record_trigger(XRGPsiCollector *collector, XRGPsiResource resource,
+                                          GIOCondition condition) {
+    g_return_val_if_fail(collector != NULL, FALSE);
+    g_return_val_if_fail(resource >= 0 && resource < XRG_PSI_NUM_RESOURCES, FALSE);
+    if (collector->trigger_fds[resource] < 0)
+        return FALSE;
+
+    gshort revents = 0;
+    if (condition & G_IO_PRI)
+        revents |= POLLPRI;
+    if (condition & G_IO_ERR)
+        revents |= POLLERR;
+    if (condition & G_IO_NVAL)
+        revents |= POLLNVAL;
+    return record_trigger(collector, resource, revents);
+}
@@ -0,0 +1,91 @@
+#ifndef XRG_PSI_COLLECTOR_H
+#define XRG_PSI_COLLECTOR_H
+
+#include <glib.h>
+#include "../core/dataset.h"
+
+/**
+ * XRGPsiCollector - Pressure Stall Information
+ *
+ * Reads /proc/pressure/{cpu,memory,io}, or the *.pressure files of one
+ * cgroup, through held fds:
+ * - "some" and "full" avg10, in %
+ * - Share of the last update interval spent stalled, from the deltas of
+ *   the total= stall counters (exact, where avg10 is a decaying average)
+ *
+ * It also registers a kernel PSI trigger on each resource (a "some" stall
+ * of PSI_TRIGGER_STALL_US within a PSI_TRIGGER_WINDOW_US window). The
+ * trigger fd becomes ready for POLLPRI the moment such a stall happens,
+ * so short stalls between one-second samples are caught and counted.
+ * Unprivileged processes may only use windows that are a multiple of 2 s;
+ * the collector falls back to that when the kernel refuses the 1 s window.
+ */
+
+#define PSI_TRIGGER_STALL_US 150000        /* 150 ms stalled... */
+#define PSI_TRIGGER_WINDOW_US 1000000      /* ...within any 1 s */
+
+typedef enum {
+    XRG_PSI_CPU,
+    XRG_PSI_MEMORY,
+    XRG_PSI_IO,
+    XRG_PSI_NUM_RESOURCES
+} XRGPsiResource;
+
+typedef struct {
+    gboolean available;         /* Pressure file could be read */
+    gboolean has_full;          /* Kernel reports a "full" line */
+    gboolean has_trigger;       /* Trigger registered */
+    gint trigger_window_us;     /* Window the kernel accepted */
+
+    /* Latest values */
+    gdouble some_avg10;         /* % */
+    gdouble full_avg10;
+    gdouble some_stall;         /* % of the last interval */
+    gdouble full_stall;
+    guint64 some_total;         /* us stalled since boot (or cgroup creation) */
+    guint64 full_total;
+    gboolean have_sample;       /* Totals above hold a previous sample */
+    guint pending_events;       /* Trigger wakeups since the last update */
+    gint64 last_event_time;     /* Monotonic, microseconds; 0 if none yet */
+
+    /* History */
+    XRGDataset *some_history;   /* avg10 % */
+    XRGDataset *full_history;   /* avg10 % */
+    XRGDataset *stall_history;  /* "some" stall, % of each interval */
+    XRGDataset *event_history;  /* Trigger wakeups per interval */
+} XRGPsiInfo;
+
+typedef struct _XRGPsiCollector XRGPsiCollector;
+
+/* Constructor and destructor */
+XRGPsiCollector* xrg_psi_collector_new(gint dataset_capacity);
+void xrg_psi_collector_free(XRGPsiCollector *collector);
+
+/* Update methods */
+void xrg_psi_collector_update(XRGPsiCollector *collector);
+
+/*
+ * Watch one cgroup (path relative to CGROUP_ROOT, e.g. "system.slice")
+ * instead of the whole system; NULL or "" for the whole system. History
+ * starts over. Returns FALSE if the cgroup has no pressure files.
+ */
+gboolean xrg_psi_collector_set_cgroup(XRGPsiCollector *collector, const gchar *cgroup);
+const gchar* xrg_psi_collector_get_cgroup(XRGPsiCollector *collector);  /* NULL for the whole system */
+
+/* Getters */
+gboolean xrg_psi_collector_is_available(XRGPsiCollector *collector);
+const XRGPsiInfo* xrg_psi_collector_get_info(XRGPsiCollector *collector, XRGPsiResource resource);
+const gchar* xrg_psi_resource_get_name(XRGPsiResource resource);
+
+/*
+ * Trigger fd of a resource, -1 if none; add it to a main loop to wake on
+ * POLLPRI. The kernel clears the event when the main loop polls the fd, so
+ * the fd must not be polled again: pass the condition the loop reported to
+ * record_trigger, which counts the stall. Returns TRUE if it was one; on
+ * an error condition the trigger is closed (the cgroup went away).
+ */
+gint xrg_psi_collector_get_trigger_fd(XRGPsiCollector *collector, XRGPsiResource resource);
+gboolean xrg_psi_collector_record_trigger(XRGPsiCollector *collector, XRGPsiResource resource,
+                                          GIOCondition condition);
+
+#endif /* XRG_PSI_COLLECTOR_H */
@@ -65,6 +65,9 @@ void xrg_preferences_free(XRGPreferences *prefs) {
     g_free(prefs->aitoken_jsonl_path);
     g_free(prefs->aitoken_db_path);
     g_free(prefs->aitoken_otel_endpoint);
+    g_free(prefs->disk_view_device);
+    g_free(prefs->memory_overlay_counter);
+    g_free(prefs->pressure_cgroup);
     g_free(prefs->current_theme);
     g_free(prefs);
 }
@@ -185,6 +188,23 @@ void xrg_preferences_set_defaults(XRGPreferences *prefs) {
     /* Temperature settings */
     prefs->temperature_units = XRG_TEMP_CELSIUS;  /* Default to Celsius */
 
+    /* CPU view settings */
+    prefs->cpu_view_mode = XRG_CPU_VIEW_TOTAL;
+    prefs->cpu_granularity = 0;  /* XRG_CPU_GRANULARITY_THREAD */
+    prefs->cpu_show_frequency = FALSE;
+    prefs->cpu_show_perf_counters = FALSE;
+    prefs->disk_view_mode = XRG_DISK_VIEW_BUSIEST;
+    prefs->disk_view_device = g_strdup("");
+    prefs->disk_show_latency = TRUE;
+    prefs->memory_overlay_counter = g_strdup("");
+    prefs->memory_show_numa = TRUE;
+    prefs->pressure_show_overlay = FALSE;
+    prefs->pressure_cgroup = g_strdup("");
+    prefs->process_scan_threads = 0;  /* Auto */
+    prefs->process_event_tracking = FALSE;
+    prefs->process_probe_budget_us = 2000;
+    prefs->process_show_cgroups = FALSE;
+
     /* AI Token settings */
     gchar *home = g_strdup(g_get_home_dir());
     prefs->aitoken_jsonl_path = g_build_filename(home, ".claude", "projects", NULL);
@@ -393,6 +413,64 @@ gboolean xrg_preferences_load(XRGPreferences *prefs) {
     /* Load Temperature settings */
     prefs->temperature_units = g_key_file_get_integer(prefs->keyfile, "Temperature", "units", NULL);
 
+    /* Load CPU view settings */
+    if (g_key_file_has_key(prefs->keyfile, "CPU", "view_mode", NULL)) {
+        prefs->cpu_view_mode = g_key_file_get_integer(prefs->keyfile, "CPU", "view_mode", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "CPU", "granularity", NULL)) {
+        prefs->cpu_granularity = g_key_file_get_integer(prefs->keyfile, "CPU", "granularity", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "CPU", "show_frequency", NULL)) {
+        prefs->cpu_show_frequency = g_key_file_get_boolean(prefs->keyfile, "CPU", "show_frequency", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "CPU", "show_perf_counters", NULL)) {
+        prefs->cpu_show_perf_counters = g_key_file_get_boolean(prefs->keyfile, "CPU", "show_perf_counters", NULL);
+    }
+
+    /* Load Disk view settings */
+    if (g_key_file_has_key(prefs->keyfile, "Disk", "view_mode", NULL)) {
+        prefs->disk_view_mode = g_key_file_get_integer(prefs->keyfile, "Disk", "view_mode", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Disk", "view_device", NULL)) {
+        g_free(prefs->disk_view_device);
+        prefs->disk_view_device = g_key_file_get_string(prefs->keyfile, "Disk", "view_device", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Disk", "show_latency", NULL)) {
+        prefs->disk_show_latency = g_key_file_get_boolean(prefs->keyfile, "Disk", "show_latency", NULL);
+    }
+
+    /* Load Memory view settings */
+    if (g_key_file_has_key(prefs->keyfile, "Memory", "overlay_counter", NULL)) {
+        g_free(prefs->memory_overlay_counter);
+        prefs->memory_overlay_counter = g_key_file_get_string(prefs->keyfile, "Memory", "overlay_counter", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Memory", "show_numa", NULL)) {
+        prefs->memory_show_numa = g_key_file_get_boolean(prefs->keyfile, "Memory", "show_numa", NULL);
+    }
+
+    /* Load Pressure settings */
+    if (g_key_file_has_key(prefs->keyfile, "Pressure", "show_overlay", NULL)) {
+        prefs->pressure_show_overlay = g_key_file_get_boolean(prefs->keyfile, "Pressure", "show_overlay", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Pressure", "cgroup", NULL)) {
+        g_free(prefs->pressure_cgroup);
+        prefs->pressure_cgroup = g_key_file_get_string(prefs->keyfile, "Pressure", "cgroup", NULL);
+    }
+
+    /* Load Process settings */
+    if (g_key_file_has_key(prefs->keyfile, "Process", "scan_threads", NULL)) {
+        prefs->process_scan_threads = g_key_file_get_integer(prefs->keyfile, "Process", "scan_threads", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Process", "event_tracking", NULL)) {
+        prefs->process_event_tracking = g_key_file_get_boolean(prefs->keyfile, "Process", "event_tracking", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Process", "probe_budget_us", NULL)) {
+        prefs->process_probe_budget_us = g_key_file_get_integer(prefs->keyfile, "Process", "probe_budget_us", NULL);
+    }
+    if (g_key_file_has_key(prefs->keyfile, "Process", "show_cgroups", NULL)) {
+        prefs->process_show_cgroups = g_key_file_get_boolean(prefs->keyfile, "Process", "show_cgroups", NULL);
+    }
+
     /* Load AI Token settings */
     prefs->aitoken_show_model_breakdown = g_key_file_get_boolean(prefs->keyfile, "AIToken", "show_model_breakdown", NULL);
 
@@ -608,6 +686,31 @@ gboolean xrg_preferences_save(XRGPreferences *prefs) {
     /* Save temperature settings */
     g_key_file_set_integer(prefs->keyfile, "Temperature", "units", prefs->temperature_units);
 
+    /* Save CPU view settings */
+    g_key_file_set_integer(prefs->keyfile, "CPU", "view_mode", prefs->cpu_view_mode);
+    g_key_file_set_integer(prefs->keyfile, "CPU", "granularity", prefs->cpu_granularity);
+    g_key_file_set_boolean(prefs->keyfile, "CPU", "show_frequency", prefs->cpu_show_frequency);
+    g_key_file_set_boolean(prefs->keyfile, "CPU", "show_perf_counters", prefs->cpu_show_perf_counters);
+
+    /* Save Disk view settings */
+    g_key_file_set_integer(prefs->keyfile, "Disk", "view_mode", prefs->disk_view_mode);
+    g_key_file_set_string(prefs->keyfile, "Disk", "view_device", prefs->disk_view_device);
+    g_key_file_set_boolean(prefs->keyfile, "Disk", "show_latency", prefs->disk_show_latency);
+
+    /* Save Memory view settings */
+    g_key_file_set_string(prefs->keyfile, "Memory", "overlay_counter", prefs->memory_overlay_counter);
+    g_key_file_set_boolean(prefs->keyfile, "Memory", "show_numa", prefs->memory_show_numa);
+
+    /* Save Pressure settings */
+    g_key_file_set_boolean(prefs->keyfile, "Pressure", "show_overlay", prefs->pressure_show_overlay);
+    g_key_file_set_string(prefs->keyfile, "Pressure", "cgroup", prefs->pressure_cgroup);
+
+    /* Save Process settings */
+    g_key_file_set_integer(prefs->keyfile, "Process", "scan_threads", prefs->process_scan_threads);
+    g_key_file_set_boolean(prefs->keyfile, "Process", "event_tracking", prefs->process_event_tracking);
+    g_key_file_set_integer(prefs->keyfile, "Process", "probe_budget_us", prefs->process_probe_budget_us);
+    g_key_file_set_boolean(prefs->keyfile, "Process", "show_cgroups", prefs->process_show_cgroups);
+
     /* Save AI Token settings */
     g_key_file_set_boolean(prefs->keyfile, "AIToken", "show_model_breakdown", prefs->aitoken_show_model_breakdown);
 
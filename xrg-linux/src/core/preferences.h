@@ -30,6 +30,25 @@ typedef enum {
     XRG_TEMP_FAHRENHEIT = 1   /* Fahrenheit (°F) */
 } XRGTemperatureUnits;
 
+/**
+ * CPU graph view mode
+ */
+typedef enum {
+    XRG_CPU_VIEW_TOTAL   = 0,  /* User/system totals (default) */
+    XRG_CPU_VIEW_PER_CPU = 1,  /* One strip per thread, core or package */
+    XRG_CPU_VIEW_HEATMAP = 2,  /* One pixel row per thread, core or package */
+    XRG_CPU_VIEW_BANDS   = 3   /* Min/p50/p90/max across CPUs */
+} XRGCPUViewMode;
+
+/**
+ * Disk graph source
+ */
+typedef enum {
+    XRG_DISK_VIEW_BUSIEST = 0,  /* Busiest whole disk (default) */
+    XRG_DISK_VIEW_ALL     = 1,  /* Sum over physical disks */
+    XRG_DISK_VIEW_DEVICE  = 2   /* The device named by disk_view_device */
+} XRGDiskViewMode;
+
 /**
  * AI Token billing mode
  * Different providers use different billing models:
@@ -186,6 +205,31 @@ struct _XRGPreferences {
     /* Temperature settings */
     XRGTemperatureUnits temperature_units;  /* Celsius or Fahrenheit */
 
+    /* CPU view settings */
+    XRGCPUViewMode cpu_view_mode;
+    gint cpu_granularity;  /* XRGCPUGranularity: thread, core or package */
+    gboolean cpu_show_frequency;  /* Overlay average clock as % of max */
+    gboolean cpu_show_perf_counters;  /* Overlay IPC and cache misses from perf events (opened only while on) */
+
+    /* Disk view settings */
+    XRGDiskViewMode disk_view_mode;
+    gchar *disk_view_device;  /* Kernel name, e.g. "nvme0n1" or "dm-0" */
+    gboolean disk_show_latency;  /* Overlay await (ms per I/O) on throughput */
+
+    /* Memory view settings */
+    gchar *memory_overlay_counter;  /* meminfo/vmstat key drawn over the graph, e.g. "pgmajfault"; "" for none */
+    gboolean memory_show_numa;  /* Stack memory by NUMA node on machines with more than one */
+
+    /* Pressure (PSI) settings */
+    gboolean pressure_show_overlay;  /* CPU, memory and I/O pressure over their graphs, with stall marks */
+    gchar *pressure_cgroup;  /* Watch this cgroup (relative to /sys/fs/cgroup); "" for the whole system */
+
+    /* Process settings */
+    gint process_scan_threads;  /* Cap on /proc scan threads, 0 = one per CPU */
+    gboolean process_event_tracking;  /* Follow the proc connector between full scans */
+    gint process_probe_budget_us;  /* CPU time per update for PSS/USS probes, 0 = off */
+    gboolean process_show_cgroups;    /* Process module lists cgroups instead of processes */
+
     /* AI Token settings */
     gchar *aitoken_jsonl_path;
     gchar *aitoken_db_path;
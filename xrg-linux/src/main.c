@@ -1,20 +1,26 @@
 #include <gtk/gtk.h>
 #include <glib.h>
+#include <glib-unix.h>
 #include <stdio.h>
 #include <gdk/gdkkeysyms.h>
 #include "core/preferences.h"
 #include "core/dataset.h"
 #include "core/utils.h"
 #include "collectors/cpu_collector.h"
+#include "collectors/cpufreq_collector.h"
 #include "collectors/memory_collector.h"
 #include "collectors/network_collector.h"
 #include "collectors/disk_collector.h"
+#include "collectors/mounts_collector.h"
 #include "collectors/gpu_collector.h"
 #include "collectors/battery_collector.h"
 #include "collectors/sensors_collector.h"
 #include "collectors/aitoken_collector.h"
 #include "collectors/aitoken_pricing.h"
 #include "collectors/process_collector.h"
+#include "collectors/cgroup_collector.h"
+#include "collectors/psi_collector.h"
+#include "collectors/perf_collector.h"
 #include "collectors/tpu_collector.h"
 #include "ui/preferences_window.h"
 
@@ -51,18 +57,31 @@ typedef struct {
     GtkWidget *tpu_drawing_area;
     XRGPreferences *prefs;
     XRGCPUCollector *cpu_collector;
+    XRGCPUFreqCollector *cpufreq_collector;
+    XRGPerfCollector *perf_collector;   /* Only while the counter overlay is on */
+    gchar *perf_error;                  /* Why the counters last failed to open, or NULL */
     XRGMemoryCollector *memory_collector;
     XRGNetworkCollector *network_collector;
     XRGDiskCollector *disk_collector;
+    XRGMountsCollector *mounts_collector;
     XRGGPUCollector *gpu_collector;
     XRGBatteryCollector *battery_collector;
     XRGSensorsCollector *sensors_collector;
     XRGAITokenCollector *aitoken_collector;
     XRGProcessCollector *process_collector;
+    XRGCgroupCollector *cgroup_collector;
+    XRGPsiCollector *psi_collector;
+    guint psi_watch_ids[XRG_PSI_NUM_RESOURCES];  /* Main loop watches on the PSI trigger fds */
     XRGTPUCollector *tpu_collector;
     XRGPreferencesWindow *prefs_window;
     guint update_timer_id;
 
+    /* Process module thread drill-down */
+    guint thread_timer_id;              /* Faster updates of the selected process's threads */
+    gchar thread_process_name[64];
+    pid_t menu_process_pid;             /* Row under the pointer when the context menu opened */
+    gchar menu_process_name[64];
+
     /* Dragging state */
     gboolean is_dragging;
     gint drag_start_x;
@@ -83,6 +102,12 @@ typedef struct {
 
     /* Debounced save state */
     guint save_timeout_id;  /* Timer for debounced preferences save */
+
+    /* CPU heatmap: one pixel per (CPU group, sample), scrolled as samples arrive */
+    cairo_surface_t *cpu_heatmap_surface;
+    gint cpu_heatmap_granularity;   /* Granularity the surface was built for */
+    guint64 cpu_heatmap_sample;     /* Collector sample count already rendered */
+    guint32 cpu_heatmap_lut[256];   /* Usage (0-255) -> opaque ARGB32 */
 } AppState;
 
 /* Forward declarations */
@@ -108,10 +133,31 @@ static gboolean on_draw_cpu(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_cpu_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_cpu_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
 static void show_cpu_context_menu(AppState *state, GdkEventButton *event);
+static void on_cpu_view_total(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_view_per_cpu(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_view_heatmap(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_view_bands(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_granularity_thread(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_granularity_core(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_granularity_package(GtkMenuItem *item, gpointer user_data);
+static void on_cpu_show_frequency(GtkCheckMenuItem *item, gpointer user_data);
+static void on_cpu_show_perf_counters(GtkCheckMenuItem *item, gpointer user_data);
+static gboolean open_perf_collector(AppState *state);
+static void draw_perf_overlay(AppState *state, cairo_t *cr, gint width, gint height, gint count);
+static void append_perf_tooltip(AppState *state, GString *tooltip, gint index, gint count);
 static gboolean on_draw_memory(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_memory_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_memory_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
 static void show_memory_context_menu(AppState *state, GdkEventButton *event);
+static void on_memory_overlay_counter(GtkMenuItem *item, gpointer user_data);
+static void track_memory_overlay(AppState *state);
+static XRGDataset* get_memory_overlay(AppState *state);
+static gchar* format_memory_counter(AppState *state, const gchar *name, gdouble value);
+static void on_memory_show_numa(GtkCheckMenuItem *item, gpointer user_data);
+static gboolean show_numa_view(AppState *state);
+static void draw_numa_nodes(AppState *state, cairo_t *cr, gint width, gint height, gint count);
+static void draw_memory_breakdown(AppState *state, cairo_t *cr, gint width, gint height, gint count);
+static void append_numa_tooltip(AppState *state, GString *tooltip, gint index, gint count);
 static gboolean on_draw_network(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_network_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_network_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
@@ -120,6 +166,19 @@ static gboolean on_draw_disk(GtkWidget *widget, cairo_t *cr, gpointer user_data)
 static gboolean on_disk_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_disk_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
 static void show_disk_context_menu(AppState *state, GdkEventButton *event);
+static void on_disk_view_busiest(GtkMenuItem *item, gpointer user_data);
+static void on_disk_view_all(GtkMenuItem *item, gpointer user_data);
+static void on_disk_view_device(GtkMenuItem *item, gpointer user_data);
+static gchar* format_mount_summary(const XRGMountInfo *mount);
+static void on_disk_show_latency(GtkCheckMenuItem *item, gpointer user_data);
+static void watch_pressure_triggers(AppState *state);
+static gboolean on_pressure_trigger(gint fd, GIOCondition condition, gpointer user_data);
+static void append_pressure_menu_item(AppState *state, GtkWidget *menu);
+static void on_show_pressure(GtkCheckMenuItem *item, gpointer user_data);
+static void draw_pressure_overlay(AppState *state, cairo_t *cr, XRGPsiResource resource,
+                                  gint width, gint height, gint count);
+static void append_pressure_tooltip(AppState *state, GString *tooltip, XRGPsiResource resource,
+                                    gint index, gint count);
 
 /* Helper function to get gradient color for activity bars based on position */
 static void get_activity_bar_gradient_color(gdouble position, XRGPreferences *prefs, GdkRGBA *out_color) {
@@ -171,9 +230,14 @@ static void show_aitoken_context_menu(AppState *state, GdkEventButton *event);
 static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_process_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_process_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
+static gboolean on_process_leave_notify(GtkWidget *widget, GdkEventCrossing *event, gpointer user_data);
 static void show_process_context_menu(AppState *state, GdkEventButton *event);
 static void on_process_sort_cpu(GtkMenuItem *item, gpointer user_data);
 static void on_process_sort_memory(GtkMenuItem *item, gpointer user_data);
+static void on_process_sort_io(GtkMenuItem *item, gpointer user_data);
+static void on_process_show_cgroups(GtkCheckMenuItem *item, gpointer user_data);
+static void on_process_show_threads(GtkMenuItem *item, gpointer user_data);
+static void on_process_hide_threads(GtkMenuItem *item, gpointer user_data);
 static gboolean on_draw_tpu(GtkWidget *widget, cairo_t *cr, gpointer user_data);
 static gboolean on_tpu_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data);
 static gboolean on_tpu_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data);
@@ -758,14 +822,28 @@ static void on_activate(GtkApplication *app, gpointer user_data) {
 
     /* Initialize collectors */
     state->cpu_collector = xrg_cpu_collector_new(200);  /* 200 data points */
+    state->cpufreq_collector = xrg_cpufreq_collector_new(200);
+    if (state->prefs->cpu_show_perf_counters)
+        open_perf_collector(state);
     state->memory_collector = xrg_memory_collector_new(200);
     state->network_collector = xrg_network_collector_new(200);
     state->disk_collector = xrg_disk_collector_new(200);
+    state->mounts_collector = xrg_mounts_collector_new(200);
     state->gpu_collector = xrg_gpu_collector_new(200);
     state->battery_collector = xrg_battery_collector_new();
     state->sensors_collector = xrg_sensors_collector_new();
     state->aitoken_collector = xrg_aitoken_collector_new(200);
     state->process_collector = xrg_process_collector_new(10);  /* Top 10 processes */
+    xrg_process_collector_set_max_threads(state->process_collector, state->prefs->process_scan_threads);
+    xrg_process_collector_set_event_tracking(state->process_collector, state->prefs->process_event_tracking);
+    xrg_process_collector_set_probe_budget(state->process_collector, state->prefs->process_probe_budget_us);
+    state->cgroup_collector = xrg_cgroup_collector_new(200);
+    state->psi_collector = xrg_psi_collector_new(200);
+    if (state->prefs->pressure_cgroup[0] &&
+        !xrg_psi_collector_set_cgroup(state->psi_collector, state->prefs->pressure_cgroup)) {
+        g_warning("No pressure files for cgroup %s", state->prefs->pressure_cgroup);
+    }
+    watch_pressure_triggers(state);
     state->tpu_collector = xrg_tpu_collector_new(200);  /* TPU/Coral monitoring */
 
     /* Create main window */
@@ -1032,10 +1110,11 @@ static void on_activate(GtkApplication *app, gpointer user_data) {
 
     /* Enable button press and motion events */
     gtk_widget_add_events(state->process_drawing_area,
-                         GDK_BUTTON_PRESS_MASK | GDK_POINTER_MOTION_MASK);
+                         GDK_BUTTON_PRESS_MASK | GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
     g_signal_connect(state->process_drawing_area, "draw", G_CALLBACK(on_draw_process), state);
     g_signal_connect(state->process_drawing_area, "button-press-event", G_CALLBACK(on_process_button_press), state);
     g_signal_connect(state->process_drawing_area, "motion-notify-event", G_CALLBACK(on_process_motion_notify), state);
+    g_signal_connect(state->process_drawing_area, "leave-notify-event", G_CALLBACK(on_process_leave_notify), state);
     gtk_box_pack_start(GTK_BOX(state->process_box), state->process_drawing_area, TRUE, TRUE, 0);
 
     gtk_box_pack_start(GTK_BOX(state->vbox), state->process_box, TRUE, TRUE, 0);
@@ -1158,11 +1237,283 @@ static void show_cpu_context_menu(AppState *state, GdkEventButton *event) {
     gtk_widget_set_sensitive(stats_item, FALSE);
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), stats_item);
     g_free(stats_text);
-    
+
+    /* Separator */
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
+    /* View mode */
+    GtkWidget *view_total_item = gtk_check_menu_item_new_with_label("Show Total");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_total_item),
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_TOTAL);
+    g_signal_connect(view_total_item, "activate", G_CALLBACK(on_cpu_view_total), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_total_item);
+
+    GtkWidget *view_per_cpu_item = gtk_check_menu_item_new_with_label("Show Per-CPU Strips");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_per_cpu_item),
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_PER_CPU);
+    g_signal_connect(view_per_cpu_item, "activate", G_CALLBACK(on_cpu_view_per_cpu), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_per_cpu_item);
+
+    GtkWidget *view_heatmap_item = gtk_check_menu_item_new_with_label("Show Heatmap");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_heatmap_item),
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_HEATMAP);
+    g_signal_connect(view_heatmap_item, "activate", G_CALLBACK(on_cpu_view_heatmap), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_heatmap_item);
+
+    GtkWidget *view_bands_item = gtk_check_menu_item_new_with_label("Show Distribution Bands");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_bands_item),
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_BANDS);
+    g_signal_connect(view_bands_item, "activate", G_CALLBACK(on_cpu_view_bands), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_bands_item);
+
+    /* Separator */
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
+    /* Granularity (thread / physical core / package) */
+    gchar *thread_label = g_strdup_printf("Group by Thread (%d)",
+        xrg_cpu_collector_get_num_cpus(state->cpu_collector));
+    GtkWidget *thread_item = gtk_check_menu_item_new_with_label(thread_label);
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(thread_item),
+        state->prefs->cpu_granularity == XRG_CPU_GRANULARITY_THREAD);
+    g_signal_connect(thread_item, "activate", G_CALLBACK(on_cpu_granularity_thread), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), thread_item);
+    g_free(thread_label);
+
+    gchar *core_label = g_strdup_printf("Group by Core (%d)",
+        xrg_cpu_collector_get_num_cores(state->cpu_collector));
+    GtkWidget *core_item = gtk_check_menu_item_new_with_label(core_label);
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(core_item),
+        state->prefs->cpu_granularity == XRG_CPU_GRANULARITY_CORE);
+    g_signal_connect(core_item, "activate", G_CALLBACK(on_cpu_granularity_core), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), core_item);
+    g_free(core_label);
+
+    gchar *package_label = g_strdup_printf("Group by Package (%d)",
+        xrg_cpu_collector_get_num_packages(state->cpu_collector));
+    GtkWidget *package_item = gtk_check_menu_item_new_with_label(package_label);
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(package_item),
+        state->prefs->cpu_granularity == XRG_CPU_GRANULARITY_PACKAGE);
+    g_signal_connect(package_item, "activate", G_CALLBACK(on_cpu_granularity_package), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), package_item);
+    g_free(package_label);
+
+    /* Frequency overlay (only when cpufreq is present) */
+    if (xrg_cpufreq_collector_is_available(state->cpufreq_collector)) {
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
+        GtkWidget *freq_item = gtk_check_menu_item_new_with_label("Show Frequency Overlay");
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(freq_item), state->prefs->cpu_show_frequency);
+        g_signal_connect(freq_item, "toggled", G_CALLBACK(on_cpu_show_frequency), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), freq_item);
+    }
+
+    /* Performance counters (opened on demand; may need perf_event_paranoid <= 0) */
+    GtkWidget *perf_item = gtk_check_menu_item_new_with_label("Show Performance Counters");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(perf_item), state->perf_collector != NULL);
+    g_signal_connect(perf_item, "toggled", G_CALLBACK(on_cpu_show_perf_counters), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), perf_item);
+    if (state->perf_collector == NULL && state->perf_error != NULL) {
+        gchar *perf_text = g_strdup_printf("Performance counters unavailable: %s", state->perf_error);
+        gtk_widget_set_tooltip_text(perf_item, perf_text);
+        GtkWidget *perf_error_item = gtk_menu_item_new_with_label(perf_text);
+        gtk_widget_set_sensitive(perf_error_item, FALSE);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), perf_error_item);
+        g_free(perf_text);
+    }
+    append_pressure_menu_item(state, menu);
+
     gtk_widget_show_all(menu);
     gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
 }
 
+/**
+ * CPU view mode menu callbacks
+ */
+static void on_cpu_view_total(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_view_mode = XRG_CPU_VIEW_TOTAL;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+static void on_cpu_view_per_cpu(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_view_mode = XRG_CPU_VIEW_PER_CPU;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+static void on_cpu_view_heatmap(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_view_mode = XRG_CPU_VIEW_HEATMAP;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+static void on_cpu_view_bands(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_view_mode = XRG_CPU_VIEW_BANDS;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+/**
+ * CPU granularity menu callbacks
+ */
+static void on_cpu_granularity_thread(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_granularity = XRG_CPU_GRANULARITY_THREAD;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+static void on_cpu_granularity_core(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_granularity = XRG_CPU_GRANULARITY_CORE;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+static void on_cpu_granularity_package(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_granularity = XRG_CPU_GRANULARITY_PACKAGE;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+/**
+ * CPU frequency overlay toggle
+ */
+static void on_cpu_show_frequency(GtkCheckMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->prefs->cpu_show_frequency = gtk_check_menu_item_get_active(item);
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+/**
+ * Open the performance counters, keeping the reason if they are unavailable
+ * so the CPU menu can show it
+ */
+static gboolean open_perf_collector(AppState *state) {
+    g_free(state->perf_error);
+    state->perf_error = NULL;
+    state->perf_collector = xrg_perf_collector_new(200);
+    if (xrg_perf_collector_is_available(state->perf_collector))
+        return TRUE;
+
+    const gchar *error = xrg_perf_collector_get_error(state->perf_collector);
+    state->perf_error = g_strdup(error ? error : "no CPUs could be opened");
+    xrg_perf_collector_free(state->perf_collector);
+    state->perf_collector = NULL;
+    return FALSE;
+}
+
+/**
+ * Performance counter overlay toggle. The perf events are opened here and
+ * closed again when the overlay is turned off, so they cost nothing (and
+ * leave the PMU to other tools) while unused.
+ */
+static void on_cpu_show_perf_counters(GtkCheckMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    gboolean active = gtk_check_menu_item_get_active(item);
+
+    if (active && state->perf_collector == NULL) {
+        if (!open_perf_collector(state))
+            active = FALSE;
+    } else if (!active && state->perf_collector != NULL) {
+        xrg_perf_collector_free(state->perf_collector);
+        state->perf_collector = NULL;
+    }
+
+    state->prefs->cpu_show_perf_counters = active;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->cpu_drawing_area);
+}
+
+/**
+ * Performance counter overlay: IPC as a solid line and cache misses per
+ * 1000 instructions as a dotted one, each on its own scale. Without
+ * hardware counters, the context switch rate takes the place of IPC.
+ */
+static void draw_perf_overlay(AppState *state, cairo_t *cr, gint width, gint height, gint count) {
+    XRGPerfCollector *perf = state->perf_collector;
+    if (perf == NULL)
+        return;
+
+    gboolean hardware = xrg_perf_collector_has_hardware(perf);
+    XRGDataset *datasets[2] = {
+        hardware ? xrg_perf_collector_get_ipc_dataset(perf) : xrg_perf_collector_get_context_switch_dataset(perf),
+        hardware && xrg_perf_collector_has_event(perf, XRG_PERF_CACHE_MISSES)
+            ? xrg_perf_collector_get_mpki_dataset(perf) : NULL,
+    };
+    const gdouble min_scale[2] = { hardware ? 2.0 : 100.0, 1.0 };
+    const gdouble dots[] = { 1.0, 2.0 };
+
+    GdkRGBA *fg2_color = &state->prefs->graph_fg2_color;
+    for (gint d = 0; d < 2; d++) {
+        if (datasets[d] == NULL)
+            continue;
+
+        /* Line up with the graph from the right edge */
+        gint perf_count = xrg_dataset_get_count(datasets[d]);
+        gint offset = count - perf_count;
+        gint start = MAX(0, -offset);
+
+        gdouble max_value = min_scale[d];
+        for (gint i = start; i < perf_count; i++) {
+            gdouble value = xrg_dataset_get_value(datasets[d], i);
+            if (value > max_value) max_value = value;
+        }
+
+        cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue,
+                              fg2_color->alpha * (d == 0 ? 1.0 : 0.7));
+        cairo_set_line_width(cr, d == 0 ? 1.5 : 1.0);
+        if (d == 1)
+            cairo_set_dash(cr, dots, G_N_ELEMENTS(dots), 0);
+        for (gint i = start; i < perf_count; i++) {
+            gdouble x = (gdouble)(i + offset) / count * width;
+            gdouble y = height - (xrg_dataset_get_value(datasets[d], i) / max_value * (height - 2)) - 1;
+            if (i == start)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
+        }
+        cairo_stroke(cr);
+        cairo_set_dash(cr, NULL, 0, 0);
+    }
+}
+
+/**
+ * Performance counters at a tooltip's sample, when the overlay is on
+ */
+static void append_perf_tooltip(AppState *state, GString *tooltip, gint index, gint count) {
+    XRGPerfCollector *perf = state->perf_collector;
+    if (perf == NULL)
+        return;
+
+    XRGDataset *ctxsw_dataset = xrg_perf_collector_get_context_switch_dataset(perf);
+    gint perf_index = index - (count - xrg_dataset_get_count(ctxsw_dataset));
+    if (perf_index < 0)
+        return;
+
+    if (xrg_perf_collector_has_hardware(perf)) {
+        g_string_append_printf(tooltip, "\nIPC: %.2f | Cache Misses: %.1f per 1k instructions",
+                               xrg_dataset_get_value(xrg_perf_collector_get_ipc_dataset(perf), perf_index),
+                               xrg_dataset_get_value(xrg_perf_collector_get_mpki_dataset(perf), perf_index));
+    }
+    g_string_append_printf(tooltip, "\nContext Switches: %.0f/s | Migrations: %.0f/s",
+                           xrg_dataset_get_value(ctxsw_dataset, perf_index),
+                           xrg_dataset_get_value(xrg_perf_collector_get_migration_dataset(perf), perf_index));
+}
+
 /**
  * CPU motion notify (tooltip)
  */
@@ -1191,11 +1542,50 @@ static gboolean on_cpu_motion_notify(GtkWidget *widget, GdkEventMotion *event, g
     gdouble system_val = xrg_dataset_get_value(system_dataset, index);
     gdouble total_val = user_val + system_val;
 
+    /* Distribution bands: report the spread at this sample */
+    if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_BANDS) {
+        gchar *tooltip = g_strdup_printf("CPU Usage: %.1f%%\nMin: %.1f%% | p50: %.1f%% | p90: %.1f%% | Max: %.1f%%",
+            total_val,
+            xrg_dataset_get_value(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_MIN), index),
+            xrg_dataset_get_value(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P50), index),
+            xrg_dataset_get_value(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P90), index),
+            xrg_dataset_get_value(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_MAX), index));
+        gtk_widget_set_tooltip_text(widget, tooltip);
+        g_free(tooltip);
+        return FALSE;
+    }
+
+    /* Per-CPU strips and heatmap: report the row under the pointer */
+    if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_PER_CPU ||
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_HEATMAP) {
+        XRGCPUGranularity granularity = state->prefs->cpu_granularity;
+        gint groups = xrg_cpu_collector_get_group_count(state->cpu_collector, granularity);
+        gint group = (gint)((event->y / allocation.height) * groups);
+        if (group < 0) group = 0;
+        if (group >= groups) group = groups - 1;
+
+        XRGDataset *group_dataset = xrg_cpu_collector_get_group_dataset(state->cpu_collector,
+                                                                         granularity, group);
+        gint group_count = xrg_dataset_get_count(group_dataset);
+        gint group_index = index - (count - group_count);
+        gdouble group_val = (group_index >= 0) ? xrg_dataset_get_value(group_dataset, group_index) : 0.0;
+
+        gchar *tooltip = g_strdup_printf("%s %d: %.1f%%\nCPU Usage: %.1f%%",
+                                         xrg_cpu_granularity_name(granularity), group,
+                                         group_val, total_val);
+        gtk_widget_set_tooltip_text(widget, tooltip);
+        g_free(tooltip);
+        return FALSE;
+    }
+
     /* Set tooltip */
-    gchar *tooltip = g_strdup_printf("CPU Usage: %.1f%%\nUser: %.1f%% | System: %.1f%%",
-                                     total_val, user_val, system_val);
-    gtk_widget_set_tooltip_text(widget, tooltip);
-    g_free(tooltip);
+    GString *tooltip = g_string_new(NULL);
+    g_string_append_printf(tooltip, "CPU Usage: %.1f%%\nUser: %.1f%% | System: %.1f%%",
+                           total_val, user_val, system_val);
+    append_perf_tooltip(state, tooltip, index, count);
+    append_pressure_tooltip(state, tooltip, XRG_PSI_CPU, index, count);
+    gtk_widget_set_tooltip_text(widget, tooltip->str);
+    g_string_free(tooltip, TRUE);
 
     return FALSE;
 }
@@ -1229,6 +1619,54 @@ static void show_memory_context_menu(AppState *state, GdkEventButton *event) {
     /* Separator */
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
 
+    /* Overlay a meminfo/vmstat counter; any other key can be set in the config file */
+    static const struct { const gchar *name; const gchar *label; } overlay_counters[] = {
+        { "",                        "None" },
+        { "pgmajfault",              "Major Faults" },
+        { "pswpin",                  "Swap Ins" },
+        { "pswpout",                 "Swap Outs" },
+        { "allocstall_normal",       "Direct Reclaim Stalls" },
+        { "compact_stall",           "Compaction Stalls" },
+        { "thp_fault_alloc",         "THP Faults" },
+        { "workingset_refault_file", "Page Cache Refaults" },
+        { "oom_kill",                "OOM Kills" },
+        { "Dirty",                   "Dirty" },
+        { "Writeback",               "Writeback" },
+        { "AnonHugePages",           "Anonymous Huge Pages" },
+        { "Shmem",                   "Shared Memory" },
+    };
+    const gchar *overlay = state->prefs->memory_overlay_counter;
+    GtkWidget *overlay_menu = gtk_menu_new();
+    for (gsize i = 0; i < G_N_ELEMENTS(overlay_counters); i++) {
+        const gchar *name = overlay_counters[i].name;
+        if (name[0] && xrg_memory_collector_find_counter(state->memory_collector, name) < 0)
+            continue;
+
+        gchar *label = name[0] ? g_strdup_printf("%s (%s)", overlay_counters[i].label, name)
+                               : g_strdup(overlay_counters[i].label);
+        GtkWidget *counter_item = gtk_check_menu_item_new_with_label(label);
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(counter_item), strcmp(overlay, name) == 0);
+        g_object_set_data_full(G_OBJECT(counter_item), "counter", g_strdup(name), g_free);
+        g_signal_connect(counter_item, "activate", G_CALLBACK(on_memory_overlay_counter), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(overlay_menu), counter_item);
+        g_free(label);
+    }
+    GtkWidget *overlay_menu_item = gtk_menu_item_new_with_label("Overlay Counter");
+    gtk_menu_item_set_submenu(GTK_MENU_ITEM(overlay_menu_item), overlay_menu);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), overlay_menu_item);
+
+    gint num_nodes = xrg_memory_collector_get_num_numa_nodes(state->memory_collector);
+    if (num_nodes > 1) {
+        GtkWidget *numa_item = gtk_check_menu_item_new_with_label("Show NUMA Nodes");
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(numa_item), state->prefs->memory_show_numa);
+        g_signal_connect(numa_item, "toggled", G_CALLBACK(on_memory_show_numa), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), numa_item);
+    }
+    append_pressure_menu_item(state, menu);
+
+    /* Separator */
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
     /* Stats */
     guint64 total_mem = xrg_memory_collector_get_total_memory(state->memory_collector);
     guint64 used_mem = xrg_memory_collector_get_used_memory(state->memory_collector);
@@ -1245,158 +1683,550 @@ static void show_memory_context_menu(AppState *state, GdkEventButton *event) {
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), stats_item);
     g_free(stats_text);
 
+    /* Per-node stats */
+    if (num_nodes > 1) {
+        for (gint n = 0; n < num_nodes; n++) {
+            const XRGNumaNode *node = xrg_memory_collector_get_numa_node(state->memory_collector, n);
+            gchar *node_text = g_strdup_printf("Node %d: %.1f/%.1f GB | Hit %.0f/s, Miss %.0f/s, Foreign %.0f/s",
+                                               node->id, node->mem_used / (1024.0 * 1024.0 * 1024.0),
+                                               node->mem_total / (1024.0 * 1024.0 * 1024.0),
+                                               node->hit_rate, node->miss_rate, node->foreign_rate);
+            GtkWidget *node_item = gtk_menu_item_new_with_label(node_text);
+            gtk_widget_set_sensitive(node_item, FALSE);
+            gtk_menu_shell_append(GTK_MENU_SHELL(menu), node_item);
+            g_free(node_text);
+        }
+    }
+
     gtk_widget_show_all(menu);
     gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
 }
 
-/**
- * Memory motion notify (tooltip)
- */
-static gboolean on_memory_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data) {
+static void on_memory_show_numa(GtkCheckMenuItem *item, gpointer user_data) {
     AppState *state = (AppState *)user_data;
-    GtkAllocation allocation;
-    gtk_widget_get_allocation(widget, &allocation);
-
-    /* Get datasets */
-    XRGDataset *used_dataset = xrg_memory_collector_get_used_dataset(state->memory_collector);
-    XRGDataset *wired_dataset = xrg_memory_collector_get_wired_dataset(state->memory_collector);
-    XRGDataset *cached_dataset = xrg_memory_collector_get_cached_dataset(state->memory_collector);
-    gint count = xrg_dataset_get_count(used_dataset);
-
-    if (count < 2) {
-        gtk_widget_set_tooltip_text(widget, "Memory: Waiting for data...");
-        return FALSE;
-    }
-
-    /* Calculate which data point the mouse is over */
-    gint index = (gint)((event->x / allocation.width) * count);
-    if (index < 0) index = 0;
-    if (index >= count) index = count - 1;
-
-    /* Get values at this index (percentages) */
-    gdouble used_val = xrg_dataset_get_value(used_dataset, index);
-    gdouble wired_val = xrg_dataset_get_value(wired_dataset, index);
-    gdouble cached_val = xrg_dataset_get_value(cached_dataset, index);
-    gdouble total_pct = used_val + wired_val + cached_val;
-
-    /* Calculate absolute values in GB */
-    guint64 total_mem = xrg_memory_collector_get_total_memory(state->memory_collector);
-    gdouble total_gb = total_mem / (1024.0 * 1024.0 * 1024.0);
-    gdouble used_gb = (used_val / 100.0) * total_gb;
-    gdouble wired_gb = (wired_val / 100.0) * total_gb;
-    gdouble cached_gb = (cached_val / 100.0) * total_gb;
-
-    /* Set tooltip */
-    gchar *tooltip = g_strdup_printf("Memory Usage: %.1f%% (%.1f GB)\nUsed: %.1f GB | Wired: %.1f GB | Cached: %.1f GB",
-                                     total_pct, (total_pct / 100.0) * total_gb,
-                                     used_gb, wired_gb, cached_gb);
-    gtk_widget_set_tooltip_text(widget, tooltip);
-    g_free(tooltip);
-
-    return FALSE;
+    state->prefs->memory_show_numa = gtk_check_menu_item_get_active(item);
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->memory_drawing_area);
 }
 
 /**
- * Network module button press (context menu)
+ * Memory overlay counter menu callback
  */
-static gboolean on_network_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data) {
+static void on_memory_overlay_counter(GtkMenuItem *item, gpointer user_data) {
     AppState *state = (AppState *)user_data;
-
-    if (event->button == 3) {  /* Right click */
-        show_network_context_menu(state, event);
-        return TRUE;
-    }
-
-    return FALSE;
+    const gchar *counter = g_object_get_data(G_OBJECT(item), "counter");
+    if (counter == NULL)
+        return;
+
+    if (state->prefs->memory_overlay_counter[0])
+        xrg_memory_collector_untrack_counter(state->memory_collector, state->prefs->memory_overlay_counter);
+    g_free(state->prefs->memory_overlay_counter);
+    state->prefs->memory_overlay_counter = g_strdup(counter);
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->memory_drawing_area);
 }
 
 /**
- * Show Network context menu
+ * Keep history for the selected overlay counter; called before each memory
+ * update, so a newly selected counter starts with that update
  */
-static void show_network_context_menu(AppState *state, GdkEventButton *event) {
-    GtkWidget *menu = gtk_menu_new();
-
-    /* Network Settings */
-    GtkWidget *settings_item = gtk_menu_item_new_with_label("Network Settings...");
-    g_signal_connect_swapped(settings_item, "activate",
-                             G_CALLBACK(xrg_preferences_window_show), state->prefs_window);
-    gtk_menu_shell_append(GTK_MENU_SHELL(menu), settings_item);
-
-    /* Separator */
-    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
-
-    /* Stats */
-    const gchar *iface = xrg_network_collector_get_primary_interface(state->network_collector);
-    gdouble download = xrg_network_collector_get_download_rate(state->network_collector);
-    gdouble upload = xrg_network_collector_get_upload_rate(state->network_collector);
-
-    gchar *stats_text = g_strdup_printf("%s | ↓ %.2f MB/s | ↑ %.2f MB/s",
-                                       iface, download, upload);
-    GtkWidget *stats_item = gtk_menu_item_new_with_label(stats_text);
-    gtk_widget_set_sensitive(stats_item, FALSE);
-    gtk_menu_shell_append(GTK_MENU_SHELL(menu), stats_item);
-    g_free(stats_text);
-
-    gtk_widget_show_all(menu);
-    gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
+static void track_memory_overlay(AppState *state) {
+    const gchar *counter = state->prefs->memory_overlay_counter;
+    if (counter != NULL && counter[0] != '\0')
+        xrg_memory_collector_track_counter(state->memory_collector, counter);
 }
 
 /**
- * Network motion notify (tooltip)
+ * History of the overlay counter, NULL if none is selected or the kernel
+ * does not have it
  */
-static gboolean on_network_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data) {
-    AppState *state = (AppState *)user_data;
-    GtkAllocation allocation;
-    gtk_widget_get_allocation(widget, &allocation);
-
-    /* Get datasets */
-    XRGDataset *download_dataset = xrg_network_collector_get_download_dataset(state->network_collector);
-    XRGDataset *upload_dataset = xrg_network_collector_get_upload_dataset(state->network_collector);
-    gint count = xrg_dataset_get_count(download_dataset);
-
-    if (count < 2) {
-        gtk_widget_set_tooltip_text(widget, "Network: Waiting for data...");
-        return FALSE;
-    }
-
-    /* Calculate which data point the mouse is over */
-    gint index = (gint)((event->x / allocation.width) * count);
-    if (index < 0) index = 0;
-    if (index >= count) index = count - 1;
-
-    /* Get values at this index (MB/s) */
-    gdouble download_val = xrg_dataset_get_value(download_dataset, index);
-    gdouble upload_val = xrg_dataset_get_value(upload_dataset, index);
+static XRGDataset* get_memory_overlay(AppState *state) {
+    const gchar *counter = state->prefs->memory_overlay_counter;
+    if (counter == NULL || counter[0] == '\0')
+        return NULL;
+    return xrg_memory_collector_get_counter_history(state->memory_collector, counter);
+}
 
-    /* Set tooltip */
-    gchar *tooltip = g_strdup_printf("Network Traffic\nDownload: %.2f MB/s\nUpload: %.2f MB/s",
-                                     download_val, upload_val);
-    gtk_widget_set_tooltip_text(widget, tooltip);
-    g_free(tooltip);
+/**
+ * "pgmajfault: 12.0/s" for event counters, "Dirty: 41.2 MB" for kB fields
+ */
+static gchar* format_memory_counter(AppState *state, const gchar *name, gdouble value) {
+    gint index = xrg_memory_collector_find_counter(state->memory_collector, name);
+    if (xrg_memory_collector_counter_is_cumulative(state->memory_collector, index))
+        return g_strdup_printf("%s: %.1f/s", name, value);
+    if (xrg_memory_collector_counter_is_bytes(state->memory_collector, index))
+        return g_strdup_printf("%s: %.1f MB", name, value);
+    return g_strdup_printf("%s: %.0f", name, value);
+}
 
-    return FALSE;
+/**
+ * The per-node view replaces the used/wired/cached breakdown, and only
+ * makes sense with more than one node
+ */
+static gboolean show_numa_view(AppState *state) {
+    return state->prefs->memory_show_numa &&
+           xrg_memory_collector_get_num_numa_nodes(state->memory_collector) > 1;
 }
 
 /**
- * Handle button press on Disk drawing area (for context menu)
+ * Stacked per-node memory, node0 at the bottom. Each band is the node's
+ * used share of all nodes' memory, so the top edge is overall usage and a
+ * node filling up on its own stands out as one band growing. Bands take
+ * FG1, FG2 and FG3 in turn, and are always drawn solid so adjacent nodes
+ * stay distinguishable.
  */
-static gboolean on_disk_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data) {
-    AppState *state = (AppState *)user_data;
+static void draw_numa_nodes(AppState *state, cairo_t *cr, gint width, gint height, gint count) {
+    GdkRGBA *colors[3] = { &state->prefs->graph_fg1_color, &state->prefs->graph_fg2_color,
+                           &state->prefs->graph_fg3_color };
+    static const gdouble alphas[3] = { 1.0, 0.7, 0.5 };
+    gdouble *base = g_new0(gdouble, count);     /* Top of the bands drawn so far, % */
+
+    gint num_nodes = xrg_memory_collector_get_num_numa_nodes(state->memory_collector);
+    for (gint n = 0; n < num_nodes; n++) {
+        const XRGNumaNode *node = xrg_memory_collector_get_numa_node(state->memory_collector, n);
+        gint node_count = xrg_dataset_get_count(node->used_history);
+        gint offset = count - node_count;  /* Line the history up from the right */
+
+        GdkRGBA *color = colors[n % 3];
+        gdouble alpha = color->alpha * alphas[n % 3] * (n >= 3 ? 0.6 : 1.0);
+        cairo_set_source_rgba(cr, color->red, color->green, color->blue, alpha);
+
+        /* Top edge left to right, then back along the bands below */
+        for (gint i = 0; i < count; i++) {
+            gdouble value = i >= offset ? xrg_dataset_get_value(node->used_history, i - offset) : 0.0;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - ((base[i] + value) / 100.0 * height);
+            if (i == 0)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
+        }
+        for (gint i = count - 1; i >= 0; i--) {
+            gdouble x = (gdouble)i / count * width;
+            cairo_line_to(cr, x, height - (base[i] / 100.0 * height));
+        }
+        cairo_close_path(cr);
+        cairo_fill(cr);
 
-    if (event->button == 3) {  /* Right click */
-        show_disk_context_menu(state, event);
-        return TRUE;
+        for (gint i = offset > 0 ? offset : 0; i < count; i++)
+            base[i] += xrg_dataset_get_value(node->used_history, i - offset);
     }
 
-    return FALSE;
+    g_free(base);
 }
 
 /**
- * Show Disk context menu
+ * Used, wired and cached memory stacked, in the memory graph style
  */
-static void show_disk_context_menu(AppState *state, GdkEventButton *event) {
-    GtkWidget *menu = gtk_menu_new();
-
+static void draw_memory_breakdown(AppState *state, cairo_t *cr, gint width, gint height, gint count) {
+    XRGDataset *used_dataset = xrg_memory_collector_get_used_dataset(state->memory_collector);
+    XRGDataset *wired_dataset = xrg_memory_collector_get_wired_dataset(state->memory_collector);
+    XRGDataset *cached_dataset = xrg_memory_collector_get_cached_dataset(state->memory_collector);
+
+    /* Draw used memory (cyan - FG1) - bottom layer */
+    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
+    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha);
+
+    XRGGraphStyle style = state->prefs->memory_graph_style;
+
+    if (style == XRG_GRAPH_STYLE_SOLID) {
+        /* Solid filled area (original behavior) */
+        cairo_move_to(cr, 0, height);
+        for (gint i = 0; i < count; i++) {
+            gdouble value = xrg_dataset_get_value(used_dataset, i);
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (value / 100.0 * height);
+            cairo_line_to(cr, x, y);
+        }
+        cairo_line_to(cr, width, height);
+        cairo_close_path(cr);
+        cairo_fill(cr);
+    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
+        /* Chunky pixels - fill area with dots */
+        gint dot_spacing = 4;
+        for (gint i = 0; i < count; i++) {
+            gdouble value = xrg_dataset_get_value(used_dataset, i);
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_top = height - (value / 100.0 * height);
+
+            /* Fill from bottom to the data line with dots */
+            for (gdouble y = height; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_DOT) {
+        /* Fine dots - fill area with small dots */
+        gint dot_spacing = 2;
+        for (gint i = 0; i < count; i++) {
+            gdouble value = xrg_dataset_get_value(used_dataset, i);
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_top = height - (value / 100.0 * height);
+
+            /* Fill from bottom to the data line with dots */
+            for (gdouble y = height; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
+        /* Hollow - outline only with dots */
+        for (gint i = 0; i < count; i++) {
+            gdouble value = xrg_dataset_get_value(used_dataset, i);
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (value / 100.0 * height);
+            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
+            cairo_fill(cr);
+        }
+    }
+
+    /* Draw wired memory on top (purple - FG2) */
+    GdkRGBA *fg2_color = &state->prefs->graph_fg2_color;
+    cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue, fg2_color->alpha * 0.7);
+
+    if (style == XRG_GRAPH_STYLE_SOLID) {
+        /* Solid filled area (original behavior) */
+        cairo_move_to(cr, 0, height);
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble total_val = used_val + wired_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (total_val / 100.0 * height);
+            cairo_line_to(cr, x, y);
+        }
+        cairo_line_to(cr, width, height);
+        cairo_close_path(cr);
+        cairo_fill(cr);
+    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
+        /* Chunky pixels - fill area with dots (stacked on top of used) */
+        gint dot_spacing = 4;
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble total_val = used_val + wired_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_bottom = height - (used_val / 100.0 * height);
+            gdouble y_top = height - (total_val / 100.0 * height);
+
+            /* Fill from used level to total level with dots */
+            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_DOT) {
+        /* Fine dots - fill area with small dots (stacked on top of used) */
+        gint dot_spacing = 2;
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble total_val = used_val + wired_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_bottom = height - (used_val / 100.0 * height);
+            gdouble y_top = height - (total_val / 100.0 * height);
+
+            /* Fill from used level to total level with dots */
+            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
+        /* Hollow - outline only with dots (stacked on top of used) */
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble total_val = used_val + wired_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (total_val / 100.0 * height);
+            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
+            cairo_fill(cr);
+        }
+    }
+
+    /* Draw cached memory on top (amber - FG3) */
+    GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+    cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha * 0.5);
+
+    if (style == XRG_GRAPH_STYLE_SOLID) {
+        /* Solid filled area (original behavior) */
+        cairo_move_to(cr, 0, height);
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
+            gdouble total_val = used_val + wired_val + cached_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (total_val / 100.0 * height);
+            cairo_line_to(cr, x, y);
+        }
+        cairo_line_to(cr, width, height);
+        cairo_close_path(cr);
+        cairo_fill(cr);
+    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
+        /* Chunky pixels - fill area with dots (stacked on top of used+wired) */
+        gint dot_spacing = 4;
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
+            gdouble total_val = used_val + wired_val + cached_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_bottom = height - ((used_val + wired_val) / 100.0 * height);
+            gdouble y_top = height - (total_val / 100.0 * height);
+
+            /* Fill from used+wired level to total level with dots */
+            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_DOT) {
+        /* Fine dots - fill area with small dots (stacked on top of used+wired) */
+        gint dot_spacing = 2;
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
+            gdouble total_val = used_val + wired_val + cached_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y_bottom = height - ((used_val + wired_val) / 100.0 * height);
+            gdouble y_top = height - (total_val / 100.0 * height);
+
+            /* Fill from used+wired level to total level with dots */
+            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
+                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
+        /* Hollow - outline only with dots (stacked on top of used+wired) */
+        for (gint i = 0; i < count; i++) {
+            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
+            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
+            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
+            gdouble total_val = used_val + wired_val + cached_val;
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (total_val / 100.0 * height);
+            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
+            cairo_fill(cr);
+        }
+    }
+}
+
+/**
+ * "Node 0: 30.2 GB, 12 misses/s" for each node at a graph position
+ */
+static void append_numa_tooltip(AppState *state, GString *tooltip, gint index, gint count) {
+    gint num_nodes = xrg_memory_collector_get_num_numa_nodes(state->memory_collector);
+    guint64 all_nodes_total = 0;
+    for (gint n = 0; n < num_nodes; n++)
+        all_nodes_total += xrg_memory_collector_get_numa_node(state->memory_collector, n)->mem_total;
+    gdouble all_nodes_gb = all_nodes_total / (1024.0 * 1024.0 * 1024.0);
+
+    for (gint n = 0; n < num_nodes; n++) {
+        const XRGNumaNode *node = xrg_memory_collector_get_numa_node(state->memory_collector, n);
+        gint node_index = index - (count - xrg_dataset_get_count(node->used_history));
+        if (node_index < 0)
+            continue;
+        g_string_append_printf(tooltip, "\nNode %d: %.1f GB, %.0f misses/s", node->id,
+                               xrg_dataset_get_value(node->used_history, node_index) / 100.0 * all_nodes_gb,
+                               xrg_dataset_get_value(node->miss_history, node_index));
+    }
+}
+
+/**
+ * Memory motion notify (tooltip)
+ */
+static gboolean on_memory_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    GtkAllocation allocation;
+    gtk_widget_get_allocation(widget, &allocation);
+
+    /* Get datasets */
+    XRGDataset *used_dataset = xrg_memory_collector_get_used_dataset(state->memory_collector);
+    XRGDataset *wired_dataset = xrg_memory_collector_get_wired_dataset(state->memory_collector);
+    XRGDataset *cached_dataset = xrg_memory_collector_get_cached_dataset(state->memory_collector);
+    gint count = xrg_dataset_get_count(used_dataset);
+
+    if (count < 2) {
+        gtk_widget_set_tooltip_text(widget, "Memory: Waiting for data...");
+        return FALSE;
+    }
+
+    /* Calculate which data point the mouse is over */
+    gint index = (gint)((event->x / allocation.width) * count);
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+
+    /* Get values at this index (percentages) */
+    gdouble used_val = xrg_dataset_get_value(used_dataset, index);
+    gdouble wired_val = xrg_dataset_get_value(wired_dataset, index);
+    gdouble cached_val = xrg_dataset_get_value(cached_dataset, index);
+    gdouble total_pct = used_val + wired_val + cached_val;
+
+    /* Calculate absolute values in GB */
+    guint64 total_mem = xrg_memory_collector_get_total_memory(state->memory_collector);
+    gdouble total_gb = total_mem / (1024.0 * 1024.0 * 1024.0);
+    gdouble used_gb = (used_val / 100.0) * total_gb;
+    gdouble wired_gb = (wired_val / 100.0) * total_gb;
+    gdouble cached_gb = (cached_val / 100.0) * total_gb;
+
+    /* Set tooltip */
+    GString *tooltip = g_string_new(NULL);
+    g_string_append_printf(tooltip, "Memory Usage: %.1f%% (%.1f GB)\nUsed: %.1f GB | Wired: %.1f GB | Cached: %.1f GB",
+                           total_pct, (total_pct / 100.0) * total_gb,
+                           used_gb, wired_gb, cached_gb);
+
+    XRGDataset *overlay_dataset = get_memory_overlay(state);
+    gint overlay_count = overlay_dataset ? xrg_dataset_get_count(overlay_dataset) : 0;
+    if (overlay_count > 0) {
+        /* The overlay history may be shorter; line it up from the right */
+        gint overlay_index = index - (count - overlay_count);
+        if (overlay_index >= 0) {
+            gchar *counter_text = format_memory_counter(state, state->prefs->memory_overlay_counter,
+                                                        xrg_dataset_get_value(overlay_dataset, overlay_index));
+            g_string_append_printf(tooltip, "\n%s", counter_text);
+            g_free(counter_text);
+        }
+    }
+    if (show_numa_view(state))
+        append_numa_tooltip(state, tooltip, index, count);
+    append_pressure_tooltip(state, tooltip, XRG_PSI_MEMORY, index, count);
+
+    gtk_widget_set_tooltip_text(widget, tooltip->str);
+    g_string_free(tooltip, TRUE);
+
+    return FALSE;
+}
+
+/**
+ * Network module button press (context menu)
+ */
+static gboolean on_network_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+
+    if (event->button == 3) {  /* Right click */
+        show_network_context_menu(state, event);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * Show Network context menu
+ */
+static void show_network_context_menu(AppState *state, GdkEventButton *event) {
+    GtkWidget *menu = gtk_menu_new();
+
+    /* Network Settings */
+    GtkWidget *settings_item = gtk_menu_item_new_with_label("Network Settings...");
+    g_signal_connect_swapped(settings_item, "activate",
+                             G_CALLBACK(xrg_preferences_window_show), state->prefs_window);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), settings_item);
+
+    /* Separator */
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
+    /* Stats */
+    const gchar *iface = xrg_network_collector_get_primary_interface(state->network_collector);
+    gdouble download = xrg_network_collector_get_download_rate(state->network_collector);
+    gdouble upload = xrg_network_collector_get_upload_rate(state->network_collector);
+
+    gchar *stats_text = g_strdup_printf("%s | ↓ %.2f MB/s | ↑ %.2f MB/s",
+                                       iface, download, upload);
+    GtkWidget *stats_item = gtk_menu_item_new_with_label(stats_text);
+    gtk_widget_set_sensitive(stats_item, FALSE);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), stats_item);
+    g_free(stats_text);
+
+    /* TCP/UDP health */
+    for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++) {
+        if (!xrg_network_collector_has_stat(state->network_collector, stat))
+            continue;
+        gchar *stat_text = g_strdup_printf("%s: %.1f/s", xrg_network_stat_get_name(stat),
+                                           xrg_network_collector_get_stat_rate(state->network_collector, stat));
+        GtkWidget *stat_item = gtk_menu_item_new_with_label(stat_text);
+        gtk_widget_set_sensitive(stat_item, FALSE);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), stat_item);
+        g_free(stat_text);
+    }
+
+    gtk_widget_show_all(menu);
+    gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
+}
+
+/**
+ * Network motion notify (tooltip)
+ */
+static gboolean on_network_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    GtkAllocation allocation;
+    gtk_widget_get_allocation(widget, &allocation);
+
+    /* Get datasets */
+    XRGDataset *download_dataset = xrg_network_collector_get_download_dataset(state->network_collector);
+    XRGDataset *upload_dataset = xrg_network_collector_get_upload_dataset(state->network_collector);
+    gint count = xrg_dataset_get_count(download_dataset);
+
+    if (count < 2) {
+        gtk_widget_set_tooltip_text(widget, "Network: Waiting for data...");
+        return FALSE;
+    }
+
+    /* Calculate which data point the mouse is over */
+    gint index = (gint)((event->x / allocation.width) * count);
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+
+    /* Get values at this index (MB/s) */
+    gdouble download_val = xrg_dataset_get_value(download_dataset, index);
+    gdouble upload_val = xrg_dataset_get_value(upload_dataset, index);
+
+    GString *tooltip = g_string_new(NULL);
+    g_string_append_printf(tooltip, "Network Traffic\nDownload: %.2f MB/s\nUpload: %.2f MB/s",
+                           download_val, upload_val);
+
+    /* TCP/UDP health at the same point in time (series are right-aligned) */
+    for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++) {
+        if (!xrg_network_collector_has_stat(state->network_collector, stat))
+            continue;
+        XRGDataset *stat_dataset = xrg_network_collector_get_stat_dataset(state->network_collector, stat);
+        gint stat_index = index - (count - xrg_dataset_get_count(stat_dataset));
+        if (stat_index < 0)
+            continue;
+        g_string_append_printf(tooltip, "\n%s: %.1f/s", xrg_network_stat_get_name(stat),
+                               xrg_dataset_get_value(stat_dataset, stat_index));
+    }
+
+    gtk_widget_set_tooltip_text(widget, tooltip->str);
+    g_string_free(tooltip, TRUE);
+
+    return FALSE;
+}
+
+/**
+ * Handle button press on Disk drawing area (for context menu)
+ */
+static gboolean on_disk_button_press(GtkWidget *widget, GdkEventButton *event, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+
+    if (event->button == 3) {  /* Right click */
+        show_disk_context_menu(state, event);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * Show Disk context menu
+ */
+static void show_disk_context_menu(AppState *state, GdkEventButton *event) {
+    GtkWidget *menu = gtk_menu_new();
+
     /* Disk Settings */
     GtkWidget *settings_item = gtk_menu_item_new_with_label("Disk Settings...");
     g_signal_connect_swapped(settings_item, "activate",
@@ -1406,6 +2236,52 @@ static void show_disk_context_menu(AppState *state, GdkEventButton *event) {
     /* Separator */
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
 
+    /* View options */
+    XRGDiskViewMode view_mode = state->prefs->disk_view_mode;
+
+    GtkWidget *view_busiest_item = gtk_check_menu_item_new_with_label("Show Busiest Disk");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_busiest_item),
+        view_mode == XRG_DISK_VIEW_BUSIEST);
+    g_signal_connect(view_busiest_item, "activate", G_CALLBACK(on_disk_view_busiest), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_busiest_item);
+
+    GtkWidget *view_all_item = gtk_check_menu_item_new_with_label("Show All Disks");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(view_all_item),
+        view_mode == XRG_DISK_VIEW_ALL);
+    g_signal_connect(view_all_item, "activate", G_CALLBACK(on_disk_view_all), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), view_all_item);
+
+    /* One item per device; idle loop/ram devices are left out */
+    GtkWidget *device_menu = gtk_menu_new();
+    gint num_devices = xrg_disk_collector_get_num_devices(state->disk_collector);
+    for (gint i = 0; i < num_devices; i++) {
+        const XRGDiskDevice *disk = xrg_disk_collector_get_device(state->disk_collector, i);
+        if (disk->type == XRG_DISK_TYPE_OTHER && disk->sectors_read == 0 && disk->sectors_written == 0)
+            continue;
+
+        gchar *label = strcmp(disk->label, disk->name) != 0
+                       ? g_strdup_printf("%s (%s)", disk->label, disk->name) : g_strdup(disk->name);
+        GtkWidget *device_item = gtk_check_menu_item_new_with_label(label);
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(device_item),
+            view_mode == XRG_DISK_VIEW_DEVICE && strcmp(state->prefs->disk_view_device, disk->name) == 0);
+        g_object_set_data_full(G_OBJECT(device_item), "device", g_strdup(disk->name), g_free);
+        g_signal_connect(device_item, "activate", G_CALLBACK(on_disk_view_device), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(device_menu), device_item);
+        g_free(label);
+    }
+    GtkWidget *device_menu_item = gtk_menu_item_new_with_label("Show Device");
+    gtk_menu_item_set_submenu(GTK_MENU_ITEM(device_menu_item), device_menu);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), device_menu_item);
+
+    GtkWidget *latency_item = gtk_check_menu_item_new_with_label("Show Latency");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(latency_item), state->prefs->disk_show_latency);
+    g_signal_connect(latency_item, "toggled", G_CALLBACK(on_disk_show_latency), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), latency_item);
+    append_pressure_menu_item(state, menu);
+
+    /* Separator */
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
     /* Stats */
     const gchar *device = xrg_disk_collector_get_primary_device(state->disk_collector);
     gdouble read_rate = xrg_disk_collector_get_read_rate(state->disk_collector);
@@ -1418,10 +2294,283 @@ static void show_disk_context_menu(AppState *state, GdkEventButton *event) {
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), stats_item);
     g_free(stats_text);
 
+    gchar *all_text = g_strdup_printf("All disks | Read: %.2f MB/s | Write: %.2f MB/s",
+                                      xrg_disk_collector_get_all_read_rate(state->disk_collector),
+                                      xrg_disk_collector_get_all_write_rate(state->disk_collector));
+    GtkWidget *all_item = gtk_menu_item_new_with_label(all_text);
+    gtk_widget_set_sensitive(all_item, FALSE);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), all_item);
+    g_free(all_text);
+
+    /* Filesystems */
+    gint num_mounts = xrg_mounts_collector_get_num_mounts(state->mounts_collector);
+    if (num_mounts > 0)
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+    for (gint i = 0; i < num_mounts; i++) {
+        const XRGMountInfo *mount = xrg_mounts_collector_get_mount(state->mounts_collector, i);
+        if (!mount->have_stats)
+            continue;
+
+        gchar *mount_text = format_mount_summary(mount);
+        GtkWidget *mount_item = gtk_menu_item_new_with_label(mount_text);
+        gtk_widget_set_sensitive(mount_item, FALSE);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), mount_item);
+        g_free(mount_text);
+    }
+
     gtk_widget_show_all(menu);
     gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
 }
 
+/**
+ * Disk view mode menu callbacks
+ */
+static void on_disk_view_busiest(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->disk_view_mode = XRG_DISK_VIEW_BUSIEST;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->disk_drawing_area);
+}
+
+static void on_disk_view_all(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    state->prefs->disk_view_mode = XRG_DISK_VIEW_ALL;
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->disk_drawing_area);
+}
+
+static void on_disk_view_device(GtkMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    const gchar *device = g_object_get_data(G_OBJECT(item), "device");
+    if (device == NULL)
+        return;
+
+    state->prefs->disk_view_mode = XRG_DISK_VIEW_DEVICE;
+    g_free(state->prefs->disk_view_device);
+    state->prefs->disk_view_device = g_strdup(device);
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->disk_drawing_area);
+}
+
+static void on_disk_show_latency(GtkCheckMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->prefs->disk_show_latency = gtk_check_menu_item_get_active(item);
+    xrg_preferences_save(state->prefs);
+    gtk_widget_queue_draw(state->disk_drawing_area);
+}
+
+/**
+ * Graph that shows a PSI resource: CPU, memory or disk
+ */
+static GtkWidget* get_pressure_drawing_area(AppState *state, XRGPsiResource resource) {
+    switch (resource) {
+        case XRG_PSI_CPU:    return state->cpu_drawing_area;
+        case XRG_PSI_MEMORY: return state->memory_drawing_area;
+        default:             return state->disk_drawing_area;
+    }
+}
+
+/**
+ * Wake on PSI triggers instead of waiting for the next update. Call again
+ * whenever the collector reopens its files.
+ */
+static void watch_pressure_triggers(AppState *state) {
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        if (state->psi_watch_ids[r] > 0)
+            g_source_remove(state->psi_watch_ids[r]);
+        state->psi_watch_ids[r] = 0;
+
+        gint fd = xrg_psi_collector_get_trigger_fd(state->psi_collector, r);
+        if (fd >= 0)
+            state->psi_watch_ids[r] = g_unix_fd_add(fd, G_IO_PRI | G_IO_ERR, on_pressure_trigger, state);
+    }
+}
+
+static gboolean on_pressure_trigger(gint fd, GIOCondition condition, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        if (xrg_psi_collector_get_trigger_fd(state->psi_collector, r) != fd)
+            continue;
+
+        /* Mark the stall now rather than at the next sample */
+        if (xrg_psi_collector_record_trigger(state->psi_collector, r, condition) && state->prefs->pressure_show_overlay)
+            gtk_widget_queue_draw(get_pressure_drawing_area(state, r));
+        if (xrg_psi_collector_get_trigger_fd(state->psi_collector, r) == fd)
+            return G_SOURCE_CONTINUE;
+
+        state->psi_watch_ids[r] = 0;  /* The watched cgroup went away */
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * "Show Pressure" item shared by the CPU, memory and disk menus
+ */
+static void append_pressure_menu_item(AppState *state, GtkWidget *menu) {
+    if (!xrg_psi_collector_is_available(state->psi_collector))
+        return;
+
+    GtkWidget *pressure_item = gtk_check_menu_item_new_with_label("Show Pressure");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pressure_item), state->prefs->pressure_show_overlay);
+    g_signal_connect(pressure_item, "toggled", G_CALLBACK(on_show_pressure), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), pressure_item);
+}
+
+static void on_show_pressure(GtkCheckMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->prefs->pressure_show_overlay = gtk_check_menu_item_get_active(item);
+    xrg_preferences_save(state->prefs);
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++)
+        gtk_widget_queue_draw(get_pressure_drawing_area(state, r));
+}
+
+/**
+ * PSI overlay: "some" avg10 as a dashed line on its own scale (at least
+ * 10%), and a tick along the top for every interval in which the kernel
+ * trigger fired. A stall reported since the last sample is marked at the
+ * right edge straight away.
+ */
+static void draw_pressure_overlay(AppState *state, cairo_t *cr, XRGPsiResource resource,
+                                  gint width, gint height, gint count) {
+    if (!state->prefs->pressure_show_overlay)
+        return;
+    const XRGPsiInfo *info = xrg_psi_collector_get_info(state->psi_collector, resource);
+    if (!info->available)
+        return;
+
+    /* Line up with the graph from the right edge */
+    gint psi_count = xrg_dataset_get_count(info->some_history);
+    gint offset = count - psi_count;
+    gint start = MAX(0, -offset);
+
+    gdouble max_pressure = 10.0;
+    for (gint i = start; i < psi_count; i++) {
+        gdouble value = xrg_dataset_get_value(info->some_history, i);
+        if (value > max_pressure) max_pressure = value;
+    }
+
+    GdkRGBA *text_color = &state->prefs->text_color;
+    const gdouble dashes[] = { 3.0, 2.0 };
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha * 0.7);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_dash(cr, dashes, G_N_ELEMENTS(dashes), 0);
+    for (gint i = start; i < psi_count; i++) {
+        gdouble x = (gdouble)(i + offset) / count * width;
+        gdouble y = height - (xrg_dataset_get_value(info->some_history, i) / max_pressure * (height - 2)) - 1;
+        if (i == start)
+            cairo_move_to(cr, x, y);
+        else
+            cairo_line_to(cr, x, y);
+    }
+    cairo_stroke(cr);
+    cairo_set_dash(cr, NULL, 0, 0);
+
+    /* Stall marks */
+    GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+    cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha);
+    cairo_set_line_width(cr, 2.0);
+    for (gint i = start; i < psi_count; i++) {
+        if (xrg_dataset_get_value(info->event_history, i) <= 0)
+            continue;
+        gdouble x = (gdouble)(i + offset) / count * width;
+        cairo_move_to(cr, x, 1);
+        cairo_line_to(cr, x, 7);
+    }
+    if (info->pending_events > 0) {
+        gdouble x = state->prefs->show_activity_bars ? width - 22 : width - 2;  /* Left of the bar */
+        cairo_move_to(cr, x, 1);
+        cairo_line_to(cr, x, 7);
+    }
+    cairo_stroke(cr);
+}
+
+/**
+ * Pressure at a tooltip's sample, when the overlay is on
+ */
+static void append_pressure_tooltip(AppState *state, GString *tooltip, XRGPsiResource resource,
+                                    gint index, gint count) {
+    if (!state->prefs->pressure_show_overlay)
+        return;
+    const XRGPsiInfo *info = xrg_psi_collector_get_info(state->psi_collector, resource);
+    gint psi_index = index - (count - xrg_dataset_get_count(info->some_history));
+    if (!info->available || psi_index < 0)
+        return;
+
+    const gchar *cgroup = xrg_psi_collector_get_cgroup(state->psi_collector);
+    g_string_append_printf(tooltip, "\nPressure%s%s: %.1f%% some, %.1f%% full (avg10)",
+                           cgroup ? " in " : "", cgroup ? cgroup : "",
+                           xrg_dataset_get_value(info->some_history, psi_index),
+                           xrg_dataset_get_value(info->full_history, psi_index));
+    g_string_append_printf(tooltip, "\nStalled: %.1f%% of the interval",
+                           xrg_dataset_get_value(info->stall_history, psi_index));
+
+    gint events = (gint)xrg_dataset_get_value(info->event_history, psi_index);
+    if (events > 0)
+        g_string_append_printf(tooltip, ", %d stall alert%s", events, events == 1 ? "" : "s");
+}
+
+/**
+ * Datasets and current rates (MB/s) for the disk view mode. A selected
+ * device that is not present falls back to the busiest disk. Returns the
+ * title for the graph.
+ */
+static const gchar* get_disk_view(AppState *state, XRGDataset **read_dataset, XRGDataset **write_dataset,
+                                  const XRGDiskLoadHistory **load, gdouble *read_rate, gdouble *write_rate) {
+    XRGDiskCollector *collector = state->disk_collector;
+
+    if (state->prefs->disk_view_mode == XRG_DISK_VIEW_ALL) {
+        *read_dataset = xrg_disk_collector_get_all_read_dataset(collector);
+        *write_dataset = xrg_disk_collector_get_all_write_dataset(collector);
+        *load = xrg_disk_collector_get_all_load(collector);
+        *read_rate = xrg_disk_collector_get_all_read_rate(collector);
+        *write_rate = xrg_disk_collector_get_all_write_rate(collector);
+        return "All Disks";
+    }
+
+    if (state->prefs->disk_view_mode == XRG_DISK_VIEW_DEVICE) {
+        gint num_devices = xrg_disk_collector_get_num_devices(collector);
+        for (gint i = 0; i < num_devices; i++) {
+            const XRGDiskDevice *disk = xrg_disk_collector_get_device(collector, i);
+            if (strcmp(disk->name, state->prefs->disk_view_device) != 0)
+                continue;
+
+            *read_dataset = disk->read_history;
+            *write_dataset = disk->write_history;
+            *load = &disk->load;
+            *read_rate = disk->read_rate / (1024.0 * 1024.0);
+            *write_rate = disk->write_rate / (1024.0 * 1024.0);
+            return disk->label;
+        }
+    }
+
+    *read_dataset = xrg_disk_collector_get_read_dataset(collector);
+    *write_dataset = xrg_disk_collector_get_write_dataset(collector);
+    *load = xrg_disk_collector_get_primary_load(collector);
+    *read_rate = xrg_disk_collector_get_read_rate(collector);
+    *write_rate = xrg_disk_collector_get_write_rate(collector);
+    return "Disk I/O";
+}
+
+/**
+ * One-line filesystem summary: "/home 83% used, 41.2 GB free, full in ~6 h"
+ */
+static gchar* format_mount_summary(const XRGMountInfo *mount) {
+    GString *text = g_string_new(NULL);
+    g_string_append_printf(text, "%s %.0f%% used, %.1f GB free", mount->mount_point,
+                           mount->used_percent, mount->avail_bytes / (1024.0 * 1024.0 * 1024.0));
+    if (mount->inode_percent >= 90.0)
+        g_string_append_printf(text, ", %.0f%% inodes", mount->inode_percent);
+    if (mount->hours_to_full >= 0.0 && mount->hours_to_full < 48.0)
+        g_string_append_printf(text, ", full in ~%.0f h", MAX(mount->hours_to_full, 1.0));
+    else if (mount->hours_to_full >= 48.0 && mount->hours_to_full < 24.0 * 90)
+        g_string_append_printf(text, ", full in ~%.0f days", mount->hours_to_full / 24.0);
+    return g_string_free(text, FALSE);
+}
+
 /**
  * Disk motion notify (tooltip)
  */
@@ -1431,8 +2580,10 @@ static gboolean on_disk_motion_notify(GtkWidget *widget, GdkEventMotion *event,
     gtk_widget_get_allocation(widget, &allocation);
 
     /* Get datasets */
-    XRGDataset *read_dataset = xrg_disk_collector_get_read_dataset(state->disk_collector);
-    XRGDataset *write_dataset = xrg_disk_collector_get_write_dataset(state->disk_collector);
+    XRGDataset *read_dataset, *write_dataset;
+    const XRGDiskLoadHistory *load;
+    gdouble read_rate, write_rate;
+    const gchar *title = get_disk_view(state, &read_dataset, &write_dataset, &load, &read_rate, &write_rate);
     gint count = xrg_dataset_get_count(read_dataset);
 
     if (count < 2) {
@@ -1450,10 +2601,28 @@ static gboolean on_disk_motion_notify(GtkWidget *widget, GdkEventMotion *event,
     gdouble write_val = xrg_dataset_get_value(write_dataset, index);
 
     /* Set tooltip */
-    gchar *tooltip = g_strdup_printf("Disk Activity\nRead: %.2f MB/s\nWrite: %.2f MB/s",
-                                     read_val, write_val);
-    gtk_widget_set_tooltip_text(widget, tooltip);
-    g_free(tooltip);
+    GString *tooltip = g_string_new(NULL);
+    g_string_append_printf(tooltip, "Disk Activity (%s)\nRead: %.2f MB/s\nWrite: %.2f MB/s\n"
+                           "IOPS: %.0f\nAwait: %.2f ms\nUtilization: %.0f%%\nQueue Depth: %.2f",
+                           title, read_val, write_val,
+                           xrg_dataset_get_value(load->iops, index),
+                           xrg_dataset_get_value(load->await, index),
+                           xrg_dataset_get_value(load->util, index),
+                           xrg_dataset_get_value(load->queue_depth, index));
+
+    /* The filesystem closest to full, by time if one is filling */
+    const XRGMountInfo *mount = xrg_mounts_collector_get_first_to_fill(state->mounts_collector);
+    if (mount == NULL)
+        mount = xrg_mounts_collector_get_fullest(state->mounts_collector);
+    if (mount != NULL) {
+        gchar *mount_text = format_mount_summary(mount);
+        g_string_append_printf(tooltip, "\n%s", mount_text);
+        g_free(mount_text);
+    }
+    append_pressure_tooltip(state, tooltip, XRG_PSI_IO, index, count);
+
+    gtk_widget_set_tooltip_text(widget, tooltip->str);
+    g_string_free(tooltip, TRUE);
 
     return FALSE;
 }
@@ -1483,8 +2652,10 @@ static gboolean on_draw_disk(GtkWidget *widget, cairo_t *cr, gpointer user_data)
     cairo_stroke(cr);
 
     /* Get disk datasets */
-    XRGDataset *read_dataset = xrg_disk_collector_get_read_dataset(state->disk_collector);
-    XRGDataset *write_dataset = xrg_disk_collector_get_write_dataset(state->disk_collector);
+    XRGDataset *read_dataset, *write_dataset;
+    const XRGDiskLoadHistory *load;
+    gdouble read_rate, write_rate;
+    const gchar *title = get_disk_view(state, &read_dataset, &write_dataset, &load, &read_rate, &write_rate);
 
     gint count = xrg_dataset_get_count(read_dataset);
     if (count < 2) {
@@ -1613,20 +2784,41 @@ static gboolean on_draw_disk(GtkWidget *widget, cairo_t *cr, gpointer user_data)
         }
     }
 
+    /* Await (FG3 line), on its own scale so latency can rise while MB/s stays flat */
+    if (state->prefs->disk_show_latency) {
+        gint await_count = xrg_dataset_get_count(load->await);
+
+        gdouble max_await = 1.0;  /* Minimum 1 ms */
+        for (gint i = 0; i < await_count; i++) {
+            gdouble value = xrg_dataset_get_value(load->await, i);
+            if (value > max_await) max_await = value;
+        }
+
+        GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+        cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha);
+        cairo_set_line_width(cr, 1.0);
+        for (gint i = 0; i < await_count; i++) {
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = height - (xrg_dataset_get_value(load->await, i) / max_await * (height - 2)) - 1;
+            if (i == 0)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
+        }
+        cairo_stroke(cr);
+    }
+
+    draw_pressure_overlay(state, cr, XRG_PSI_IO, width, height, count);
+
     /* Overlay text labels */
     GdkRGBA *text_color = &state->prefs->text_color;
     cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha);
     cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 10.0);
 
-    gdouble read_rate = xrg_disk_collector_get_read_rate(state->disk_collector);
-    gdouble write_rate = xrg_disk_collector_get_write_rate(state->disk_collector);
-
-    /* Line 1: Disk I/O label */
-    gchar *line1 = g_strdup_printf("Disk I/O");
+    /* Line 1: Disk I/O label, or the device shown */
     cairo_move_to(cr, 5, 15);
-    cairo_show_text(cr, line1);
-    g_free(line1);
+    cairo_show_text(cr, title);
 
     /* Line 2: Read rate */
     gchar *line2 = g_strdup_printf("Read: %.2f MB/s", read_rate);
@@ -1640,6 +2832,16 @@ static gboolean on_draw_disk(GtkWidget *widget, cairo_t *cr, gpointer user_data)
     cairo_show_text(cr, line3);
     g_free(line3);
 
+    /* Line 4: Latency and utilization */
+    if (state->prefs->disk_show_latency && height >= 55) {
+        gchar *line4 = g_strdup_printf("Await: %.1f ms, %.0f%% util",
+                                       xrg_dataset_get_latest(load->await),
+                                       xrg_dataset_get_latest(load->util));
+        cairo_move_to(cr, 5, 51);
+        cairo_show_text(cr, line4);
+        g_free(line4);
+    }
+
     /* Draw activity bar on the right (if enabled) */
     if (state->prefs->show_activity_bars) {
         gint bar_x = width - 20;  /* 20px from right edge */
@@ -3341,39 +4543,229 @@ static gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, gpointer use
 
 
 /**
- * Draw CPU graph
+ * Draw one usage strip per CPU group (thread, core or package), stacked
+ * top to bottom. All strips go into a single path so the fill cost is one
+ * rasterisation regardless of group count.
+ */
+static void draw_cpu_group_strips(AppState *state, cairo_t *cr, gint width, gint height) {
+    XRGCPUGranularity granularity = state->prefs->cpu_granularity;
+    gint groups = xrg_cpu_collector_get_group_count(state->cpu_collector, granularity);
+    if (groups <= 0)
+        return;
+
+    gdouble strip_height = (gdouble)height / groups;
+
+    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
+    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha);
+
+    for (gint g = 0; g < groups; g++) {
+        XRGDataset *dataset = xrg_cpu_collector_get_group_dataset(state->cpu_collector, granularity, g);
+        gint count = xrg_dataset_get_count(dataset);
+        if (count < 2)
+            continue;
+
+        gdouble strip_bottom = (g + 1) * strip_height;
+        cairo_move_to(cr, 0, strip_bottom);
+        for (gint i = 0; i < count; i++) {
+            gdouble value = xrg_dataset_get_value(dataset, i);
+            gdouble x = (gdouble)i / count * width;
+            gdouble y = strip_bottom - (value / 100.0 * strip_height);
+            cairo_line_to(cr, x, y);
+        }
+        cairo_line_to(cr, width, strip_bottom);
+        cairo_close_path(cr);
+    }
+    cairo_fill(cr);
+
+    /* Strip separators, only when strips are tall enough to read */
+    if (strip_height >= 4.0) {
+        GdkRGBA *border_color = &state->prefs->border_color;
+        cairo_set_source_rgba(cr, border_color->red, border_color->green, border_color->blue,
+                              border_color->alpha * 0.5);
+        cairo_set_line_width(cr, 1.0);
+        for (gint g = 1; g < groups; g++) {
+            gdouble y = (gint)(g * strip_height) + 0.5;
+            cairo_move_to(cr, 0, y);
+            cairo_line_to(cr, width, y);
+        }
+        cairo_stroke(cr);
+    }
+}
+
+/**
+ * Build the heatmap palette: graph background at 0%, FG1 at 50%, FG3 at 100%.
+ * Rebuilt only when the heatmap surface is recreated.
+ */
+static void build_cpu_heatmap_lut(AppState *state) {
+    const GdkRGBA *stops[3] = {
+        &state->prefs->graph_bg_color,
+        &state->prefs->graph_fg1_color,
+        &state->prefs->graph_fg3_color
+    };
+
+    for (gint i = 0; i < 256; i++) {
+        gdouble t = i / 255.0 * 2.0;
+        gint s = (t >= 1.0) ? 1 : 0;
+        gdouble f = t - s;
+        const GdkRGBA *a = stops[s];
+        const GdkRGBA *b = stops[s + 1];
+
+        guint32 r = (guint32)((a->red + (b->red - a->red) * f) * 255.0 + 0.5);
+        guint32 g = (guint32)((a->green + (b->green - a->green) * f) * 255.0 + 0.5);
+        guint32 bl = (guint32)((a->blue + (b->blue - a->blue) * f) * 255.0 + 0.5);
+        state->cpu_heatmap_lut[i] = 0xFF000000u | (r << 16) | (g << 8) | bl;
+    }
+}
+
+/**
+ * Bring the heatmap surface up to date with the collector. The surface is
+ * dataset-capacity columns wide and one row per CPU group; each new sample
+ * shifts rows left and writes only the new columns, so per-tick work is
+ * proportional to rows, not rows * history.
+ */
+static void update_cpu_heatmap(AppState *state) {
+    XRGCPUGranularity granularity = state->prefs->cpu_granularity;
+    gint rows = xrg_cpu_collector_get_group_count(state->cpu_collector, granularity);
+    if (rows <= 0)
+        return;
+
+    gint columns = xrg_dataset_get_capacity(
+        xrg_cpu_collector_get_group_dataset(state->cpu_collector, granularity, 0));
+    guint64 samples = xrg_cpu_collector_get_sample_count(state->cpu_collector);
+
+    cairo_surface_t *surface = state->cpu_heatmap_surface;
+    if (surface == NULL ||
+        state->cpu_heatmap_granularity != (gint)granularity ||
+        cairo_image_surface_get_width(surface) != columns ||
+        cairo_image_surface_get_height(surface) != rows) {
+        if (surface)
+            cairo_surface_destroy(surface);
+        surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, columns, rows);
+        state->cpu_heatmap_surface = surface;
+        state->cpu_heatmap_granularity = granularity;
+        state->cpu_heatmap_sample = 0;
+        build_cpu_heatmap_lut(state);
+    }
+
+    guint64 new_samples = samples - state->cpu_heatmap_sample;
+    if (new_samples == 0)
+        return;
+    gint shift = (new_samples >= (guint64)columns) ? columns : (gint)new_samples;
+
+    cairo_surface_flush(surface);
+    guchar *data = cairo_image_surface_get_data(surface);
+    gint stride = cairo_image_surface_get_stride(surface);
+
+    for (gint r = 0; r < rows; r++) {
+        guint32 *px = (guint32 *)(data + r * stride);
+        XRGDataset *dataset = xrg_cpu_collector_get_group_dataset(state->cpu_collector, granularity, r);
+        gint count = xrg_dataset_get_count(dataset);
+
+        if (shift < columns)
+            memmove(px, px + shift, (columns - shift) * sizeof(guint32));
+
+        for (gint k = 0; k < shift; k++) {
+            gint i = count - shift + k;
+            gdouble value = (i >= 0) ? xrg_dataset_get_value(dataset, i) : 0.0;
+            gint level = (gint)(CLAMP(value, 0.0, 100.0) * 2.55);
+            px[columns - shift + k] = state->cpu_heatmap_lut[level];
+        }
+    }
+
+    cairo_surface_mark_dirty(surface);
+    state->cpu_heatmap_sample = samples;
+}
+
+/**
+ * Draw the CPU heatmap, stretching the populated columns across the widget
+ */
+static void draw_cpu_heatmap(AppState *state, cairo_t *cr, gint width, gint height, gint count) {
+    update_cpu_heatmap(state);
+    if (state->cpu_heatmap_surface == NULL)
+        return;
+
+    gint columns = cairo_image_surface_get_width(state->cpu_heatmap_surface);
+    gint rows = cairo_image_surface_get_height(state->cpu_heatmap_surface);
+    if (count > columns)
+        count = columns;
+
+    cairo_save(cr);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_clip(cr);
+    cairo_scale(cr, (gdouble)width / count, (gdouble)height / rows);
+    cairo_set_source_surface(cr, state->cpu_heatmap_surface, -(columns - count), 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+/**
+ * Helper: fill the region between two band series
+ */
+static void fill_cpu_band(cairo_t *cr, XRGDataset *upper, XRGDataset *lower,
+                          gint count, gint width, gint height) {
+    for (gint i = 0; i < count; i++) {
+        gdouble x = (gdouble)i / count * width;
+        gdouble y = height - (xrg_dataset_get_value(upper, i) / 100.0 * height);
+        if (i == 0)
+            cairo_move_to(cr, x, y);
+        else
+            cairo_line_to(cr, x, y);
+    }
+    for (gint i = count - 1; i >= 0; i--) {
+        gdouble x = (gdouble)i / count * width;
+        gdouble y = height - (xrg_dataset_get_value(lower, i) / 100.0 * height);
+        cairo_line_to(cr, x, y);
+    }
+    cairo_close_path(cr);
+    cairo_fill(cr);
+}
+
+/**
+ * Draw min/max envelope, p50-p90 band and median line across CPUs.
+ * Cost depends only on history length, not on CPU count.
  */
-static gboolean on_draw_cpu(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
-    AppState *state = (AppState *)user_data;
-    GtkAllocation allocation;
-    gtk_widget_get_allocation(widget, &allocation);
+static void draw_cpu_usage_bands(AppState *state, cairo_t *cr, gint width, gint height) {
+    XRGDataset *min = xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_MIN);
+    XRGDataset *p50 = xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P50);
+    XRGDataset *p90 = xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P90);
+    XRGDataset *max = xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_MAX);
+    gint count = xrg_dataset_get_count(max);
+    if (count < 2)
+        return;
 
-    gint width = allocation.width;
-    gint height = allocation.height;
+    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
+    GdkRGBA *fg2_color = &state->prefs->graph_fg2_color;
 
-    /* Draw background */
-    GdkRGBA *bg_color = &state->prefs->graph_bg_color;
-    cairo_set_source_rgba(cr, bg_color->red, bg_color->green, bg_color->blue, bg_color->alpha);
-    cairo_rectangle(cr, 0, 0, width, height);
-    cairo_fill(cr);
+    /* Min-max envelope */
+    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha * 0.3);
+    fill_cpu_band(cr, max, min, count, width, height);
 
-    /* Draw border */
-    GdkRGBA *border_color = &state->prefs->border_color;
-    cairo_set_source_rgba(cr, border_color->red, border_color->green, border_color->blue, border_color->alpha);
+    /* p50-p90 band */
+    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha * 0.8);
+    fill_cpu_band(cr, p90, p50, count, width, height);
+
+    /* Median line */
+    cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue, fg2_color->alpha);
     cairo_set_line_width(cr, 1.0);
-    cairo_rectangle(cr, 0.5, 0.5, width - 1, height - 1);
+    for (gint i = 0; i < count; i++) {
+        gdouble x = (gdouble)i / count * width;
+        gdouble y = height - (xrg_dataset_get_value(p50, i) / 100.0 * height);
+        if (i == 0)
+            cairo_move_to(cr, x, y);
+        else
+            cairo_line_to(cr, x, y);
+    }
     cairo_stroke(cr);
+}
 
-    /* Get CPU datasets */
+/**
+ * Draw total usage: user, with system stacked on top
+ */
+static void draw_cpu_total_usage(AppState *state, cairo_t *cr, gint width, gint height, gint count) {
     XRGDataset *user_dataset = xrg_cpu_collector_get_user_dataset(state->cpu_collector);
     XRGDataset *system_dataset = xrg_cpu_collector_get_system_dataset(state->cpu_collector);
 
-    gint count = xrg_dataset_get_count(user_dataset);
-    if (count < 2) {
-        /* Not enough data yet */
-        return FALSE;
-    }
-
     /* Draw user CPU usage (cyan - FG1) */
     GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
     cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha);
@@ -3495,6 +4887,76 @@ static gboolean on_draw_cpu(GtkWidget *widget, cairo_t *cr, gpointer user_data)
             cairo_fill(cr);
         }
     }
+}
+
+/**
+ * Draw CPU graph
+ */
+static gboolean on_draw_cpu(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    GtkAllocation allocation;
+    gtk_widget_get_allocation(widget, &allocation);
+
+    gint width = allocation.width;
+    gint height = allocation.height;
+
+    /* Draw background */
+    GdkRGBA *bg_color = &state->prefs->graph_bg_color;
+    cairo_set_source_rgba(cr, bg_color->red, bg_color->green, bg_color->blue, bg_color->alpha);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_fill(cr);
+
+    /* Draw border */
+    GdkRGBA *border_color = &state->prefs->border_color;
+    cairo_set_source_rgba(cr, border_color->red, border_color->green, border_color->blue, border_color->alpha);
+    cairo_set_line_width(cr, 1.0);
+    cairo_rectangle(cr, 0.5, 0.5, width - 1, height - 1);
+    cairo_stroke(cr);
+
+    /* Get CPU datasets */
+    XRGDataset *user_dataset = xrg_cpu_collector_get_user_dataset(state->cpu_collector);
+    XRGDataset *system_dataset = xrg_cpu_collector_get_system_dataset(state->cpu_collector);
+
+    gint count = xrg_dataset_get_count(user_dataset);
+    if (count < 2) {
+        /* Not enough data yet */
+        return FALSE;
+    }
+
+    if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_PER_CPU) {
+        draw_cpu_group_strips(state, cr, width, height);
+    } else if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_HEATMAP) {
+        draw_cpu_heatmap(state, cr, width, height, count);
+    } else if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_BANDS) {
+        draw_cpu_usage_bands(state, cr, width, height);
+    } else {
+        draw_cpu_total_usage(state, cr, width, height, count);
+    }
+
+    /* Clock frequency overlay (average as % of maximum) */
+    gboolean show_frequency = state->prefs->cpu_show_frequency &&
+                              xrg_cpufreq_collector_is_available(state->cpufreq_collector);
+    if (show_frequency) {
+        XRGDataset *freq_dataset = xrg_cpufreq_collector_get_average_percent_dataset(state->cpufreq_collector);
+        gint freq_count = xrg_dataset_get_count(freq_dataset);
+        GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+
+        cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha);
+        cairo_set_line_width(cr, 1.5);
+        for (gint i = 0; i < freq_count; i++) {
+            gdouble value = CLAMP(xrg_dataset_get_value(freq_dataset, i), 0.0, 100.0);
+            gdouble x = (gdouble)i / freq_count * width;
+            gdouble y = height - (value / 100.0 * height);
+            if (i == 0)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
+        }
+        cairo_stroke(cr);
+    }
+
+    draw_perf_overlay(state, cr, width, height, count);
+    draw_pressure_overlay(state, cr, XRG_PSI_CPU, width, height, count);
 
     /* Overlay text labels */
     GdkRGBA *text_color = &state->prefs->text_color;
@@ -3509,24 +4971,64 @@ static gboolean on_draw_cpu(GtkWidget *widget, cairo_t *cr, gpointer user_data)
     gdouble user_usage = xrg_dataset_get_latest(user_dataset);
     gdouble system_usage = xrg_dataset_get_latest(system_dataset);
 
-    /* Line 1: Total CPU */
-    gchar *line1 = g_strdup_printf("CPU: %.1f%%", total_usage);
+    /* Line 1: Total CPU (plus average clock when the overlay is on) */
+    gchar *line1;
+    if (show_frequency) {
+        line1 = g_strdup_printf("CPU: %.1f%% @ %.2f GHz", total_usage,
+                                xrg_cpufreq_collector_get_average_mhz(state->cpufreq_collector) / 1000.0);
+    } else {
+        line1 = g_strdup_printf("CPU: %.1f%%", total_usage);
+    }
     cairo_move_to(cr, 5, 15);
     cairo_show_text(cr, line1);
     g_free(line1);
 
-    /* Line 2: User and System */
-    gchar *line2 = g_strdup_printf("User: %.1f%% | System: %.1f%%", user_usage, system_usage);
+    /* Line 2: User and System (or the spread across CPUs in band view) */
+    gchar *line2;
+    if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_BANDS) {
+        line2 = g_strdup_printf("p50: %.0f%% | p90: %.0f%% | Max: %.0f%%",
+            xrg_dataset_get_latest(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P50)),
+            xrg_dataset_get_latest(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_P90)),
+            xrg_dataset_get_latest(xrg_cpu_collector_get_band_dataset(state->cpu_collector, XRG_CPU_BAND_MAX)));
+    } else {
+        line2 = g_strdup_printf("User: %.1f%% | System: %.1f%%", user_usage, system_usage);
+    }
     cairo_move_to(cr, 5, 27);
     cairo_show_text(cr, line2);
     g_free(line2);
 
-    /* Line 3: Load average */
-    gchar *line3 = g_strdup_printf("Load: %.2f", load_avg);
+    /* Line 3: Load average (plus row grouping in per-CPU views) */
+    gchar *line3;
+    if (state->prefs->cpu_view_mode == XRG_CPU_VIEW_PER_CPU ||
+        state->prefs->cpu_view_mode == XRG_CPU_VIEW_HEATMAP) {
+        XRGCPUGranularity granularity = state->prefs->cpu_granularity;
+        line3 = g_strdup_printf("Load: %.2f | %d %s", load_avg,
+                                xrg_cpu_collector_get_group_count(state->cpu_collector, granularity),
+                                xrg_cpu_granularity_name(granularity));
+    } else {
+        line3 = g_strdup_printf("Load: %.2f", load_avg);
+    }
     cairo_move_to(cr, 5, 39);
     cairo_show_text(cr, line3);
     g_free(line3);
 
+    /* Line 4: Performance counters */
+    if (state->perf_collector != NULL && height >= 55) {
+        XRGPerfCollector *perf = state->perf_collector;
+        gchar *line4;
+        if (xrg_perf_collector_has_hardware(perf)) {
+            line4 = g_strdup_printf("IPC: %.2f | MPKI: %.1f", xrg_perf_collector_get_ipc(perf),
+                                    xrg_perf_collector_get_cache_mpki(perf));
+        } else {
+            line4 = g_strdup_printf("Ctx: %.0f/s | Migr: %.0f/s",
+                                    xrg_perf_collector_get_rate(perf, XRG_PERF_CONTEXT_SWITCHES),
+                                    xrg_perf_collector_get_rate(perf, XRG_PERF_CPU_MIGRATIONS));
+        }
+        cairo_move_to(cr, 5, 51);
+        cairo_show_text(cr, line4);
+        g_free(line4);
+    }
+
     /* Draw activity bar on the right (if enabled) */
     if (state->prefs->show_activity_bars) {
         gint bar_x = width - 20;  /* 20px from right edge */
@@ -3621,210 +5123,50 @@ static gboolean on_draw_memory(GtkWidget *widget, cairo_t *cr, gpointer user_dat
     cairo_rectangle(cr, 0.5, 0.5, width - 1, height - 1);
     cairo_stroke(cr);
 
-    /* Get memory datasets */
-    XRGDataset *used_dataset = xrg_memory_collector_get_used_dataset(state->memory_collector);
-    XRGDataset *wired_dataset = xrg_memory_collector_get_wired_dataset(state->memory_collector);
-    XRGDataset *cached_dataset = xrg_memory_collector_get_cached_dataset(state->memory_collector);
-
-    gint count = xrg_dataset_get_count(used_dataset);
-    if (count < 2) {
-        /* Not enough data yet */
-        return FALSE;
-    }
-
-    /* Draw used memory (cyan - FG1) - bottom layer */
-    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
-    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, fg1_color->alpha);
-
-    XRGGraphStyle style = state->prefs->memory_graph_style;
-
-    if (style == XRG_GRAPH_STYLE_SOLID) {
-        /* Solid filled area (original behavior) */
-        cairo_move_to(cr, 0, height);
-        for (gint i = 0; i < count; i++) {
-            gdouble value = xrg_dataset_get_value(used_dataset, i);
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (value / 100.0 * height);
-            cairo_line_to(cr, x, y);
-        }
-        cairo_line_to(cr, width, height);
-        cairo_close_path(cr);
-        cairo_fill(cr);
-    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
-        /* Chunky pixels - fill area with dots */
-        gint dot_spacing = 4;
-        for (gint i = 0; i < count; i++) {
-            gdouble value = xrg_dataset_get_value(used_dataset, i);
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_top = height - (value / 100.0 * height);
-
-            /* Fill from bottom to the data line with dots */
-            for (gdouble y = height; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
-    } else if (style == XRG_GRAPH_STYLE_DOT) {
-        /* Fine dots - fill area with small dots */
-        gint dot_spacing = 2;
-        for (gint i = 0; i < count; i++) {
-            gdouble value = xrg_dataset_get_value(used_dataset, i);
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_top = height - (value / 100.0 * height);
-
-            /* Fill from bottom to the data line with dots */
-            for (gdouble y = height; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
-    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
-        /* Hollow - outline only with dots */
-        for (gint i = 0; i < count; i++) {
-            gdouble value = xrg_dataset_get_value(used_dataset, i);
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (value / 100.0 * height);
-            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
-            cairo_fill(cr);
-        }
-    }
-
-    /* Draw wired memory on top (purple - FG2) */
-    GdkRGBA *fg2_color = &state->prefs->graph_fg2_color;
-    cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue, fg2_color->alpha * 0.7);
-
-    if (style == XRG_GRAPH_STYLE_SOLID) {
-        /* Solid filled area (original behavior) */
-        cairo_move_to(cr, 0, height);
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble total_val = used_val + wired_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (total_val / 100.0 * height);
-            cairo_line_to(cr, x, y);
-        }
-        cairo_line_to(cr, width, height);
-        cairo_close_path(cr);
-        cairo_fill(cr);
-    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
-        /* Chunky pixels - fill area with dots (stacked on top of used) */
-        gint dot_spacing = 4;
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble total_val = used_val + wired_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_bottom = height - (used_val / 100.0 * height);
-            gdouble y_top = height - (total_val / 100.0 * height);
-
-            /* Fill from used level to total level with dots */
-            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
-    } else if (style == XRG_GRAPH_STYLE_DOT) {
-        /* Fine dots - fill area with small dots (stacked on top of used) */
-        gint dot_spacing = 2;
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble total_val = used_val + wired_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_bottom = height - (used_val / 100.0 * height);
-            gdouble y_top = height - (total_val / 100.0 * height);
-
-            /* Fill from used level to total level with dots */
-            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
-    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
-        /* Hollow - outline only with dots (stacked on top of used) */
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble total_val = used_val + wired_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (total_val / 100.0 * height);
-            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
-            cairo_fill(cr);
-        }
-    }
-
-    /* Draw cached memory on top (amber - FG3) */
-    GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
-    cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha * 0.5);
-
-    if (style == XRG_GRAPH_STYLE_SOLID) {
-        /* Solid filled area (original behavior) */
-        cairo_move_to(cr, 0, height);
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
-            gdouble total_val = used_val + wired_val + cached_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (total_val / 100.0 * height);
-            cairo_line_to(cr, x, y);
-        }
-        cairo_line_to(cr, width, height);
-        cairo_close_path(cr);
-        cairo_fill(cr);
-    } else if (style == XRG_GRAPH_STYLE_PIXEL) {
-        /* Chunky pixels - fill area with dots (stacked on top of used+wired) */
-        gint dot_spacing = 4;
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
-            gdouble total_val = used_val + wired_val + cached_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_bottom = height - ((used_val + wired_val) / 100.0 * height);
-            gdouble y_top = height - (total_val / 100.0 * height);
-
-            /* Fill from used+wired level to total level with dots */
-            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 1.5, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
-    } else if (style == XRG_GRAPH_STYLE_DOT) {
-        /* Fine dots - fill area with small dots (stacked on top of used+wired) */
-        gint dot_spacing = 2;
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
-            gdouble total_val = used_val + wired_val + cached_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y_bottom = height - ((used_val + wired_val) / 100.0 * height);
-            gdouble y_top = height - (total_val / 100.0 * height);
+    /* Get memory datasets */
+    XRGDataset *used_dataset = xrg_memory_collector_get_used_dataset(state->memory_collector);
+    XRGDataset *wired_dataset = xrg_memory_collector_get_wired_dataset(state->memory_collector);
+    XRGDataset *cached_dataset = xrg_memory_collector_get_cached_dataset(state->memory_collector);
 
-            /* Fill from used+wired level to total level with dots */
-            for (gdouble y = y_bottom; y >= y_top; y -= dot_spacing) {
-                cairo_arc(cr, x, y, 0.6, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
+    gint count = xrg_dataset_get_count(used_dataset);
+    if (count < 2) {
+        /* Not enough data yet */
+        return FALSE;
+    }
+
+    if (show_numa_view(state))
+        draw_numa_nodes(state, cr, width, height, count);
+    else
+        draw_memory_breakdown(state, cr, width, height, count);
+
+    draw_pressure_overlay(state, cr, XRG_PSI_MEMORY, width, height, count);
+
+    /* Overlay counter (text-colored line), on its own scale and aligned to the right edge */
+    GdkRGBA *text_color = &state->prefs->text_color;
+    XRGDataset *overlay_dataset = get_memory_overlay(state);
+    if (overlay_dataset != NULL) {
+        gint overlay_count = xrg_dataset_get_count(overlay_dataset);
+
+        gdouble max_value = 1.0;
+        for (gint i = 0; i < overlay_count; i++) {
+            gdouble value = xrg_dataset_get_value(overlay_dataset, i);
+            if (value > max_value) max_value = value;
         }
-    } else if (style == XRG_GRAPH_STYLE_HOLLOW) {
-        /* Hollow - outline only with dots (stacked on top of used+wired) */
-        for (gint i = 0; i < count; i++) {
-            gdouble used_val = xrg_dataset_get_value(used_dataset, i);
-            gdouble wired_val = xrg_dataset_get_value(wired_dataset, i);
-            gdouble cached_val = xrg_dataset_get_value(cached_dataset, i);
-            gdouble total_val = used_val + wired_val + cached_val;
-            gdouble x = (gdouble)i / count * width;
-            gdouble y = height - (total_val / 100.0 * height);
-            cairo_arc(cr, x, y, 1.0, 0, 2 * G_PI);
-            cairo_fill(cr);
+
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha * 0.8);
+        cairo_set_line_width(cr, 1.0);
+        for (gint i = 0; i < overlay_count; i++) {
+            gdouble x = (gdouble)(i + count - overlay_count) / count * width;
+            gdouble y = height - (xrg_dataset_get_value(overlay_dataset, i) / max_value * (height - 2)) - 1;
+            if (i == 0)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
         }
+        cairo_stroke(cr);
     }
 
     /* Overlay text labels */
-    GdkRGBA *text_color = &state->prefs->text_color;
     cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha);
     cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 10.0);
@@ -3861,6 +5203,15 @@ static gboolean on_draw_memory(GtkWidget *widget, cairo_t *cr, gpointer user_dat
     cairo_show_text(cr, line3);
     g_free(line3);
 
+    /* Line 4: Overlay counter */
+    if (overlay_dataset != NULL && height >= 55) {
+        gchar *line4 = format_memory_counter(state, state->prefs->memory_overlay_counter,
+                                             xrg_dataset_get_latest(overlay_dataset));
+        cairo_move_to(cr, 5, 51);
+        cairo_show_text(cr, line4);
+        g_free(line4);
+    }
+
     /* Draw activity bar on the right (if enabled) */
     if (state->prefs->show_activity_bars) {
         gint bar_x = width - 20;  /* 20px from right edge */
@@ -4089,111 +5440,418 @@ static gboolean on_draw_network(GtkWidget *widget, cairo_t *cr, gpointer user_da
         }
     }
 
-    /* Overlay text labels */
+    /* TCP retransmits (FG3 line), on their own scale */
+    gboolean have_retransmits = xrg_network_collector_has_stat(state->network_collector,
+                                                               XRG_NETWORK_STAT_RETRANSMITS);
+    if (have_retransmits) {
+        XRGDataset *retransmit_dataset = xrg_network_collector_get_stat_dataset(state->network_collector,
+                                                                                XRG_NETWORK_STAT_RETRANSMITS);
+        gint retransmit_count = xrg_dataset_get_count(retransmit_dataset);
+
+        gdouble max_retransmits = 1.0;  /* Minimum 1 per second */
+        for (gint i = 0; i < retransmit_count; i++) {
+            gdouble value = xrg_dataset_get_value(retransmit_dataset, i);
+            if (value > max_retransmits) max_retransmits = value;
+        }
+
+        GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+        cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, fg3_color->alpha);
+        cairo_set_line_width(cr, 1.0);
+        for (gint i = 0; i < retransmit_count; i++) {
+            /* Right-aligned with the traffic samples */
+            gdouble x = (gdouble)(count - retransmit_count + i) / count * width;
+            gdouble y = height - (xrg_dataset_get_value(retransmit_dataset, i) / max_retransmits * (height - 2)) - 1;
+            if (i == 0)
+                cairo_move_to(cr, x, y);
+            else
+                cairo_line_to(cr, x, y);
+        }
+        cairo_stroke(cr);
+    }
+
+    /* Overlay text labels */
+    GdkRGBA *text_color = &state->prefs->text_color;
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha);
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 10.0);
+
+    gdouble download_rate = xrg_network_collector_get_download_rate(state->network_collector);
+    gdouble upload_rate = xrg_network_collector_get_upload_rate(state->network_collector);
+
+    /* Line 1: Network label */
+    gchar *line1 = g_strdup_printf("Network");
+    cairo_move_to(cr, 5, 15);
+    cairo_show_text(cr, line1);
+    g_free(line1);
+
+    /* Line 2: Download rate */
+    gchar *line2 = g_strdup_printf("↓ %.2f MB/s", download_rate);
+    cairo_move_to(cr, 5, 27);
+    cairo_show_text(cr, line2);
+    g_free(line2);
+
+    /* Line 3: Upload rate */
+    gchar *line3 = g_strdup_printf("↑ %.2f MB/s", upload_rate);
+    cairo_move_to(cr, 5, 39);
+    cairo_show_text(cr, line3);
+    g_free(line3);
+
+    /* Line 4: TCP retransmits */
+    if (have_retransmits && height >= 55) {
+        gchar *line4 = g_strdup_printf("Retrans %.0f/s",
+                                       xrg_network_collector_get_stat_rate(state->network_collector,
+                                                                           XRG_NETWORK_STAT_RETRANSMITS));
+        cairo_move_to(cr, 5, 51);
+        cairo_show_text(cr, line4);
+        g_free(line4);
+    }
+
+    /* Draw activity bar on the right (if enabled) */
+    if (state->prefs->show_activity_bars) {
+        gint bar_x = width - 20;  /* 20px from right edge */
+        gint bar_width = 20;
+
+        /* Draw bar background */
+        cairo_set_source_rgba(cr, bg_color->red, bg_color->green, bg_color->blue, bg_color->alpha);
+        cairo_rectangle(cr, bar_x, 0, bar_width, height);
+        cairo_fill(cr);
+
+        /* Draw bar border */
+        cairo_set_source_rgba(cr, border_color->red, border_color->green, border_color->blue, border_color->alpha);
+        cairo_set_line_width(cr, 1.0);
+        cairo_rectangle(cr, bar_x + 0.5, 0.5, bar_width - 1, height - 1);
+        cairo_stroke(cr);
+
+        /* Find max download rate in dataset to scale the bar */
+        gdouble max_rate = 0.1;  /* Minimum to avoid division by zero */
+        for (gint i = 0; i < count; i++) {
+            gdouble rate = xrg_dataset_get_value(download_dataset, i);
+            if (rate > max_rate) {
+                max_rate = rate;
+            }
+        }
+
+        /* Draw filled bar representing current download rate */
+        gdouble current_value = download_rate / max_rate;
+        if (current_value > 1.0) current_value = 1.0;  /* Cap at 100% */
+        gdouble fill_height = current_value * height;
+        gdouble bar_y = height - fill_height;
+
+        XRGGraphStyle bar_style = state->prefs->activity_bar_style;
+        GdkRGBA gradient_color;
+
+        if (bar_style == XRG_GRAPH_STYLE_SOLID) {
+            /* Draw gradient by slicing horizontally */
+            for (gdouble y = height; y >= bar_y; y -= 1.0) {
+                gdouble position = (height - y) / height;
+                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
+                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
+                cairo_rectangle(cr, bar_x, y, bar_width, 1.0);
+                cairo_fill(cr);
+            }
+        } else if (bar_style == XRG_GRAPH_STYLE_PIXEL) {
+            /* Chunky pixels with gradient colors */
+            for (gdouble y = height; y >= bar_y; y -= 4) {
+                gdouble position = (height - y) / height;
+                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
+                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
+                for (gdouble x = bar_x; x < bar_x + bar_width; x += 4) {
+                    cairo_arc(cr, x + 2, y, 1.5, 0, 2 * G_PI);
+                    cairo_fill(cr);
+                }
+            }
+        } else if (bar_style == XRG_GRAPH_STYLE_DOT) {
+            /* Fine dots with gradient colors */
+            for (gdouble y = height; y >= bar_y; y -= 2) {
+                gdouble position = (height - y) / height;
+                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
+                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
+                for (gdouble x = bar_x; x < bar_x + bar_width; x += 2) {
+                    cairo_arc(cr, x + 1, y, 0.6, 0, 2 * G_PI);
+                    cairo_fill(cr);
+                }
+            }
+        } else if (bar_style == XRG_GRAPH_STYLE_HOLLOW) {
+            /* Outline only - draw dots at top of fill level with gradient color */
+            gdouble position = (height - bar_y) / height;
+            get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
+            cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
+            for (gdouble x = bar_x; x < bar_x + bar_width; x += 2) {
+                cairo_arc(cr, x, bar_y, 1.0, 0, 2 * G_PI);
+                cairo_fill(cr);
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Whether the process module shows cgroups instead of processes
+ */
+static gboolean process_view_is_cgroups(AppState *state) {
+    return state->prefs->process_show_cgroups &&
+           xrg_cgroup_collector_is_available(state->cgroup_collector);
+}
+
+/**
+ * Draw recent samples across a row, newest at the right edge; filled, or as a line
+ */
+static void draw_process_sparkline(cairo_t *cr, const gfloat *values, gint count,
+                                   gdouble max_value, gint x, gint y, gint width, gint height,
+                                   GdkRGBA *color, gboolean filled) {
+    if (count < 2 || max_value <= 0 || width <= 0) return;
+
+    gdouble step = (gdouble)width / (XRG_PROCESS_HISTORY_LENGTH - 1);
+    gdouble x0 = x + width - (count - 1) * step;
+
+    cairo_new_path(cr);
+    for (gint i = 0; i < count; i++) {
+        gdouble py = y + height - CLAMP(values[i] / max_value, 0.0, 1.0) * height;
+        if (i == 0) {
+            cairo_move_to(cr, x0, py);
+        } else {
+            cairo_line_to(cr, x0 + i * step, py);
+        }
+    }
+
+    if (filled) {
+        cairo_line_to(cr, x0 + (count - 1) * step, y + height);
+        cairo_line_to(cr, x0, y + height);
+        cairo_close_path(cr);
+        cairo_set_source_rgba(cr, color->red, color->green, color->blue, 0.25);
+        cairo_fill(cr);
+    } else {
+        cairo_set_source_rgba(cr, color->red, color->green, color->blue, 0.6);
+        cairo_set_line_width(cr, 1.0);
+        cairo_stroke(cr);
+    }
+}
+
+/**
+ * Draw row sparklines: CPU scaled to its peak (at least 10%), memory to its own peak
+ */
+static void draw_process_history(cairo_t *cr, XRGProcessCollector *collector, const XRGProcessInfo *proc,
+                                 gint x, gint y, gint width, gint height,
+                                 GdkRGBA *cpu_color, GdkRGBA *mem_color) {
+    gfloat cpu[XRG_PROCESS_HISTORY_LENGTH];
+    gfloat mem[XRG_PROCESS_HISTORY_LENGTH];
+    gint count = xrg_process_collector_get_history(collector, proc, cpu, mem, XRG_PROCESS_HISTORY_LENGTH);
+
+    gdouble cpu_peak = 10.0, mem_peak = 0.0;
+    for (gint i = 0; i < count; i++) {
+        cpu_peak = MAX(cpu_peak, cpu[i]);
+        mem_peak = MAX(mem_peak, mem[i]);
+    }
+
+    draw_process_sparkline(cr, cpu, count, cpu_peak, x, y, width, height, cpu_color, TRUE);
+    draw_process_sparkline(cr, mem, count, mem_peak, x, y, width, height, mem_color, FALSE);
+}
+
+/**
+ * Draw one usage column: a bar filled to ratio with the value beside it
+ */
+static void draw_usage_column(cairo_t *cr, GdkRGBA *color, GdkRGBA *text_color,
+                              gint col_x, gint row_y, gint row_height,
+                              gdouble ratio, const gchar *text) {
+    gint bar_width = 30;
+    gint bar_height = row_height - 4;
+    gint bar_x = col_x - bar_width - 2;
+
+    cairo_set_source_rgba(cr, color->red, color->green, color->blue, 0.2);
+    cairo_rectangle(cr, bar_x, row_y + 2, bar_width, bar_height);
+    cairo_fill(cr);
+
+    ratio = CLAMP(ratio, 0.0, 1.0);
+    if (ratio > 0) {
+        cairo_set_source_rgba(cr, color->red, color->green, color->blue, 0.8);
+        cairo_rectangle(cr, bar_x, row_y + 2, (gint)(ratio * bar_width), bar_height);
+        cairo_fill(cr);
+    }
+
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.9);
+    cairo_move_to(cr, col_x, row_y + row_height - 3);
+    cairo_show_text(cr, text);
+}
+
+/**
+ * Process module, cgroup view: top leaf cgroups (services, containers)
+ */
+static void draw_cgroup_list(AppState *state, cairo_t *cr, gint width, gint height) {
+    GdkRGBA *text_color = &state->prefs->text_color;
+    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
+    GdkRGBA *fg2_color = &state->prefs->graph_fg2_color;
+    GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+
+    gint margin = 4;
+    gint header_height = 14;
+    gint row_height = 14;
+    gint y_offset = margin;
+
+    XRGCgroupSortBy sort_by = xrg_cgroup_collector_get_sort_by(state->cgroup_collector);
+    gboolean show_io = (sort_by == XRG_CGROUP_SORT_IO);
+
+    /* Column headers; the last column is memory, or I/O when sorting by it */
+    gint col_name = margin;
+    gint col_cpu = width - 90;
+    gint col_last = width - 45;
+
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.7);
+    cairo_move_to(cr, col_name, y_offset + 10);
+    cairo_show_text(cr, "Cgroup");
+
+    cairo_move_to(cr, col_cpu, y_offset + 10);
+    if (sort_by == XRG_CGROUP_SORT_CPU) {
+        cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, 1.0);
+    }
+    cairo_show_text(cr, "CPU%");
+
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.7);
+    cairo_move_to(cr, col_last, y_offset + 10);
+    if (sort_by == XRG_CGROUP_SORT_MEMORY) {
+        cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue, 1.0);
+    } else if (show_io) {
+        cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, 1.0);
+    }
+    cairo_show_text(cr, show_io ? "MB/s" : "Mem%");
+
+    y_offset += header_height + 2;
+
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.3);
+    cairo_set_line_width(cr, 0.5);
+    cairo_move_to(cr, margin, y_offset);
+    cairo_line_to(cr, width - margin, y_offset);
+    cairo_stroke(cr);
+
+    y_offset += 4;
+
+    gint num_cgroups = xrg_cgroup_collector_get_top_count(state->cgroup_collector);
+    gint max_rows = (height - y_offset - margin) / row_height;
+    guint64 total_memory = xrg_process_collector_get_total_memory(state->process_collector);
+
+    /* I/O bars are relative to the busiest cgroup shown */
+    gdouble max_io = 0.0;
+    if (show_io && num_cgroups > 0) {
+        const XRGCgroupInfo *busiest = xrg_cgroup_collector_get_top(state->cgroup_collector, 0);
+        max_io = busiest->read_rate + busiest->write_rate;
+    }
+
+    gint row = 0;
+    for (; row < num_cgroups && row < max_rows; row++) {
+        const XRGCgroupInfo *cg = xrg_cgroup_collector_get_top(state->cgroup_collector, row);
+        gint row_y = y_offset + row * row_height;
+
+        gchar name_buf[24];
+        g_snprintf(name_buf, sizeof(name_buf), "%.18s", cg->name);
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.9);
+        cairo_move_to(cr, col_name, row_y + row_height - 3);
+        cairo_show_text(cr, name_buf);
+
+        gchar value_str[16];
+        g_snprintf(value_str, sizeof(value_str), "%4.1f", cg->cpu_percent);
+        draw_usage_column(cr, fg1_color, text_color, col_cpu, row_y, row_height,
+                          cg->cpu_percent / 100.0, value_str);
+
+        if (show_io) {
+            gdouble io_rate = cg->read_rate + cg->write_rate;
+            g_snprintf(value_str, sizeof(value_str), "%4.1f", io_rate / (1024.0 * 1024.0));
+            draw_usage_column(cr, fg3_color, text_color, col_last, row_y, row_height,
+                              max_io > 0 ? io_rate / max_io : 0.0, value_str);
+        } else {
+            gdouble mem_percent = total_memory > 0 ? (gdouble)cg->memory_bytes / total_memory * 100.0 : 0.0;
+            g_snprintf(value_str, sizeof(value_str), "%4.1f", mem_percent);
+            draw_usage_column(cr, fg2_color, text_color, col_last, row_y, row_height,
+                              mem_percent / 100.0, value_str);
+        }
+    }
+
+    /* Summary */
+    gint summary_y = height - margin - 2;
+    if (summary_y > y_offset + row * row_height + 10) {
+        gchar summary[64];
+        g_snprintf(summary, sizeof(summary), "Cgroups: %d",
+                   xrg_cgroup_collector_get_num_cgroups(state->cgroup_collector));
+
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.5);
+        cairo_set_font_size(cr, 9);
+        cairo_move_to(cr, margin, summary_y);
+        cairo_show_text(cr, summary);
+    }
+}
+
+/**
+ * Process module, thread drill-down: busiest threads of the selected process
+ */
+static void draw_thread_list(AppState *state, cairo_t *cr, gint width, gint height) {
     GdkRGBA *text_color = &state->prefs->text_color;
-    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, text_color->alpha);
-    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(cr, 10.0);
+    GdkRGBA *fg1_color = &state->prefs->graph_fg1_color;
 
-    gdouble download_rate = xrg_network_collector_get_download_rate(state->network_collector);
-    gdouble upload_rate = xrg_network_collector_get_upload_rate(state->network_collector);
+    gint margin = 4;
+    gint header_height = 14;
+    gint row_height = 14;
+    gint y_offset = margin;
 
-    /* Line 1: Network label */
-    gchar *line1 = g_strdup_printf("Network");
-    cairo_move_to(cr, 5, 15);
-    cairo_show_text(cr, line1);
-    g_free(line1);
+    gint col_name = margin;
+    gint col_cpu = width - 45;
 
-    /* Line 2: Download rate */
-    gchar *line2 = g_strdup_printf("↓ %.2f MB/s", download_rate);
-    cairo_move_to(cr, 5, 27);
-    cairo_show_text(cr, line2);
-    g_free(line2);
+    gchar title[96];
+    g_snprintf(title, sizeof(title), "%.20s %d",
+               state->thread_process_name, xrg_process_collector_get_thread_pid(state->process_collector));
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.7);
+    cairo_move_to(cr, col_name, y_offset + 10);
+    cairo_show_text(cr, title);
 
-    /* Line 3: Upload rate */
-    gchar *line3 = g_strdup_printf("↑ %.2f MB/s", upload_rate);
-    cairo_move_to(cr, 5, 39);
-    cairo_show_text(cr, line3);
-    g_free(line3);
+    cairo_set_source_rgba(cr, fg1_color->red, fg1_color->green, fg1_color->blue, 1.0);
+    cairo_move_to(cr, col_cpu, y_offset + 10);
+    cairo_show_text(cr, "CPU%");
 
-    /* Draw activity bar on the right (if enabled) */
-    if (state->prefs->show_activity_bars) {
-        gint bar_x = width - 20;  /* 20px from right edge */
-        gint bar_width = 20;
+    y_offset += header_height + 2;
 
-        /* Draw bar background */
-        cairo_set_source_rgba(cr, bg_color->red, bg_color->green, bg_color->blue, bg_color->alpha);
-        cairo_rectangle(cr, bar_x, 0, bar_width, height);
-        cairo_fill(cr);
+    cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.3);
+    cairo_set_line_width(cr, 0.5);
+    cairo_move_to(cr, margin, y_offset);
+    cairo_line_to(cr, width - margin, y_offset);
+    cairo_stroke(cr);
 
-        /* Draw bar border */
-        cairo_set_source_rgba(cr, border_color->red, border_color->green, border_color->blue, border_color->alpha);
-        cairo_set_line_width(cr, 1.0);
-        cairo_rectangle(cr, bar_x + 0.5, 0.5, bar_width - 1, height - 1);
-        cairo_stroke(cr);
+    y_offset += 4;
 
-        /* Find max download rate in dataset to scale the bar */
-        gdouble max_rate = 0.1;  /* Minimum to avoid division by zero */
-        for (gint i = 0; i < count; i++) {
-            gdouble rate = xrg_dataset_get_value(download_dataset, i);
-            if (rate > max_rate) {
-                max_rate = rate;
-            }
-        }
+    gint num_threads = xrg_process_collector_get_thread_count(state->process_collector);
+    gint max_rows = (height - y_offset - margin) / row_height;
 
-        /* Draw filled bar representing current download rate */
-        gdouble current_value = download_rate / max_rate;
-        if (current_value > 1.0) current_value = 1.0;  /* Cap at 100% */
-        gdouble fill_height = current_value * height;
-        gdouble bar_y = height - fill_height;
+    if (num_threads == 0) {
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.5);
+        cairo_move_to(cr, col_name, y_offset + row_height - 3);
+        cairo_show_text(cr, "Process has exited");
+    }
 
-        XRGGraphStyle bar_style = state->prefs->activity_bar_style;
-        GdkRGBA gradient_color;
+    gint row = 0;
+    for (; row < num_threads && row < max_rows; row++) {
+        const XRGThreadInfo *thread = xrg_process_collector_get_thread_at(state->process_collector, row);
+        gint row_y = y_offset + row * row_height;
 
-        if (bar_style == XRG_GRAPH_STYLE_SOLID) {
-            /* Draw gradient by slicing horizontally */
-            for (gdouble y = height; y >= bar_y; y -= 1.0) {
-                gdouble position = (height - y) / height;
-                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
-                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
-                cairo_rectangle(cr, bar_x, y, bar_width, 1.0);
-                cairo_fill(cr);
-            }
-        } else if (bar_style == XRG_GRAPH_STYLE_PIXEL) {
-            /* Chunky pixels with gradient colors */
-            for (gdouble y = height; y >= bar_y; y -= 4) {
-                gdouble position = (height - y) / height;
-                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
-                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
-                for (gdouble x = bar_x; x < bar_x + bar_width; x += 4) {
-                    cairo_arc(cr, x + 2, y, 1.5, 0, 2 * G_PI);
-                    cairo_fill(cr);
-                }
-            }
-        } else if (bar_style == XRG_GRAPH_STYLE_DOT) {
-            /* Fine dots with gradient colors */
-            for (gdouble y = height; y >= bar_y; y -= 2) {
-                gdouble position = (height - y) / height;
-                get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
-                cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
-                for (gdouble x = bar_x; x < bar_x + bar_width; x += 2) {
-                    cairo_arc(cr, x + 1, y, 0.6, 0, 2 * G_PI);
-                    cairo_fill(cr);
-                }
-            }
-        } else if (bar_style == XRG_GRAPH_STYLE_HOLLOW) {
-            /* Outline only - draw dots at top of fill level with gradient color */
-            gdouble position = (height - bar_y) / height;
-            get_activity_bar_gradient_color(position, state->prefs, &gradient_color);
-            cairo_set_source_rgba(cr, gradient_color.red, gradient_color.green, gradient_color.blue, gradient_color.alpha);
-            for (gdouble x = bar_x; x < bar_x + bar_width; x += 2) {
-                cairo_arc(cr, x, bar_y, 1.0, 0, 2 * G_PI);
-                cairo_fill(cr);
-            }
-        }
+        gchar name_buf[32];
+        g_snprintf(name_buf, sizeof(name_buf), "%-15s %d", thread->name, thread->tid);
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.9);
+        cairo_move_to(cr, col_name, row_y + row_height - 3);
+        cairo_show_text(cr, name_buf);
+
+        gchar value_str[16];
+        g_snprintf(value_str, sizeof(value_str), "%4.1f", thread->cpu_percent);
+        draw_usage_column(cr, fg1_color, text_color, col_cpu, row_y, row_height,
+                          thread->cpu_percent / 100.0, value_str);
     }
 
-    return FALSE;
+    /* Summary */
+    gint summary_y = height - margin - 2;
+    if (summary_y > y_offset + MAX(row, 1) * row_height + 10) {
+        gchar summary[64];
+        g_snprintf(summary, sizeof(summary), "Threads: %d (click to go back)", num_threads);
+
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.5);
+        cairo_set_font_size(cr, 9);
+        cairo_move_to(cr, margin, summary_y);
+        cairo_show_text(cr, summary);
+    }
 }
 
 /**
@@ -4229,6 +5887,16 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
     cairo_select_font_face(cr, "monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, 10);
 
+    if (process_view_is_cgroups(state)) {
+        draw_cgroup_list(state, cr, width, height);
+        return FALSE;
+    }
+
+    if (xrg_process_collector_get_thread_pid(state->process_collector) > 0) {
+        draw_thread_list(state, cr, width, height);
+        return FALSE;
+    }
+
     /* Calculate layout */
     gint margin = 4;
     gint header_height = 14;
@@ -4254,12 +5922,18 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
     }
     cairo_show_text(cr, "CPU%");
 
+    /* Last column is memory, or I/O when sorting by it */
+    gboolean show_io = (sort_by == XRG_PROCESS_SORT_IO);
+    GdkRGBA *fg3_color = &state->prefs->graph_fg3_color;
+
     cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.7);
     cairo_move_to(cr, col_mem, y_offset + 10);
     if (sort_by == XRG_PROCESS_SORT_MEMORY) {
         cairo_set_source_rgba(cr, fg2_color->red, fg2_color->green, fg2_color->blue, 1.0);
+    } else if (show_io) {
+        cairo_set_source_rgba(cr, fg3_color->red, fg3_color->green, fg3_color->blue, 1.0);
     }
-    cairo_show_text(cr, "Mem%");
+    cairo_show_text(cr, show_io ? "MB/s" : "Mem%");
 
     y_offset += header_height + 2;
 
@@ -4273,26 +5947,41 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
     y_offset += 4;
 
     /* Draw process list */
-    GList *processes = xrg_process_collector_get_processes(state->process_collector);
+    const XRGProcessInfo *processes = xrg_process_collector_get_processes(state->process_collector);
+    gint num_processes = xrg_process_collector_get_process_count(state->process_collector);
 
     /* Calculate how many processes fit */
     gint available_height = height - y_offset - margin;
     gint max_rows = available_height / row_height;
 
+    /* I/O bars are relative to the busiest process shown */
+    gdouble max_io = 0.0;
+    if (show_io && num_processes > 0) {
+        max_io = processes[0].read_rate + processes[0].write_rate;
+    }
+
     gint row = 0;
-    for (GList *l = processes; l != NULL && row < max_rows; l = l->next, row++) {
-        XRGProcessInfo *proc = l->data;
+    for (; row < num_processes && row < max_rows; row++) {
+        const XRGProcessInfo *proc = &processes[row];
         gint row_y = y_offset + row * row_height;
 
+        /* Recent CPU and memory behind the name */
+        draw_process_history(cr, state->process_collector, proc, col_name, row_y + 1,
+                             col_cpu - 35 - col_name, row_height - 2, fg1_color, fg2_color);
+
         /* Process name (truncate if needed) */
-        gchar name_buf[24];
-        if (proc->name) {
+        gchar name_buf[32];
+        if (proc->exited_count > 0) {
+            /* Processes that exited since the last update, grouped by name */
+            g_snprintf(name_buf, sizeof(name_buf), "%.14s ×%d", proc->name, proc->exited_count);
+        } else if (proc->name) {
             g_snprintf(name_buf, sizeof(name_buf), "%.18s", proc->name);
         } else {
             g_snprintf(name_buf, sizeof(name_buf), "%d", proc->pid);
         }
 
-        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.9);
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue,
+                              proc->exited_count > 0 ? 0.5 : 0.9);
         cairo_move_to(cr, col_name, row_y + row_height - 3);
         cairo_show_text(cr, name_buf);
 
@@ -4321,7 +6010,15 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
         cairo_move_to(cr, col_cpu, row_y + row_height - 3);
         cairo_show_text(cr, cpu_str);
 
-        /* Memory bar and percentage */
+        if (show_io) {
+            gdouble io_rate = proc->read_rate + proc->write_rate;
+            gchar io_str[16];
+            g_snprintf(io_str, sizeof(io_str), "%4.1f", io_rate / (1024.0 * 1024.0));
+            draw_usage_column(cr, fg3_color, text_color, col_mem, row_y, row_height,
+                              max_io > 0 ? io_rate / max_io : 0.0, io_str);
+            continue;
+        }
+
         bar_x = col_mem - bar_width - 2;
         gdouble mem_ratio = CLAMP(proc->mem_percent / 100.0, 0.0, 1.0);
 
@@ -4350,9 +6047,16 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
         gint total = xrg_process_collector_get_total_processes(state->process_collector);
         gint running = xrg_process_collector_get_running_processes(state->process_collector);
 
-        gchar summary[64];
+        gchar summary[96];
         g_snprintf(summary, sizeof(summary), "Processes: %d (%d running)", total, running);
 
+        if (xrg_process_collector_get_event_tracking(state->process_collector)) {
+            gint forks, execs, exits;
+            xrg_process_collector_get_event_counts(state->process_collector, &forks, &execs, &exits);
+            gsize len = strlen(summary);
+            g_snprintf(summary + len, sizeof(summary) - len, " +%d/-%d", forks, exits);
+        }
+
         cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.5);
         cairo_set_font_size(cr, 9);
         cairo_move_to(cr, margin, summary_y);
@@ -4362,6 +6066,66 @@ static gboolean on_draw_process(GtkWidget *widget, cairo_t *cr, gpointer user_da
     return FALSE;
 }
 
+/**
+ * Process row under a pointer position in the process list, or NULL
+ */
+static const XRGProcessInfo* process_row_at(AppState *state, gdouble y) {
+    /* Same layout as on_draw_process: margin 4, header 14 + 2, separator gap 4, rows 14 high */
+    gint list_top = 4 + 14 + 2 + 4;
+
+    if (process_view_is_cgroups(state) ||
+        xrg_process_collector_get_thread_pid(state->process_collector) > 0 || y < list_top) {
+        return NULL;
+    }
+
+    const XRGProcessInfo *proc = xrg_process_collector_get_process_at(state->process_collector,
+                                                                      (gint)(y - list_top) / 14);
+    return proc && proc->exited_count == 0 ? proc : NULL;
+}
+
+/**
+ * Thread drill-down timer: only the selected process is read
+ */
+static gboolean on_thread_timer(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+
+    xrg_process_collector_update_threads(state->process_collector);
+    gtk_widget_queue_draw(state->process_drawing_area);
+
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Switch the process module to the threads of one process
+ */
+static void start_thread_view(AppState *state, pid_t pid, const gchar *name) {
+    if (!xrg_process_collector_set_thread_pid(state->process_collector, pid)) {
+        return;
+    }
+
+    g_strlcpy(state->thread_process_name, name, sizeof(state->thread_process_name));
+    xrg_process_collector_update_threads(state->process_collector);
+    if (state->thread_timer_id == 0) {
+        state->thread_timer_id = g_timeout_add(250, on_thread_timer, state);
+    }
+    gtk_widget_queue_draw(state->process_drawing_area);
+}
+
+/**
+ * Return the process module to the process list
+ */
+static void stop_thread_view(AppState *state) {
+    if (state->thread_timer_id > 0) {
+        g_source_remove(state->thread_timer_id);
+        state->thread_timer_id = 0;
+    }
+    xrg_process_collector_set_thread_pid(state->process_collector, 0);
+
+    /* The process list was not collected while threads were shown */
+    xrg_process_collector_update(state->process_collector);
+    gtk_widget_queue_draw(state->process_drawing_area);
+}
+
 /**
  * Process module button press callback
  */
@@ -4373,7 +6137,21 @@ static gboolean on_process_button_press(GtkWidget *widget, GdkEventButton *event
         show_process_context_menu(state, event);
         return TRUE;
     } else if (event->button == 1) {  /* Left-click */
+        if (xrg_process_collector_get_thread_pid(state->process_collector) > 0 &&
+            !process_view_is_cgroups(state)) {
+            stop_thread_view(state);
+            return TRUE;
+        }
+
         /* Toggle sort between CPU and Memory */
+        if (process_view_is_cgroups(state)) {
+            XRGCgroupSortBy current = xrg_cgroup_collector_get_sort_by(state->cgroup_collector);
+            xrg_cgroup_collector_set_sort_by(state->cgroup_collector,
+                current == XRG_CGROUP_SORT_CPU ? XRG_CGROUP_SORT_MEMORY : XRG_CGROUP_SORT_CPU);
+            gtk_widget_queue_draw(state->process_drawing_area);
+            return TRUE;
+        }
+
         XRGProcessSortBy current = xrg_process_collector_get_sort_by(state->process_collector);
         if (current == XRG_PROCESS_SORT_CPU) {
             xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_MEMORY);
@@ -4391,8 +6169,11 @@ static gboolean on_process_button_press(GtkWidget *widget, GdkEventButton *event
  * Process module motion notify callback (for tooltips)
  */
 static gboolean on_process_motion_notify(GtkWidget *widget, GdkEventMotion *event, gpointer user_data) {
-    (void)user_data;
-    (void)event;
+    AppState *state = (AppState *)user_data;
+
+    /* The hovered process gets its memory probed first */
+    const XRGProcessInfo *hovered = process_row_at(state, event->y);
+    xrg_process_collector_set_probe_pid(state->process_collector, hovered ? hovered->pid : 0);
 
     /* Request tooltip update */
     gtk_widget_trigger_tooltip_query(widget);
@@ -4400,26 +6181,78 @@ static gboolean on_process_motion_notify(GtkWidget *widget, GdkEventMotion *even
     return FALSE;
 }
 
+/**
+ * Process module leave notify callback
+ */
+static gboolean on_process_leave_notify(GtkWidget *widget, GdkEventCrossing *event, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    (void)widget;
+    (void)event;
+
+    xrg_process_collector_set_probe_pid(state->process_collector, 0);
+
+    return FALSE;
+}
+
 /**
  * Process module context menu
  */
 static void show_process_context_menu(AppState *state, GdkEventButton *event) {
     GtkWidget *menu = gtk_menu_new();
+    gboolean cgroups = process_view_is_cgroups(state);
+    XRGProcessSortBy process_sort = xrg_process_collector_get_sort_by(state->process_collector);
+    XRGCgroupSortBy cgroup_sort = xrg_cgroup_collector_get_sort_by(state->cgroup_collector);
+
+    /* Thread drill-down, for the row under the pointer */
+    const XRGProcessInfo *proc = process_row_at(state, event->y);
+    if (!cgroups && xrg_process_collector_get_thread_pid(state->process_collector) > 0) {
+        GtkWidget *back_item = gtk_menu_item_new_with_label("Back to Processes");
+        g_signal_connect(back_item, "activate", G_CALLBACK(on_process_hide_threads), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), back_item);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+    } else if (proc) {
+        gchar label[96];
+        g_snprintf(label, sizeof(label), "Show Threads of %.32s", proc->name ? proc->name : "process");
+        state->menu_process_pid = proc->pid;
+        g_strlcpy(state->menu_process_name, proc->name ? proc->name : "", sizeof(state->menu_process_name));
+
+        GtkWidget *threads_item = gtk_menu_item_new_with_label(label);
+        g_signal_connect(threads_item, "activate", G_CALLBACK(on_process_show_threads), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), threads_item);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+    }
 
     /* Sort by CPU */
     GtkWidget *sort_cpu_item = gtk_check_menu_item_new_with_label("Sort by CPU");
     gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(sort_cpu_item),
-        xrg_process_collector_get_sort_by(state->process_collector) == XRG_PROCESS_SORT_CPU);
+        cgroups ? cgroup_sort == XRG_CGROUP_SORT_CPU : process_sort == XRG_PROCESS_SORT_CPU);
     g_signal_connect(sort_cpu_item, "activate", G_CALLBACK(on_process_sort_cpu), state);
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), sort_cpu_item);
 
     /* Sort by Memory */
     GtkWidget *sort_mem_item = gtk_check_menu_item_new_with_label("Sort by Memory");
     gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(sort_mem_item),
-        xrg_process_collector_get_sort_by(state->process_collector) == XRG_PROCESS_SORT_MEMORY);
+        cgroups ? cgroup_sort == XRG_CGROUP_SORT_MEMORY : process_sort == XRG_PROCESS_SORT_MEMORY);
     g_signal_connect(sort_mem_item, "activate", G_CALLBACK(on_process_sort_memory), state);
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), sort_mem_item);
 
+    /* Sort by I/O */
+    GtkWidget *sort_io_item = gtk_check_menu_item_new_with_label("Sort by I/O");
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(sort_io_item),
+        cgroups ? cgroup_sort == XRG_CGROUP_SORT_IO : process_sort == XRG_PROCESS_SORT_IO);
+    g_signal_connect(sort_io_item, "activate", G_CALLBACK(on_process_sort_io), state);
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), sort_io_item);
+
+    /* Cgroup view (only on cgroup v2 hosts) */
+    if (xrg_cgroup_collector_is_available(state->cgroup_collector)) {
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), gtk_separator_menu_item_new());
+
+        GtkWidget *cgroups_item = gtk_check_menu_item_new_with_label("Group by Cgroup");
+        gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(cgroups_item), state->prefs->process_show_cgroups);
+        g_signal_connect(cgroups_item, "toggled", G_CALLBACK(on_process_show_cgroups), state);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), cgroups_item);
+    }
+
     gtk_widget_show_all(menu);
     gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
 }
@@ -4430,7 +6263,11 @@ static void show_process_context_menu(AppState *state, GdkEventButton *event) {
 static void on_process_sort_cpu(GtkMenuItem *item, gpointer user_data) {
     (void)item;
     AppState *state = (AppState *)user_data;
-    xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_CPU);
+    if (process_view_is_cgroups(state)) {
+        xrg_cgroup_collector_set_sort_by(state->cgroup_collector, XRG_CGROUP_SORT_CPU);
+    } else {
+        xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_CPU);
+    }
     gtk_widget_queue_draw(state->process_drawing_area);
 }
 
@@ -4440,7 +6277,60 @@ static void on_process_sort_cpu(GtkMenuItem *item, gpointer user_data) {
 static void on_process_sort_memory(GtkMenuItem *item, gpointer user_data) {
     (void)item;
     AppState *state = (AppState *)user_data;
-    xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_MEMORY);
+    if (process_view_is_cgroups(state)) {
+        xrg_cgroup_collector_set_sort_by(state->cgroup_collector, XRG_CGROUP_SORT_MEMORY);
+    } else {
+        xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_MEMORY);
+    }
+    gtk_widget_queue_draw(state->process_drawing_area);
+}
+
+/**
+ * Sort by I/O menu callback
+ */
+static void on_process_sort_io(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    if (process_view_is_cgroups(state)) {
+        xrg_cgroup_collector_set_sort_by(state->cgroup_collector, XRG_CGROUP_SORT_IO);
+    } else {
+        xrg_process_collector_set_sort_by(state->process_collector, XRG_PROCESS_SORT_IO);
+    }
+    gtk_widget_queue_draw(state->process_drawing_area);
+}
+
+/**
+ * Show Threads menu callback
+ */
+static void on_process_show_threads(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    start_thread_view(state, state->menu_process_pid, state->menu_process_name);
+}
+
+/**
+ * Back to Processes menu callback
+ */
+static void on_process_hide_threads(GtkMenuItem *item, gpointer user_data) {
+    (void)item;
+    AppState *state = (AppState *)user_data;
+    stop_thread_view(state);
+}
+
+/**
+ * Group by Cgroup menu callback
+ */
+static void on_process_show_cgroups(GtkCheckMenuItem *item, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->prefs->process_show_cgroups = gtk_check_menu_item_get_active(item);
+    xrg_preferences_save(state->prefs);
+
+    /* Collect the new view now rather than showing stale data until the next tick */
+    if (process_view_is_cgroups(state)) {
+        xrg_cgroup_collector_update(state->cgroup_collector);
+    } else {
+        xrg_process_collector_update(state->process_collector);
+    }
     gtk_widget_queue_draw(state->process_drawing_area);
 }
 
@@ -4849,14 +6739,25 @@ static gboolean on_update_timer(gpointer user_data) {
 
     /* Update collectors */
     xrg_cpu_collector_update(state->cpu_collector);
+    xrg_cpufreq_collector_update(state->cpufreq_collector);
+    if (state->perf_collector)
+        xrg_perf_collector_update(state->perf_collector);
+    track_memory_overlay(state);
     xrg_memory_collector_update(state->memory_collector);
     xrg_network_collector_update(state->network_collector);
     xrg_disk_collector_update(state->disk_collector);
+    xrg_mounts_collector_update(state->mounts_collector);
+    xrg_psi_collector_update(state->psi_collector);
     xrg_gpu_collector_update(state->gpu_collector);
     xrg_battery_collector_update(state->battery_collector);
     xrg_sensors_collector_update(state->sensors_collector);
     xrg_aitoken_collector_update(state->aitoken_collector);
-    xrg_process_collector_update(state->process_collector);
+    /* Only the view on screen is collected (threads have their own timer) */
+    if (process_view_is_cgroups(state)) {
+        xrg_cgroup_collector_update(state->cgroup_collector);
+    } else if (xrg_process_collector_get_thread_pid(state->process_collector) == 0) {
+        xrg_process_collector_update(state->process_collector);
+    }
     xrg_tpu_collector_update(state->tpu_collector);
 
     /* Redraw graphs */
@@ -4880,10 +6781,13 @@ static gboolean on_update_timer(gpointer user_data) {
 static void on_window_destroy(GtkWidget *widget, gpointer user_data) {
     AppState *state = (AppState *)user_data;
 
-    /* Stop timer */
+    /* Stop timers */
     if (state->update_timer_id > 0) {
         g_source_remove(state->update_timer_id);
     }
+    if (state->thread_timer_id > 0) {
+        g_source_remove(state->thread_timer_id);
+    }
 
     /* Save window position */
     gint x, y, width, height;
@@ -4910,12 +6814,24 @@ static void on_window_destroy(GtkWidget *widget, gpointer user_data) {
     xrg_preferences_save(state->prefs);
 
     /* Cleanup */
+    if (state->cpu_heatmap_surface)
+        cairo_surface_destroy(state->cpu_heatmap_surface);
     xrg_cpu_collector_free(state->cpu_collector);
+    xrg_cpufreq_collector_free(state->cpufreq_collector);
+    xrg_perf_collector_free(state->perf_collector);
+    g_free(state->perf_error);
     xrg_memory_collector_free(state->memory_collector);
     xrg_network_collector_free(state->network_collector);
     xrg_disk_collector_free(state->disk_collector);
+    xrg_mounts_collector_free(state->mounts_collector);
     xrg_gpu_collector_free(state->gpu_collector);
     xrg_aitoken_collector_free(state->aitoken_collector);
+    xrg_cgroup_collector_free(state->cgroup_collector);
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        if (state->psi_watch_ids[r] > 0)
+            g_source_remove(state->psi_watch_ids[r]);
+    }
+    xrg_psi_collector_free(state->psi_collector);
     xrg_preferences_window_free(state->prefs_window);
     xrg_preferences_free(state->prefs);
     g_free(state);
@@ -4953,6 +6869,16 @@ static void on_preferences_applied(gpointer user_data) {
     gtk_widget_set_size_request(state->sensors_drawing_area, state->prefs->graph_width, state->prefs->graph_height_temperature);
     gtk_widget_set_size_request(state->aitoken_drawing_area, state->prefs->graph_width, state->prefs->graph_height_aitoken);
 
+    xrg_process_collector_set_max_threads(state->process_collector, state->prefs->process_scan_threads);
+    xrg_process_collector_set_event_tracking(state->process_collector, state->prefs->process_event_tracking);
+    xrg_process_collector_set_probe_budget(state->process_collector, state->prefs->process_probe_budget_us);
+
+    /* Drop the CPU heatmap so it is rebuilt with the current palette */
+    if (state->cpu_heatmap_surface) {
+        cairo_surface_destroy(state->cpu_heatmap_surface);
+        state->cpu_heatmap_surface = NULL;
+    }
+
     /* Trigger redraw of all modules to apply new colors, styles, and settings */
     gtk_widget_queue_draw(state->cpu_drawing_area);
     gtk_widget_queue_draw(state->memory_drawing_area);
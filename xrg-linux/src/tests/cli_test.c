@@ -18,14 +18,19 @@
 #include <glib.h>
 
 #include "collectors/cpu_collector.h"
+#include "collectors/cpufreq_collector.h"
 #include "collectors/memory_collector.h"
 #include "collectors/network_collector.h"
 #include "collectors/disk_collector.h"
+#include "collectors/mounts_collector.h"
 #include "collectors/gpu_collector.h"
 #include "collectors/sensors_collector.h"
 #include "collectors/battery_collector.h"
 #include "collectors/aitoken_collector.h"
 #include "collectors/process_collector.h"
+#include "collectors/cgroup_collector.h"
+#include "collectors/psi_collector.h"
+#include "collectors/perf_collector.h"
 #include "collectors/tpu_collector.h"
 
 #define HISTORY_SIZE 100
@@ -67,6 +72,8 @@ static void test_cpu(gboolean verbose) {
     gdouble load15 = xrg_cpu_collector_get_load_average_15min(cpu);
 
     printf("  Cores: %d\n", num_cores);
+    printf("  Topology: %d physical cores, %d packages\n",
+           xrg_cpu_collector_get_num_cores(cpu), xrg_cpu_collector_get_num_packages(cpu));
     printf("  Total Usage: %.1f%%\n", total);
     printf("  Load Average: %.2f %.2f %.2f\n", load1, load5, load15);
 
@@ -82,10 +89,45 @@ static void test_cpu(gboolean verbose) {
     printf("  OK: CPU collector freed\n");
 }
 
+/* Test CPU frequency collector */
+static void test_cpufreq(gboolean verbose) {
+    CHECKPOINT("CPU Frequency Collector");
+
+    printf("[1/3] Creating CPU frequency collector...\n");
+    XRGCPUFreqCollector *freq = xrg_cpufreq_collector_new(HISTORY_SIZE);
+    if (!freq) {
+        printf("  ERROR: Failed to create CPU frequency collector\n");
+        return;
+    }
+    printf("  OK: CPU frequency collector created\n");
+
+    printf("[2/3] Updating CPU frequency collector...\n");
+    xrg_cpufreq_collector_update(freq);
+    printf("  OK: Update complete\n");
+
+    printf("[3/3] Reading CPU frequency data...\n");
+    if (!xrg_cpufreq_collector_is_available(freq)) {
+        printf("  cpufreq: (not available)\n");
+    } else {
+        printf("  Policies: %d\n", xrg_cpufreq_collector_get_num_policies(freq));
+        printf("  Average: %.0f MHz (max %.0f MHz)\n",
+               xrg_cpufreq_collector_get_average_mhz(freq),
+               xrg_cpufreq_collector_get_max_mhz(freq));
+
+        if (verbose) {
+            for (gint i = 0; i < freq->num_cpus && i < 8; i++) {
+                printf("    CPU %d: %.0f MHz\n", i, xrg_cpufreq_collector_get_cpu_mhz(freq, i));
+            }
+        }
+    }
+
+    xrg_cpufreq_collector_free(freq);
+    printf("  OK: CPU frequency collector freed\n");
+}
+
 /* Test Memory collector */
 static void test_memory(gboolean verbose) {
     CHECKPOINT("Memory Collector");
-    (void)verbose;
 
     printf("[1/3] Creating Memory collector...\n");
     XRGMemoryCollector *mem = xrg_memory_collector_new(HISTORY_SIZE);
@@ -110,6 +152,29 @@ static void test_memory(gboolean verbose) {
     printf("  Used: %.1f GB (%.1f%%)\n", used / (1024.0 * 1024 * 1024), percent);
     printf("  Free: %.1f GB\n", free_mem / (1024.0 * 1024 * 1024));
     printf("  Swap Used: %.1f GB\n", swap / (1024.0 * 1024 * 1024));
+    printf("  Counters: %d (meminfo + vmstat)\n", xrg_memory_collector_get_num_counters(mem));
+
+    gint num_nodes = xrg_memory_collector_get_num_numa_nodes(mem);
+    printf("  NUMA nodes: %d\n", num_nodes);
+    for (gint n = 0; n < num_nodes; n++) {
+        const XRGNumaNode *node = xrg_memory_collector_get_numa_node(mem, n);
+        printf("    node%d: %.1f/%.1f GB used, hit %.0f/s, miss %.0f/s, foreign %.0f/s\n", node->id,
+               node->mem_used / (1024.0 * 1024 * 1024), node->mem_total / (1024.0 * 1024 * 1024),
+               node->hit_rate, node->miss_rate, node->foreign_rate);
+    }
+
+    if (verbose) {
+        static const gchar *counters[] = { "pgmajfault", "pswpin", "pswpout", "compact_stall",
+                                           "thp_fault_alloc", "Dirty", "AnonHugePages" };
+        for (gsize i = 0; i < G_N_ELEMENTS(counters); i++) {
+            gint index = xrg_memory_collector_find_counter(mem, counters[i]);
+            if (index < 0)
+                continue;
+            printf("    %s: %lu%s\n", counters[i],
+                   (unsigned long)xrg_memory_collector_get_counter_value(mem, index),
+                   xrg_memory_collector_counter_is_bytes(mem, index) ? " bytes" : "");
+        }
+    }
 
     xrg_memory_collector_free(mem);
     printf("  OK: Memory collector freed\n");
@@ -144,6 +209,17 @@ static void test_network(gboolean verbose) {
     printf("  Upload Rate: %.2f KB/s\n", ul_rate / 1024.0);
     printf("  RX Total: %.2f MB\n", rx_total / (1024.0 * 1024));
     printf("  TX Total: %.2f MB\n", tx_total / (1024.0 * 1024));
+    printf("  Source: %s\n", xrg_network_collector_is_using_netlink(net) ? "rtnetlink RTM_GETSTATS" : "/proc/net/dev");
+    printf("  Interfaces: %d\n", xrg_network_collector_get_num_interfaces(net));
+    for (gint i = 0; i < xrg_network_collector_get_num_groups(net); i++) {
+        const XRGNetworkGroup *group = xrg_network_collector_get_group(net, i);
+        printf("    %s*: %d interface(s)\n", group->name, group->num_interfaces);
+    }
+    for (gint stat = 0; stat < XRG_NETWORK_NUM_STATS; stat++) {
+        if (xrg_network_collector_has_stat(net, stat))
+            printf("  %s: %.1f/s\n", xrg_network_stat_get_name(stat),
+                   xrg_network_collector_get_stat_rate(net, stat));
+    }
 
     xrg_network_collector_free(net);
     printf("  OK: Network collector freed\n");
@@ -182,11 +258,51 @@ static void test_disk(gboolean verbose) {
     printf("  Write Rate: %.2f MB/s\n", write_rate);
     printf("  Read Total: %.2f GB\n", read_total / (1024.0 * 1024 * 1024));
     printf("  Write Total: %.2f GB\n", write_total / (1024.0 * 1024 * 1024));
+    printf("  All Disks: %.2f MB/s read, %.2f MB/s write\n",
+           xrg_disk_collector_get_all_read_rate(disk), xrg_disk_collector_get_all_write_rate(disk));
+
+    static const gchar *type_names[] = { "disk", "partition", "dm", "md", "other" };
+    printf("  Devices: %d\n", xrg_disk_collector_get_num_devices(disk));
+    for (gint i = 0; i < xrg_disk_collector_get_num_devices(disk); i++) {
+        const XRGDiskDevice *dev = xrg_disk_collector_get_device(disk, i);
+        printf("    %u:%u %s (%s%s%s): %.0f IOPS, await %.2f ms, %.0f%% util, queue %.2f\n",
+               dev->major, dev->minor, dev->label, type_names[dev->type],
+               dev->parent[0] ? " of " : "", dev->parent,
+               dev->read_iops + dev->write_iops, dev->await, dev->util, dev->queue_depth);
+    }
 
     xrg_disk_collector_free(disk);
     printf("  OK: Disk collector freed\n");
 }
 
+/* Test Mounts collector */
+static void test_mounts(gboolean verbose) {
+    CHECKPOINT("Mounts Collector");
+    (void)verbose;
+
+    printf("[1/2] Creating Mounts collector...\n");
+    XRGMountsCollector *mounts = xrg_mounts_collector_new(HISTORY_SIZE);
+    if (!mounts) {
+        printf("  ERROR: Failed to create Mounts collector\n");
+        return;
+    }
+    printf("  OK: Mounts collector created\n");
+
+    printf("[2/2] Reading Mounts data...\n");
+    printf("  Filesystems: %d\n", xrg_mounts_collector_get_num_mounts(mounts));
+    for (gint i = 0; i < xrg_mounts_collector_get_num_mounts(mounts); i++) {
+        const XRGMountInfo *mount = xrg_mounts_collector_get_mount(mounts, i);
+        printf("    %s (%s on %s): %.1f%% used, %.2f GB free, %.1f%% inodes\n",
+               mount->mount_point, mount->fs_type, mount->source, mount->used_percent,
+               mount->avail_bytes / (1024.0 * 1024 * 1024), mount->inode_percent);
+    }
+    const XRGMountInfo *fullest = xrg_mounts_collector_get_fullest(mounts);
+    printf("  Fullest: %s\n", fullest ? fullest->mount_point : "(none)");
+
+    xrg_mounts_collector_free(mounts);
+    printf("  OK: Mounts collector freed\n");
+}
+
 /* Test GPU collector */
 static void test_gpu(gboolean verbose) {
     CHECKPOINT("GPU Collector");
@@ -393,7 +509,7 @@ static void test_process(gboolean verbose) {
     if (verbose) {
         printf("  Top 5 by CPU:\n");
         for (gint i = 0; i < 5 && i < count; i++) {
-            XRGProcessInfo *info = xrg_process_collector_get_process(proc, i);
+            const XRGProcessInfo *info = xrg_process_collector_get_process_at(proc, i);
             if (info) {
                 printf("    [%d] %s (PID %d): %.1f%% CPU, %.1f%% MEM\n",
                        i + 1, info->name, info->pid, info->cpu_percent, info->mem_percent);
@@ -405,6 +521,125 @@ static void test_process(gboolean verbose) {
     printf("  OK: Process collector freed\n");
 }
 
+/* Test cgroup collector */
+static void test_cgroup(gboolean verbose) {
+    CHECKPOINT("Cgroup Collector");
+
+    printf("[1/3] Creating cgroup collector...\n");
+    XRGCgroupCollector *cgroups = xrg_cgroup_collector_new(HISTORY_SIZE);
+    if (!cgroups) {
+        printf("  ERROR: Failed to create cgroup collector\n");
+        return;
+    }
+    printf("  OK: Cgroup collector created\n");
+
+    printf("[2/3] Updating cgroup collector...\n");
+    xrg_cgroup_collector_update(cgroups);
+    printf("  OK: Update complete\n");
+
+    printf("[3/3] Reading cgroup data...\n");
+    if (!xrg_cgroup_collector_is_available(cgroups)) {
+        printf("  cgroup v2: (not available)\n");
+    } else {
+        printf("  Cgroups: %d (%d leaves)\n",
+               xrg_cgroup_collector_get_num_cgroups(cgroups),
+               xrg_cgroup_collector_get_top_count(cgroups));
+
+        if (verbose) {
+            printf("  Top 5 by CPU:\n");
+            for (gint i = 0; i < 5 && i < xrg_cgroup_collector_get_top_count(cgroups); i++) {
+                const XRGCgroupInfo *cg = xrg_cgroup_collector_get_top(cgroups, i);
+                printf("    [%d] %s: %.1f%% CPU, %.1f MB, %.1f KB/s I/O, PSI cpu %.2f mem %.2f io %.2f\n",
+                       i + 1, cg->path, cg->cpu_percent, cg->memory_bytes / (1024.0 * 1024.0),
+                       (cg->read_rate + cg->write_rate) / 1024.0,
+                       cg->cpu_pressure, cg->memory_pressure, cg->io_pressure);
+            }
+        }
+    }
+
+    xrg_cgroup_collector_free(cgroups);
+    printf("  OK: Cgroup collector freed\n");
+}
+
+/* Test PSI collector */
+static void test_psi(gboolean verbose) {
+    CHECKPOINT("PSI Collector");
+    (void)verbose;
+
+    printf("[1/3] Creating PSI collector...\n");
+    XRGPsiCollector *psi = xrg_psi_collector_new(HISTORY_SIZE);
+    if (!psi) {
+        printf("  ERROR: Failed to create PSI collector\n");
+        return;
+    }
+    printf("  OK: PSI collector created\n");
+
+    printf("[2/3] Updating PSI collector...\n");
+    /* Stall shares need a second sample over a real interval */
+    g_usleep(G_USEC_PER_SEC);
+    xrg_psi_collector_update(psi);
+    printf("  OK: Update complete\n");
+
+    printf("[3/3] Reading PSI data...\n");
+    if (!xrg_psi_collector_is_available(psi)) {
+        printf("  PSI not available (kernel without CONFIG_PSI, or psi=0)\n");
+    }
+    for (gint r = 0; r < XRG_PSI_NUM_RESOURCES; r++) {
+        const XRGPsiInfo *info = xrg_psi_collector_get_info(psi, r);
+        if (!info->available)
+            continue;
+        printf("  %s: some %.2f%%, full %.2f%% (avg10), stalled %.1f%%, trigger %s",
+               xrg_psi_resource_get_name(r), info->some_avg10, info->full_avg10, info->some_stall,
+               info->has_trigger ? "registered" : "unavailable");
+        if (info->has_trigger)
+            printf(" (%d ms window)", info->trigger_window_us / 1000);
+        printf("\n");
+    }
+
+    xrg_psi_collector_free(psi);
+    printf("  OK: PSI collector freed\n");
+}
+
+/* Test perf collector */
+static void test_perf(gboolean verbose) {
+    CHECKPOINT("Perf Collector");
+    (void)verbose;
+
+    printf("[1/3] Creating Perf collector...\n");
+    XRGPerfCollector *perf = xrg_perf_collector_new(HISTORY_SIZE);
+    if (!perf) {
+        printf("  ERROR: Failed to create Perf collector\n");
+        return;
+    }
+    printf("  OK: Perf collector created\n");
+
+    printf("[2/3] Updating Perf collector...\n");
+    g_usleep(G_USEC_PER_SEC / 2);
+    xrg_perf_collector_update(perf);
+    printf("  OK: Update complete\n");
+
+    printf("[3/3] Reading Perf data...\n");
+    const gchar *error = xrg_perf_collector_get_error(perf);
+    if (!xrg_perf_collector_is_available(perf)) {
+        printf("  Perf events not available (%s)\n", error ? error : "no CPUs");
+    } else {
+        printf("  CPUs: %d, %s\n", xrg_perf_collector_get_num_cpus(perf),
+               xrg_perf_collector_has_hardware(perf) ? "hardware + software events" : "software events only");
+        if (error)
+            printf("  Not opened: %s\n", error);
+        if (xrg_perf_collector_has_hardware(perf)) {
+            printf("  IPC: %.2f, cache misses: %.1f per 1k instructions\n",
+                   xrg_perf_collector_get_ipc(perf), xrg_perf_collector_get_cache_mpki(perf));
+        }
+        printf("  Context switches: %.0f/s, migrations: %.0f/s\n",
+               xrg_perf_collector_get_rate(perf, XRG_PERF_CONTEXT_SWITCHES),
+               xrg_perf_collector_get_rate(perf, XRG_PERF_CPU_MIGRATIONS));
+    }
+
+    xrg_perf_collector_free(perf);
+    printf("  OK: Perf collector freed\n");
+}
+
 /* Test TPU collector */
 static void test_tpu(gboolean verbose) {
     CHECKPOINT("TPU Collector");
@@ -469,8 +704,8 @@ static void print_usage(const char *prog) {
     printf("  -n, --iterations N Number of iterations (default: 1, 0 = infinite)\n");
     printf("  -v, --verbose      Verbose output with all metrics\n");
     printf("  -m, --module NAME  Test specific module:\n");
-    printf("                     cpu, memory, network, disk, gpu,\n");
-    printf("                     sensors, battery, aitoken, process, tpu\n");
+    printf("                     cpu, cpufreq, memory, network, disk, mounts,\n");
+    printf("                     gpu, sensors, battery, aitoken, process, cgroup, psi, perf, tpu\n");
     printf("  -h, --help         Show this help\n");
     printf("\nExamples:\n");
     printf("  %s                 Run all tests once\n", prog);
@@ -526,26 +761,36 @@ int main(int argc, char *argv[]) {
         if (module == NULL) {
             /* Test all collectors */
             test_cpu(verbose);
+            test_cpufreq(verbose);
             test_memory(verbose);
             test_network(verbose);
             test_disk(verbose);
+            test_mounts(verbose);
             test_gpu(verbose);
             test_sensors(verbose);
             test_battery(verbose);
             test_aitoken(verbose);
             test_process(verbose);
+            test_cgroup(verbose);
+            test_psi(verbose);
+            test_perf(verbose);
             test_tpu(verbose);
         } else {
             /* Test specific module */
             if (strcmp(module, "cpu") == 0) test_cpu(verbose);
+            else if (strcmp(module, "cpufreq") == 0) test_cpufreq(verbose);
             else if (strcmp(module, "memory") == 0) test_memory(verbose);
             else if (strcmp(module, "network") == 0) test_network(verbose);
             else if (strcmp(module, "disk") == 0) test_disk(verbose);
+            else if (strcmp(module, "mounts") == 0) test_mounts(verbose);
             else if (strcmp(module, "gpu") == 0) test_gpu(verbose);
             else if (strcmp(module, "sensors") == 0) test_sensors(verbose);
             else if (strcmp(module, "battery") == 0) test_battery(verbose);
             else if (strcmp(module, "aitoken") == 0) test_aitoken(verbose);
             else if (strcmp(module, "process") == 0) test_process(verbose);
+            else if (strcmp(module, "cgroup") == 0) test_cgroup(verbose);
+            else if (strcmp(module, "psi") == 0) test_psi(verbose);
+            else if (strcmp(module, "perf") == 0) test_perf(verbose);
             else if (strcmp(module, "tpu") == 0) test_tpu(verbose);
             else {
                 fprintf(stderr, "Unknown module: %s\n", module);
@@ -27,6 +27,9 @@ struct _XRGPreferencesWindow {
     GtkWidget *cpu_height_spin;
     GtkWidget *cpu_update_interval_spin;
     GtkWidget *cpu_style_combo;
+    GtkWidget *cpu_view_mode_combo;
+    GtkWidget *cpu_granularity_combo;
+    GtkWidget *cpu_show_frequency_check;
 
     /* Memory module tab widgets */
     GtkWidget *memory_enabled_check;
@@ -80,6 +83,9 @@ struct _XRGPreferencesWindow {
     /* Process module tab widgets */
     GtkWidget *process_enabled_check;
     GtkWidget *process_height_spin;
+    GtkWidget *process_scan_threads_spin;
+    GtkWidget *process_event_tracking_check;
+    GtkWidget *process_probe_budget_spin;
 
     /* TPU module tab widgets */
     GtkWidget *tpu_enabled_check;
@@ -402,6 +408,31 @@ static GtkWidget* create_cpu_tab(XRGPreferencesWindow *win) {
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_style_combo), "Hollow (Outline)");
     gtk_grid_attach(GTK_GRID(grid), win->cpu_style_combo, 1, row++, 1, 1);
 
+    /* View mode */
+    label = gtk_label_new("View Mode:");
+    gtk_widget_set_halign(label, GTK_ALIGN_END);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+    win->cpu_view_mode_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_view_mode_combo), "Total (User/System)");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_view_mode_combo), "Per-CPU Strips");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_view_mode_combo), "Per-CPU Heatmap");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_view_mode_combo), "Distribution Bands");
+    gtk_grid_attach(GTK_GRID(grid), win->cpu_view_mode_combo, 1, row++, 1, 1);
+
+    /* Per-CPU granularity */
+    label = gtk_label_new("Group Per-CPU By:");
+    gtk_widget_set_halign(label, GTK_ALIGN_END);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+    win->cpu_granularity_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_granularity_combo), "Thread (Logical CPU)");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_granularity_combo), "Physical Core");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(win->cpu_granularity_combo), "Package (Socket)");
+    gtk_grid_attach(GTK_GRID(grid), win->cpu_granularity_combo, 1, row++, 1, 1);
+
+    /* Frequency overlay */
+    win->cpu_show_frequency_check = gtk_check_button_new_with_label("Show Clock Frequency Overlay");
+    gtk_grid_attach(GTK_GRID(grid), win->cpu_show_frequency_check, 0, row++, 2, 1);
+
     /* Note: Colors are managed in the Colors tab */
 
     return grid;
@@ -907,6 +938,24 @@ static GtkWidget* create_process_tab(XRGPreferencesWindow *win) {
     win->process_height_spin = gtk_spin_button_new_with_range(80, 400, 10);
     gtk_grid_attach(GTK_GRID(grid), win->process_height_spin, 1, row++, 1, 1);
 
+    /* Scan threads */
+    label = gtk_label_new("Scan Threads (0 = Auto):");
+    gtk_widget_set_halign(label, GTK_ALIGN_END);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+    win->process_scan_threads_spin = gtk_spin_button_new_with_range(0, 64, 1);
+    gtk_grid_attach(GTK_GRID(grid), win->process_scan_threads_spin, 1, row++, 1, 1);
+
+    /* Event tracking */
+    win->process_event_tracking_check = gtk_check_button_new_with_label("Track Process Events (needs CAP_NET_ADMIN)");
+    gtk_grid_attach(GTK_GRID(grid), win->process_event_tracking_check, 0, row++, 2, 1);
+
+    /* Memory probe budget */
+    label = gtk_label_new("PSS Probe Budget (µs, 0 = Off):");
+    gtk_widget_set_halign(label, GTK_ALIGN_END);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+    win->process_probe_budget_spin = gtk_spin_button_new_with_range(0, 50000, 500);
+    gtk_grid_attach(GTK_GRID(grid), win->process_probe_budget_spin, 1, row++, 1, 1);
+
     /* Info label */
     label = gtk_label_new(NULL);
     gtk_label_set_markup(GTK_LABEL(label), "<i>Shows top 10 processes by CPU usage.\nRight-click a process to terminate, force kill, pause, or resume it.</i>");
@@ -1120,6 +1169,9 @@ static void load_preferences_to_ui(XRGPreferencesWindow *win) {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(win->cpu_height_spin), prefs->graph_height_cpu);
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(win->cpu_update_interval_spin), prefs->normal_update_interval);
     gtk_combo_box_set_active(GTK_COMBO_BOX(win->cpu_style_combo), prefs->cpu_graph_style);
+    gtk_combo_box_set_active(GTK_COMBO_BOX(win->cpu_view_mode_combo), prefs->cpu_view_mode);
+    gtk_combo_box_set_active(GTK_COMBO_BOX(win->cpu_granularity_combo), prefs->cpu_granularity);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(win->cpu_show_frequency_check), prefs->cpu_show_frequency);
     /* Note: CPU colors removed - use Colors tab instead */
 
     /* Memory module tab */
@@ -1187,6 +1239,9 @@ static void load_preferences_to_ui(XRGPreferencesWindow *win) {
     /* Process module tab */
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(win->process_enabled_check), prefs->show_process);
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(win->process_height_spin), prefs->graph_height_process);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(win->process_scan_threads_spin), prefs->process_scan_threads);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(win->process_event_tracking_check), prefs->process_event_tracking);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(win->process_probe_budget_spin), prefs->process_probe_budget_us);
 
     /* TPU module tab */
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(win->tpu_enabled_check), prefs->show_tpu);
@@ -1249,6 +1304,9 @@ static void save_ui_to_preferences(XRGPreferencesWindow *win) {
     prefs->graph_height_cpu = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(win->cpu_height_spin));
     prefs->normal_update_interval = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(win->cpu_update_interval_spin));
     prefs->cpu_graph_style = gtk_combo_box_get_active(GTK_COMBO_BOX(win->cpu_style_combo));
+    prefs->cpu_view_mode = gtk_combo_box_get_active(GTK_COMBO_BOX(win->cpu_view_mode_combo));
+    prefs->cpu_granularity = gtk_combo_box_get_active(GTK_COMBO_BOX(win->cpu_granularity_combo));
+    prefs->cpu_show_frequency = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(win->cpu_show_frequency_check));
     /* Note: CPU colors removed - use Colors tab instead */
 
     /* Memory module tab */
@@ -1313,6 +1371,9 @@ static void save_ui_to_preferences(XRGPreferencesWindow *win) {
     /* Process module tab */
     prefs->show_process = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(win->process_enabled_check));
     prefs->graph_height_process = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(win->process_height_spin));
+    prefs->process_scan_threads = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(win->process_scan_threads_spin));
+    prefs->process_event_tracking = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(win->process_event_tracking_check));
+    prefs->process_probe_budget_us = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(win->process_probe_budget_spin));
 
     /* TPU module tab */
     prefs->show_tpu = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(win->tpu_enabled_check));
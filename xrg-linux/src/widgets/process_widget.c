@@ -179,15 +179,16 @@ static void process_widget_draw(XRGBaseWidget *base, cairo_t *cr, int width, int
     y_offset += 4;
 
     /* Draw process list */
-    GList *processes = xrg_process_collector_get_processes(widget->collector);
+    const XRGProcessInfo *processes = xrg_process_collector_get_processes(widget->collector);
+    int num_processes = xrg_process_collector_get_process_count(widget->collector);
 
     /* Calculate how many processes fit */
     int available_height = height - y_offset - margin;
     int max_rows = available_height / row_height;
 
     int row = 0;
-    for (GList *l = processes; l != NULL && row < max_rows; l = l->next, row++) {
-        XRGProcessInfo *proc = l->data;
+    for (; row < num_processes && row < max_rows; row++) {
+        const XRGProcessInfo *proc = &processes[row];
         int row_y = y_offset + row * row_height;
 
         /* Highlight hovered row */
@@ -199,13 +200,17 @@ static void process_widget_draw(XRGBaseWidget *base, cairo_t *cr, int width, int
 
         /* Process name (truncate if needed) */
         gchar name_buf[32];
-        if (proc->name) {
+        if (proc->exited_count > 0) {
+            /* Processes that exited since the last update, grouped by name */
+            g_snprintf(name_buf, sizeof(name_buf), "%.16s ×%d", proc->name, proc->exited_count);
+        } else if (proc->name) {
             g_snprintf(name_buf, sizeof(name_buf), "%.20s", proc->name);
         } else {
             g_snprintf(name_buf, sizeof(name_buf), "%d", proc->pid);
         }
 
-        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue, 0.9);
+        cairo_set_source_rgba(cr, text_color->red, text_color->green, text_color->blue,
+                              proc->exited_count > 0 ? 0.5 : 0.9);
         cairo_move_to(cr, col_name, row_y + row_height - 4);
         cairo_show_text(cr, name_buf);
 
@@ -313,13 +318,17 @@ static gchar* process_widget_tooltip(XRGBaseWidget *base, int x, int y) {
     int row = rel_y / widget->row_height;
 
     /* Find the process at this row */
-    GList *processes = xrg_process_collector_get_processes(widget->collector);
-    XRGProcessInfo *proc = g_list_nth_data(processes, row);
+    const XRGProcessInfo *proc = xrg_process_collector_get_process_at(widget->collector, row);
 
     if (!proc) {
         return NULL;
     }
 
+    if (proc->exited_count > 0) {
+        return g_strdup_printf("%s: %d exited since the last update (last PID %d)\nCPU: %.1f%%",
+                               proc->name, proc->exited_count, proc->pid, proc->cpu_percent);
+    }
+
     /* Format memory */
     gchar *mem_rss_str = xrg_format_bytes(proc->mem_rss);
     gchar *mem_vsize_str = xrg_format_bytes(proc->mem_vsize);
@@ -475,11 +484,10 @@ static void process_widget_menu(XRGBaseWidget *base, GdkEventButton *event) {
     }
 
     /* Find the process at this row */
-    GList *processes = xrg_process_collector_get_processes(widget->collector);
-    XRGProcessInfo *proc = g_list_nth_data(processes, row);
+    const XRGProcessInfo *proc = xrg_process_collector_get_process_at(widget->collector, row);
 
-    if (!proc) {
-        return;  /* No process at this row */
+    if (!proc || proc->exited_count > 0) {
+        return;  /* No process at this row, or it has already exited */
     }
 
     /* Create context menu */